@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrameProfiler.hh"
+
+struct AllocationBudget {
+  // Frames at the start that may allocate freely: loading, first plays that
+  // fill caches, containers growing to their working size
+  std::uint32_t warmupFrames{};
+  // Limit for every later frame; the default demands zero heap activity
+  std::int64_t maxAllocationsPerFrame{};
+  // Violations logged in full (with a stack); later ones are only counted
+  std::uint32_t maxReports{5};
+};
+
+// Heap allocations made during one frame, split by the FrameProfiler phase
+// that was running on the allocating frame thread. Two extra zones follow:
+// OTHER_ZONE for frame threads outside any timed phase (job workers), and
+// BACKGROUND_ZONE for every other thread (asset loaders, the log sink, the
+// audio and music threads), which the budget ignores.
+struct AllocationFrameStats {
+  static constexpr std::size_t OTHER_ZONE{
+      static_cast<std::size_t>(FramePhase::Count)};
+  static constexpr std::size_t BACKGROUND_ZONE{OTHER_ZONE + 1};
+  static constexpr std::size_t ZONES{BACKGROUND_ZONE + 1};
+
+  std::array<std::int64_t, ZONES> allocations{};
+  std::array<std::int64_t, ZONES> bytes{};
+  // Frame threads only; what the budget checks
+  std::int64_t totalAllocations{};
+  std::int64_t totalBytes{};
+};
+
+// Counts calls to the global operator new, which this module replaces for
+// the whole executable. Counting is off until Enable, so the hooks cost one
+// relaxed load per allocation when unused.
+//
+// With a budget, a steady-state frame that allocates more than allowed is
+// reported on stderr with its per-phase counts and the call stack of its
+// first allocation (glibc and macOS), and the run is marked failed.
+// Allocations through EngineAllocator and C malloc (Box2D, ImGui) are not
+// seen here; EngineAllocator keeps its own per-tag totals.
+class AllocationTracker {
+ private:
+  inline static thread_local bool frameThread{};
+
+ public:
+  // Enable also marks the calling thread as a frame thread
+  static void Enable(const AllocationBudget& budget);
+  static bool IsEnabled();
+
+  // Charges the calling thread's allocations to the frame budget. Call it
+  // from threads that run frame work; JobSystem marks its workers.
+  static void MarkFrameThread() { frameThread = true; }
+  static bool IsFrameThread() { return frameThread; }
+
+  // Closes the frame: returns its counts and checks them against the budget
+  static const AllocationFrameStats& EndFrame();
+  static const AllocationFrameStats& GetLastFrame();
+
+  // Steady-state frames checked so far and how many broke the budget
+  static std::int64_t GetCheckedFrames();
+  static std::int64_t GetViolations();
+
+  // Phase name, "other" or "background"
+  static const char* GetZoneName(std::size_t zone);
+};
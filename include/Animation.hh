@@ -1,6 +1,4 @@
 #pragma once
-#include <fstream>
-
 #include "Components/SpriteComponent.hh"
 #include "Components/TransformComponent.hh"
 #include "SFML/Graphics.hpp"
@@ -0,0 +1,39 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "AnimationClip.hh"
+
+// A clip file's contents: frames startFrame..endFrame of one sheet row
+struct AnimationClipSource {
+  int startFrame{};
+  int endFrame{};
+  int row{};
+  float delay{};  // seconds per frame
+};
+
+// Process-wide store of animation clips. Each clip (cooked, or else its
+// JSON) is read once per frame size into an AnimationClip plus its frame
+// rects; loading the same file again returns the cached handle. Clips live
+// until Clear(). Meant to be filled from the main thread during setup.
+class AnimationLibrary {
+ public:
+  // Returns INVALID_ANIMATION_CLIP (and logs) if the file can't be read
+  static AnimationClipHandle Load(const std::string& path,
+                                  sf::Vector2i frameSize);
+  // Reads a clip file without touching the library, so it is safe on any
+  // thread. False (and logged) if it can't be read or is invalid.
+  static bool ReadSource(const std::string& path,
+                         AnimationClipSource& source);
+  static bool IsLoaded(std::string_view path);
+  // Updates every clip loaded from 'path' in place; handles stay valid.
+  // Frame rects are rewritten where they were, or appended if the clip
+  // grew. Returns the number of clips updated.
+  static int Reload(std::string_view path, const AnimationClipSource& source);
+  static const AnimationClip& GetClip(AnimationClipHandle clip);
+  static const sf::IntRect& GetFrame(std::uint32_t frame);
+  static int GetClipCount();
+  static void Clear();
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AnimationClip.hh"
+
+// Data-defined sprite animation graph, compiled from JSON into flat tables:
+// states index a contiguous run of transitions and frame events, and each
+// transition a run of conditions. Evaluating it reads those arrays and the
+// caller's parameter values only, so nothing allocates per frame.
+//
+// {
+//   "parameters": { "speed": 0.0, "grounded": true },
+//   "initial": "idle",
+//   "states": [
+//     { "name": "idle", "clip": "assets/animations/player/idle.json" },
+//     { "name": "walk", "clip": "...", "mode": "loop",
+//       "events": [ { "frame": 2, "name": "step" } ] }
+//   ],
+//   "transitions": [
+//     { "from": "idle", "to": "walk",
+//       "conditions": [ { "param": "speed", "op": ">", "value": 0.1 } ] },
+//     { "from": "any", "to": "idle", "onFinished": true }
+//   ]
+// }
+//
+// "mode" is "loop" (default) or "once"; a transition with "onFinished" only
+// fires after a one-shot clip has played through. Bool parameters are stored
+// as 0/1 floats.
+class AnimationStateMachine {
+ public:
+  using Index = std::uint16_t;
+  static constexpr Index INVALID_INDEX{0xFFFF};
+
+  enum class CompareOp : std::uint8_t {
+    Greater,
+    GreaterEqual,
+    Less,
+    LessEqual,
+    Equal,
+    NotEqual
+  };
+
+  struct Condition {
+    Index parameter{};
+    CompareOp op{};
+    float value{};
+  };
+
+  struct Transition {
+    Index target{};
+    Index firstCondition{};
+    Index conditionCount{};
+    bool onFinished{};
+  };
+
+  struct FrameEvent {
+    std::int32_t frame{};
+    Index name{};
+  };
+
+  struct State {
+    AnimationClipHandle clip{INVALID_ANIMATION_CLIP};
+    std::int32_t frameCount{};
+    bool loop{true};
+    Index firstTransition{};
+    Index transitionCount{};
+    Index firstEvent{};
+    Index eventCount{};
+  };
+
+ private:
+  std::vector<std::string> parameterNames;
+  std::vector<float> defaultParameters;
+  std::vector<std::string> stateNames;
+  std::vector<State> states;
+  // Transitions from "any" state come first, then each state's own run
+  std::vector<Transition> transitions;
+  Index anyTransitionCount{};
+  std::vector<Condition> conditions;
+  std::vector<FrameEvent> events;
+  std::vector<std::string> eventNames;
+  Index initialState{};
+
+  bool Compile(const std::string& path, sf::Vector2i frameSize);
+  bool Passes(const Transition& transition, const float* parameters,
+              bool clipFinished) const;
+
+ public:
+  // Parses and compiles path once per frame size; later calls share the
+  // cached machine. Returns null (and logs) on malformed files.
+  static std::shared_ptr<const AnimationStateMachine> Load(
+      const std::string& path, sf::Vector2i frameSize);
+
+  // Target of the first transition whose conditions all hold, or
+  // INVALID_INDEX to stay in state
+  Index Evaluate(Index state, const float* parameters, bool clipFinished) const;
+
+  Index FindParameter(const std::string& name) const;
+  Index FindState(const std::string& name) const;
+  Index GetInitialState() const;
+  const State& GetState(Index state) const;
+  const std::string& GetStateName(Index state) const;
+  const FrameEvent& GetEvent(Index event) const;
+  const std::string& GetEventName(Index name) const;
+  const std::vector<float>& GetDefaultParameters() const;
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "AnimationClip.hh"
+
+class SpriteComponent;
+
+// Advances every sprite animation in one pass over packed arrays instead of
+// a virtual Update per entity. The timer keeps the remainder past each frame
+// boundary, so playback speed doesn't depend on the frame rate, and only
+// sprites whose frame changed get their texture rect rebound.
+//
+// Animators of Reduced-tier entities (see SimulationLOD) are throttled: they
+// bank their time and only advance, catching up, on the Updates their
+// entity was updated on.
+//
+// Animators are addressed by a stable AnimatorId; the arrays themselves are
+// kept dense with swap-removal.
+class AnimationSystem {
+ public:
+  using AnimatorId = std::uint32_t;
+  static constexpr AnimatorId INVALID_ANIMATOR{~AnimatorId{}};
+
+ private:
+  // Packed per-animator state, all indexed by slot
+  std::vector<float> timers;
+  std::vector<float> delays;
+  std::vector<float> rates;  // 1 while a clip is playing and not paused
+  std::vector<float> pending;  // time banked by a throttled animator
+  std::vector<std::int32_t> frames;
+  std::vector<std::int32_t> frameCounts;
+  std::vector<std::uint32_t> firstFrames;
+  std::vector<std::uint8_t> dirty;
+  std::vector<std::uint8_t> paused;
+  std::vector<std::uint8_t> looping;
+  std::vector<std::uint8_t> finished;  // one-shot clip ran past its end
+  std::vector<std::uint8_t> throttled;
+  std::vector<std::uint8_t> due;  // throttled, but advances this Update
+  std::vector<AnimationClipHandle> clips;
+  std::vector<SpriteComponent*> sprites;
+  std::vector<AnimatorId> slotOwners;
+
+  std::vector<std::uint32_t> slotOfId;
+  std::vector<AnimatorId> freeIds;
+  int touchedLastUpdate{};
+
+  std::uint32_t SlotOf(AnimatorId id) const;
+  void RefreshRate(std::uint32_t slot);
+
+ public:
+  // sprite may be null (headless/benchmark use): its frames still advance
+  AnimatorId Add(SpriteComponent* sprite);
+  void Remove(AnimatorId id);
+
+  // Restarts from the first frame unless clip is already playing in the
+  // same mode. A one-shot clip holds its last frame once finished.
+  void Play(AnimatorId id, AnimationClipHandle clip, bool loop = true);
+  AnimationClipHandle GetClip(AnimatorId id) const;
+  int GetFrameIndex(AnimatorId id) const;
+  bool IsFinished(AnimatorId id) const;
+  void SetPaused(AnimatorId id, bool paused);
+  void SetThrottled(AnimatorId id, bool throttled);
+  // Lets a throttled animator advance on the next Update
+  void MarkDue(AnimatorId id);
+
+  void Update(float deltaTime);
+  // Re-reads every playing clip from the AnimationLibrary after a Reload,
+  // keeping each animator's frame where it still fits
+  void RefreshClips();
+
+  int GetAnimatorCount() const;
+  // Sprites whose texture rect changed during the last Update
+  int GetTouchedCount() const;
+};
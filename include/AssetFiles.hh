@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+class Value;
+}
+
+// Contents of one asset. Uncompressed entries of a mounted pack are spans
+// straight into the mapping (no copy, valid until AssetFiles::Unmount);
+// compressed entries and loose files own their bytes. Move-only.
+class AssetData {
+ private:
+  std::vector<std::byte> owned;
+  const std::byte* data{};
+  std::size_t size{};
+  bool found{};
+
+ public:
+  AssetData() = default;
+  static AssetData View(std::span<const std::byte> bytes);
+  static AssetData Own(std::vector<std::byte> bytes);
+
+  AssetData(AssetData&&) = default;
+  AssetData& operator=(AssetData&&) = default;
+  AssetData(const AssetData&) = delete;
+  AssetData& operator=(const AssetData&) = delete;
+
+  // False if the asset wasn't found or couldn't be read
+  explicit operator bool() const { return found; }
+  const std::byte* GetData() const { return data; }
+  std::size_t GetSize() const { return size; }
+  std::string_view GetText() const {
+    return std::string_view(reinterpret_cast<const char*>(data), size);
+  }
+  // True for a span into the mounted pack
+  bool IsMapped() const { return found && owned.empty() && size > 0; }
+};
+
+struct AssetFilesStats {
+  std::int64_t packReads{};
+  std::int64_t looseReads{};
+  std::int64_t decompressedBytes{};
+};
+
+// Where the engine reads assets from. With a .bpak mounted (see the
+// AssetPacker tool), paths resolve to entries of the memory-mapped archive;
+// development builds still fall back to loose files for paths the pack
+// lacks, so new assets work before repacking. Without a pack everything is
+// read from loose files relative to the working directory.
+//
+// Mount and Unmount at startup and shutdown; reads are thread-safe.
+class AssetFiles {
+ public:
+  // False (and loose files only) if 'packPath' is missing or invalid
+  static bool Mount(const std::string& packPath);
+  static void Unmount();
+  static bool IsMounted();
+
+  static AssetData Read(std::string_view path);
+  static bool Exists(std::string_view path);
+  // True if Read would serve 'path' from a loose file, so a streaming reader
+  // can open it itself instead of having it read whole
+  static bool IsLoose(std::string_view path);
+  // Reads 'path' from disk ahead of the pack from now on, so a file edited
+  // while the game runs (see HotReload) replaces its packed copy
+  static void PreferLoose(std::string_view path);
+  // Path of the most recently modified file in 'directory' ending in
+  // 'extension', or empty; searches the pack when one is mounted
+  static std::string FindNewest(std::string_view directory,
+                                std::string_view extension);
+
+  // Parses 'data' as JSON; false with jsoncpp's messages in 'errors'
+  static bool ParseJson(const AssetData& data, Json::Value& root,
+                        std::string& errors);
+
+  static AssetFilesStats GetStats();
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk layout of a .bpak archive, little-endian:
+//
+//   PackHeader
+//   blobs, each starting on a PACK_ALIGNMENT boundary
+//   PackEntry[entryCount], sorted by path
+//   path strings, not terminated; entries point into them
+//
+// Paths are relative to the project root with '/' separators
+// ("assets/sprites/hero.png"), so they match what the engine asks for.
+inline constexpr char PACK_MAGIC[4]{'B', 'P', 'A', 'K'};
+inline constexpr std::uint32_t PACK_VERSION{1};
+inline constexpr std::uint64_t PACK_ALIGNMENT{16};
+
+enum class PackCompression : std::uint32_t {
+  None,
+  Lz,  // PackCodec's LZ77 byte format
+};
+
+struct PackHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t entryCount;
+  std::uint32_t reserved;
+  std::uint64_t entriesOffset;
+  std::uint64_t namesOffset;
+  std::uint64_t namesSize;
+};
+
+struct PackEntry {
+  std::uint64_t offset;      // of the blob, from the start of the file
+  std::uint64_t storedSize;  // bytes in the archive
+  std::uint64_t size;        // bytes once decompressed
+  // Source file's last write time, only comparable with other entries
+  std::int64_t modifiedTime;
+  std::uint32_t nameOffset;
+  std::uint32_t nameLength;
+  PackCompression compression;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 40);
+static_assert(sizeof(PackEntry) == 48);
+
+// Small LZ77 codec for packed assets: tokens of literal run and match
+// lengths, 16-bit back references. Decoding is a bounds-checked copy loop;
+// the ratio matters less than not needing a third-party library.
+namespace PackCodec {
+
+std::vector<std::byte> Compress(std::span<const std::byte> input);
+// 'output' must be exactly the original size. False on corrupt input.
+bool Decompress(std::span<const std::byte> input, std::span<std::byte> output);
+
+}  // namespace PackCodec
+
+// A .bpak mapped read-only into memory. Opening validates the header and
+// every entry; after that lookups are a binary search over the table and
+// blobs are spans into the mapping, valid until Close.
+class AssetPack {
+ private:
+  const std::byte* mapping{};
+  std::size_t mappingSize{};
+#ifdef _WIN32
+  void* fileHandle{};
+  void* mappingHandle{};
+#endif
+  std::span<const PackEntry> entries;
+  const char* names{};
+
+ public:
+  AssetPack() = default;
+  ~AssetPack();
+  AssetPack(const AssetPack&) = delete;
+  AssetPack& operator=(const AssetPack&) = delete;
+
+  bool Open(const std::string& path);
+  void Close();
+  bool IsOpen() const;
+
+  // Null if 'path' isn't in the archive
+  const PackEntry* Find(std::string_view path) const;
+  std::span<const PackEntry> GetEntries() const;
+  std::string_view GetPath(const PackEntry& entry) const;
+  // The blob as stored (compressed or not)
+  std::span<const std::byte> GetStored(const PackEntry& entry) const;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef __linux__
+#include <filesystem>
+#endif
+
+inline constexpr std::chrono::milliseconds ASSET_WATCH_POLL_INTERVAL{500};
+inline constexpr std::chrono::milliseconds ASSET_WATCH_SETTLE_TIME{150};
+
+// Reports loose asset files that changed on disk while the game runs (see
+// HotReload). On Linux a background thread blocks on one inotify watch per
+// directory; other platforms fall back to rescanning modification times
+// every ASSET_WATCH_POLL_INTERVAL. Paths come back the way loaders ask for
+// them ("assets/maps/level1.json"), each once however often it was written.
+class AssetWatcher {
+ private:
+  std::string root;
+  std::thread watcher;
+  std::mutex mutex;
+  std::condition_variable stopRequested;
+  bool quit{};
+  std::unordered_set<std::string> changed;
+  std::chrono::steady_clock::time_point lastChange;
+  std::atomic<bool> running{};
+
+#ifdef __linux__
+  int inotifyFd{-1};
+  int wakeFd{-1};  // eventfd written by Stop
+  std::unordered_map<int, std::string> directories;  // by watch descriptor
+  // Watches 'directory' and everything below it
+  void AddWatches(const std::string& directory);
+#else
+  std::unordered_map<std::string, std::filesystem::file_time_type> times;
+  // Records every file's time; reports the new and changed ones
+  void Scan(bool report);
+#endif
+
+  void WatchLoop();
+  void MarkChanged(std::string path);
+
+ public:
+  AssetWatcher() = default;
+  ~AssetWatcher();
+
+  AssetWatcher(const AssetWatcher&) = delete;
+  AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+  // Watches 'directory' recursively; false (and logged) if it can't
+  bool Start(const std::string& directory);
+  void Stop();
+  bool IsRunning() const;
+
+  // Appends the paths changed since the last call. Holds them back until
+  // writes have been quiet for ASSET_WATCH_SETTLE_TIME, so a file saved in
+  // several steps, or several files saved together, arrive as one batch.
+  void Poll(std::vector<std::string>& paths);
+};
@@ -5,12 +5,17 @@
 #include <memory>
 #include <string>
 
+// Cheap handle to a decoded sound: the samples live in SoundBufferCache and
+// are shared by every clip for the same file. Copies share the buffer and
+// get their own playback state.
 class AudioClip {
  private:
   std::string audioUrl{};
+  float volume{100.f};
 #ifdef SFML_AUDIO_AVAILABLE
+  std::shared_ptr<const sf::SoundBuffer> buffer;
+  // Created on first Play, per instance
   std::unique_ptr<sf::Sound> sound;
-  std::unique_ptr<sf::SoundBuffer> buffer;
 #endif
  public:
   AudioClip();
@@ -23,8 +28,13 @@ class AudioClip {
   AudioClip(AudioClip&& other) noexcept;
   AudioClip& operator=(AudioClip&& other) noexcept;
 
+  void Play();
+  void SetVolume(float volume);
+  bool IsValid() const;
+  const std::string& GetPath() const;
+  float GetVolume() const;
 #ifdef SFML_AUDIO_AVAILABLE
-  void Play(sf::SoundBuffer& buffer);
+  // Shared decoded samples, e.g. for AudioMixer::Play
+  const std::shared_ptr<const sf::SoundBuffer>& GetBuffer() const;
 #endif
-  void SetVolume(float volume);
-};
\ No newline at end of file
+};
@@ -0,0 +1,168 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SFML/Audio.hpp"
+
+enum class AudioBus : std::uint8_t { Sfx, Ui, Music, Count };
+
+struct VoiceParams {
+  float volume{1.f};  // linear gain, 1 = unity
+  float pan{};        // -1 left .. 1 right
+  float pitch{1.f};   // playback rate multiplier
+  std::uint8_t priority{128};
+  AudioBus bus{AudioBus::Sfx};
+  bool loop{};
+};
+
+// Identifies one Play call; stale once its voice ends or is stolen
+using VoiceHandle = std::uint32_t;
+constexpr VoiceHandle INVALID_VOICE{0};
+
+struct AudioMixerStats {
+  int activeVoices{};
+  int voiceCount{};
+  std::int64_t played{};
+  std::int64_t stolen{};   // voices cut short by higher-priority plays
+  std::int64_t dropped{};  // plays rejected: pool busy or queue full
+  float mixMicroseconds{};  // cost of the last mixed chunk
+};
+
+// Pull-based input (e.g. streamed music) that the mixer calls on its audio
+// thread once per chunk, after the voices
+class AudioMixerSource {
+ public:
+  virtual ~AudioMixerSource() = default;
+  // Adds frames of stereo audio at AudioMixer::SAMPLE_RATE, scaled by gain,
+  // into left and right. Must not block or allocate.
+  virtual void Mix(float* left, float* right, std::size_t frames,
+                   float gain) = 0;
+};
+
+// Engine mixer: every sound effect plays through one sf::SoundStream that
+// sums a fixed pool of voices into a stereo float buffer with SIMD kernels.
+// Cost per chunk depends on the pool size, not on how many plays were
+// requested, and playing a sound never allocates: the game thread posts
+// commands to a fixed ring that the audio thread drains before each chunk.
+//
+// When the pool is full a new voice takes the slot of the lowest-priority
+// one (the most advanced of those on a tie) if its own priority is at least
+// as high; otherwise the play is dropped.
+//
+// Play/Stop/SetVoice*, the source calls and the bus setters are meant to be
+// called from one thread (the game thread).
+class AudioMixer : private sf::SoundStream {
+ public:
+  static constexpr int DEFAULT_VOICE_COUNT{64};
+  static constexpr unsigned SAMPLE_RATE{44100};
+  static constexpr std::size_t CHUNK_FRAMES{512};
+
+ private:
+  struct Voice {
+    std::shared_ptr<const sf::SoundBuffer> buffer;
+    const std::int16_t* samples{};
+    std::uint64_t frameCount{};
+    unsigned channels{};
+    double position{};  // in source frames
+    double step{};      // source frames per output frame
+    VoiceParams params;
+    VoiceHandle handle{INVALID_VOICE};
+  };
+
+  enum class CommandType : std::uint8_t { Play, Stop, SetVolume, SetPan,
+                                          SetPitch, AddSource, RemoveSource };
+  struct Command {
+    CommandType type{};
+    VoiceHandle handle{INVALID_VOICE};
+    std::shared_ptr<const sf::SoundBuffer> buffer;
+    VoiceParams params;
+    float value{};
+    AudioMixerSource* source{};  // AddSource and RemoveSource
+  };
+  static constexpr std::size_t COMMAND_CAPACITY{256};
+
+  struct SourceSlot {
+    AudioMixerSource* source{};
+    AudioBus bus{};
+  };
+  static constexpr std::size_t MAX_SOURCES{4};
+  // Written by DrainCommands only. The game thread reads it between
+  // AddSource and RemoveSource calls, which wait for their command.
+  std::array<SourceSlot, MAX_SOURCES> sources{};
+
+  // Single-producer/single-consumer ring; indices only ever grow
+  std::array<Command, COMMAND_CAPACITY> commands;
+  // Written by the audio thread, or by the game thread while the stream
+  // isn't playing
+  std::atomic<std::size_t> commandHead{};
+  std::atomic<std::size_t> commandTail{};  // written by the game thread
+
+  // Audio thread only
+  std::vector<Voice> voices;
+  std::vector<float> mixLeft;
+  std::vector<float> mixRight;
+  std::vector<float> scratchLeft;
+  std::vector<float> scratchRight;
+  std::vector<std::int16_t> output;
+
+  std::array<std::atomic<float>, static_cast<std::size_t>(AudioBus::Count)>
+      busVolumes;
+  std::atomic<float> masterVolume{1.f};
+  VoiceHandle nextHandle{INVALID_VOICE};
+
+  std::atomic<int> activeVoices{};
+  std::atomic<std::int64_t> played{};
+  std::atomic<std::int64_t> stolen{};
+  std::atomic<std::int64_t> dropped{};
+  std::atomic<float> mixMicroseconds{};
+
+  bool Post(Command&& command);
+  // Posts a command that must not be dropped and returns once it is
+  // applied. Drains the ring itself while the stream isn't playing.
+  void PostAndWait(Command&& command);
+  void DrainCommands();
+  void StartVoice(Command& command);
+  Voice* FindVoice(VoiceHandle handle);
+  // Resamples up to CHUNK_FRAMES of voice into the scratch buffers; returns
+  // how many frames were written and ends the voice past its last frame
+  std::size_t RenderVoice(Voice& voice, std::size_t frames);
+
+  bool onGetData(Chunk& data) override;
+  void onSeek(sf::Time timeOffset) override;
+
+ public:
+  explicit AudioMixer(int voiceCount = DEFAULT_VOICE_COUNT);
+  ~AudioMixer();
+
+  AudioMixer(const AudioMixer&) = delete;
+  AudioMixer& operator=(const AudioMixer&) = delete;
+
+  void Start();
+  void Stop();
+
+  // Returns INVALID_VOICE if buffer is null or the command queue is full;
+  // a handle can still be dropped later if the pool has no stealable voice
+  VoiceHandle Play(std::shared_ptr<const sf::SoundBuffer> buffer,
+                   const VoiceParams& params = {});
+  void StopVoice(VoiceHandle voice);
+  void SetVoiceVolume(VoiceHandle voice, float volume);
+  void SetVoicePan(VoiceHandle voice, float pan);
+  void SetVoicePitch(VoiceHandle voice, float pitch);
+
+  // The source must stay alive until RemoveSource returns; after that the
+  // audio thread no longer calls it. Both go through the command ring, so
+  // the audio thread never waits on them, but they wait for the next chunk.
+  void AddSource(AudioMixerSource* source, AudioBus bus);
+  void RemoveSource(AudioMixerSource* source);
+
+  void SetBusVolume(AudioBus bus, float volume);
+  float GetBusVolume(AudioBus bus) const;
+  void SetMasterVolume(float volume);
+  float GetMasterVolume() const;
+
+  AudioMixerStats GetStats() const;
+  static const char* GetBusName(AudioBus bus);
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AnimationStateMachine.hh"
+#include "AnimatorComponent.hh"
+#include "Component.hh"
+
+// Drives the entity's AnimatorComponent from an AnimationStateMachine.
+// Gameplay only writes parameters (resolve the index once with
+// GetParameter); the component switches clips when a transition fires and
+// reports frame events to the listener. Add after AnimatorComponent.
+class AnimationStateMachineComponent : public Component {
+ public:
+  using Index = AnimationStateMachine::Index;
+
+ private:
+  const char* definitionPath{};
+  std::shared_ptr<const AnimationStateMachine> machine;
+  AnimatorComponent* animator{};
+  std::vector<float> parameters;
+  Index currentState{AnimationStateMachine::INVALID_INDEX};
+  int lastFrame{-1};
+  std::function<void(const std::string& eventName)> eventListener;
+
+  void EnterState(Index state);
+  void DispatchFrameEvents();
+
+ public:
+  explicit AnimationStateMachineComponent(const char* definitionPath);
+  // With a machine already loaded for this entity's frame size (prefabs)
+  explicit AnimationStateMachineComponent(
+      std::shared_ptr<const AnimationStateMachine> machine);
+  ~AnimationStateMachineComponent();
+  void Initialize() override;
+  void Update(float& deltaTime) override;
+
+  // INVALID_INDEX if the machine has no such parameter
+  Index GetParameter(const std::string& name) const;
+  void SetFloat(Index parameter, float value);
+  void SetBool(Index parameter, bool value);
+  float GetFloat(Index parameter) const;
+  const std::string& GetCurrentStateName() const;
+  void SetEventListener(
+      std::function<void(const std::string& eventName)> listener);
+};
@@ -1,34 +1,43 @@
 #pragma once
-#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "AnimationClip.hh"
+#include "AnimationSystem.hh"
 #include "Component.hh"
 #include "SpriteComponent.hh"
 #include "TransformComponent.hh"
 
+// Front end for an animator slot in the AnimationSystem, which advances all
+// animators in one batch; this component has no per-frame Update.
 class AnimatorComponent : public Component {
  private:
+  AnimationSystem& animationSystem;
+  AnimationSystem::AnimatorId animatorId{AnimationSystem::INVALID_ANIMATOR};
   SpriteComponent* sprite;
   TransformComponent* transform;
-  std::string currentAnimationName{};
-  std::map<std::string, AnimationClip> animations;
-  AnimationClip currentAnimationClip;
-
-  int animationIndex{};
-  int startFrame{};
-  int endFrame{};
-  float animationDelay{};
-  int currentAnimation{};
-  float currentTime{};
+  // Names are only used to resolve handles during setup
+  std::vector<std::pair<std::string, AnimationClipHandle>> animations;
 
  public:
-  AnimatorComponent();
+  explicit AnimatorComponent(AnimationSystem& animationSystem);
   ~AnimatorComponent();
 
-  void Play(std::string animationName);
-  void AddAnimation(std::string animationName, AnimationClip animationClip);
+  // Switching to the clip already playing is a no-op; one-shot clips
+  // (loop = false) hold their last frame and then report IsFinished
+  void Play(AnimationClipHandle clip, bool loop = true);
+  // Loads through AnimationLibrary using the transform size as frame size
+  AnimationClipHandle AddAnimation(const std::string& animationName,
+                                   const char* clipPath);
+  void AddAnimation(const std::string& animationName, AnimationClipHandle clip);
+  AnimationClipHandle GetAnimation(const std::string& animationName) const;
+  AnimationClipHandle GetCurrentClip() const;
+  int GetFrameIndex() const;
+  bool IsFinished() const;
+  void SetPaused(bool paused);
+  // Reduced LOD tier: advance only on frames the entity updates (MarkDue)
+  void SetThrottled(bool throttled);
+  void MarkDue();
   void Initialize() override;
-  void Update(float& deltaTime) override;
-  void RefreshAnimationClip();
-};
\ No newline at end of file
+};
@@ -1,23 +1,28 @@
 #pragma once
 #include "AudioClip.hh"
 #include "Component.hh"
-#ifdef SFML_AUDIO_AVAILABLE
-#include "SFML/Audio.hpp"
-#endif
 
+class AudioMixer;
+
+// Plays one-shots through the engine AudioMixer, so overlapping plays of the
+// same clip each get their own voice instead of retriggering one sf::Sound
 class AudioListenerComponent : public Component {
  private:
+  AudioMixer& mixer;
   AudioClip* audioClip{};
-#ifdef SFML_AUDIO_AVAILABLE
-  sf::SoundBuffer soundBuffer{};
-#endif
+
  public:
-  AudioListenerComponent();
+  // Play and PlayOneShot without a volume; as quiet as before the mixer
+  static constexpr float DEFAULT_VOLUME{1.f};
+
+  explicit AudioListenerComponent(AudioMixer& mixer);
   ~AudioListenerComponent();
 
   AudioClip* GetAudioClip() const;
+  AudioMixer& GetMixer() const;
   void Play();
-  void PlayOneShot(AudioClip& audioClip);
-  void PlayOneShot(AudioClip& audioClip, float audioVolume);
+  void PlayOneShot(const AudioClip& audioClip);
+  // audioVolume uses AudioClip's 0-100 scale
+  void PlayOneShot(const AudioClip& audioClip, float audioVolume);
   void Initialize() override;
 };
@@ -4,36 +4,67 @@
 #include <gsl/assert>
 #include <gsl/pointers>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Component.hh"
 #include "EntityManager.hh"
+#include "SimulationLOD.hh"
 
 class Component;
 class EntityManager;
+class PrefabSpawner;
+struct Prefab;
 
 class Entity {
  private:
   EntityManager& entityManager;
   bool isActive;
-  // Owns the lifetime of attached components
-  std::vector<gsl::owner<Component*>> components;
+  bool isEnabled{true};
+  // Update order. The first storedComponentCount were attached from
+  // componentStorage and are destroyed in place; the rest are owned.
+  std::vector<Component*> components;
+  std::shared_ptr<void> componentStorage;
+  std::size_t storedComponentCount{};
   std::map<const std::type_info*, Component*> componentTypeMap;
+  SimulationTier simulationTier{SimulationTier::Full};
+  // Time skipped while Reduced, handed to the next update
+  float pendingDeltaTime{};
+  const Prefab* prefab{};
+  PrefabSpawner* spawnPool{};
 
  public:
   std::string name;
   Entity(EntityManager& entityManager);
   Entity(EntityManager& entityManager, std::string name);
   void Update(float& deltaTime);
+  // Tier-gated updates driven by EntityManager (see SimulationLOD). A
+  // Dormant entity whose body was woken still follows it.
+  void SkipUpdate(float deltaTime);
+  void CatchUpUpdate(float deltaTime);
+  SimulationTier GetSimulationTier() const;
+  // Entering Dormant puts the rigid body to sleep and pauses the animator,
+  // leaving it resumes both
+  void SetSimulationTier(SimulationTier tier);
   void Render(sf::RenderWindow& window);
+  // Also takes a despawned entity out of its spawn pool
   void Destroy();
   bool IsActive() const;
+  // A disabled entity stays alive but is skipped by EntityManager, with its
+  // rigid body out of the world and its animator paused (spawn pools)
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+  // The prefab it was spawned from, null for entities built by hand
+  const Prefab* GetPrefab() const;
+  void SetPrefab(const Prefab* prefab);
+  // The spawner whose pool holds it while despawned, null otherwise
+  void SetSpawnPool(PrefabSpawner* spawner);
   ~Entity();
 
   template <typename T, typename... TArgs>
   T& AddComponent(TArgs&&... args) {
-    T* newComponent{new T(std::forward<TArgs>(args)...)};
+    gsl::owner<T*> newComponent{new T(std::forward<TArgs>(args)...)};
     newComponent->owner = this;
     components.emplace_back(newComponent);
     componentTypeMap[&typeid(*newComponent)] = newComponent;
@@ -43,6 +74,21 @@ class Entity {
     return *newComponent;
   }
 
+  // Adopts a component constructed in 'storage' (see PrefabSpawner), which
+  // is kept alive until the entity is destroyed. Attach before adding any.
+  template <typename T>
+  T& AttachComponent(T& component, const std::shared_ptr<void>& storage) {
+    Expects(storedComponentCount == components.size());
+    Expects(!componentStorage || componentStorage == storage);
+    if (!componentStorage) componentStorage = storage;
+    component.owner = this;
+    components.push_back(&component);
+    ++storedComponentCount;
+    componentTypeMap[&typeid(component)] = &component;
+    component.Initialize();
+    return component;
+  }
+
   template <typename T>
   T* GetComponent() {
     auto it = componentTypeMap.find(&typeid(T));
@@ -1,17 +1,24 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <gsl/span>
 #include <memory>
 #include <vector>
 
 #include "Component.hh"
 #include "Entity.hh"
+#include "SimulationLOD.hh"
 
 class EntityManager {
  private:
   std::vector<std::unique_ptr<Entity>> entities;
   std::vector<std::unique_ptr<Entity>> activeEntities;
   std::vector<std::unique_ptr<Entity>> inactiveEntities;
+  SimulationLOD simulationLOD;
+  // Entity whose position drives the LOD tiers; always simulated at Full
+  Entity* simulationFocus{};
+
+  SimulationTier ClassifyEntity(Entity& entity) const;
 
  public:
   EntityManager(/* args */);
@@ -22,6 +29,15 @@ class EntityManager {
   void Render(sf::RenderWindow& window);
   bool HasNoEntities();
   Entity& AddEntity(std::string entityName);
+  // Room for 'additional' more entities, ahead of a bulk spawn
+  void Reserve(std::size_t additional);
+  // Snapshot in the thread's FrameArena; valid until the frame ends
   gsl::span<Entity*> GetEntities() const;
   unsigned int GetentityCount() const;
+  // Hash of every active, enabled entity's transform and rigid body state,
+  // for spotting divergence between runs or builds
+  std::uint64_t ComputeChecksum() const;
+  void SetSimulationFocus(Entity* focus);
+  SimulationLOD& GetSimulationLOD();
+  const SimulationLOD& GetSimulationLOD() const;
 };
\ No newline at end of file
@@ -5,23 +5,25 @@
 #include <gsl/gsl>
 
 #include "Component.hh"
+#include "PartitionedPhysicsWorld.hh"
 #include "SpriteComponent.hh"
 #include "TransformComponent.hh"
 
 class RigidBodyComponent : public Component {
  private:
-  b2BodyDef* bodyDef{};
   b2Body* body{};
-  b2PolygonShape* polygonShape{};
-  b2FixtureDef* fixtureDef{};
-  b2Fixture* fixture{};
-  gsl::not_null<b2World*> world;
+  b2World* world{};
+  // Set instead of world in partitioned mode; the b2Body is then resolved
+  // through bodyId since handoffs between cells replace it.
+  PartitionedPhysicsWorld* partitionedWorld{};
+  PartitionedPhysicsWorld::BodyId bodyId{PartitionedPhysicsWorld::INVALID_BODY};
   TransformComponent* transform{};
   SpriteComponent* spriteComponent{};
 
   b2Vec2 bodyPos{};
   sf::Vector2f trsPos{};
 
+  b2BodyType bodyType{};
   float density{};
   float friction{};
   float restitution{};
@@ -33,13 +35,24 @@ class RigidBodyComponent : public Component {
   RigidBodyComponent(gsl::not_null<b2World*> world, b2BodyType bodyType,
                      float density, float friction, float restitution,
                      float angle, bool frezeRotation, void* userData);
+  RigidBodyComponent(gsl::not_null<PartitionedPhysicsWorld*> partitionedWorld,
+                     b2BodyType bodyType, float density, float friction,
+                     float restitution, float angle, bool frezeRotation,
+                     void* userData);
   ~RigidBodyComponent();
 
   b2Body* GetBody() const;
   void FreezeRotation(bool freeze);
+  // Position in pixels
   sf::Vector2f GetPositionSFML() const;
+  // Position in meters (Box2D world units)
   b2Vec2 GetPosition() const;
+  // Velocity in meters per second, see PhysicsUnits::ToMeters
   void AddVelocity(b2Vec2 velocity);
+  // Takes the body out of the world, or puts it back
+  void SetEnabled(bool enabled);
+  // Moves the body and the transform to 'position' (pixels), at rest
+  void Teleport(sf::Vector2f position);
   void Update(float& deltaTime) override;
   void Initialize() override;
 };
\ No newline at end of file
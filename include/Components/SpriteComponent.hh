@@ -8,15 +8,18 @@
 class SpriteComponent : public Component {
  private:
   TransformComponent* transform;
-  sf::Texture texture{};
+  // Shared through the TextureCache; never null
+  std::shared_ptr<const sf::Texture> texture;
   std::unique_ptr<sf::Sprite>
       sprite;  // SFML 3: construct after texture is ready
-  const char* textureUrl{};
   unsigned int col{}, row{};
   bool flipTexture{false};
 
  public:
   SpriteComponent(const char* textureUrl, unsigned int col, unsigned int row);
+  // With a texture already taken from the TextureCache (prefabs)
+  SpriteComponent(std::shared_ptr<const sf::Texture> texture, unsigned int col,
+                  unsigned int row);
   ~SpriteComponent();
   void Update(float& deltaTime) override;
   void Render(sf::RenderWindow& window) override;
@@ -24,5 +27,6 @@ class SpriteComponent : public Component {
   bool GetFlipTexture() const;
   sf::Vector2f GetOrigin() const;
   void RebindRectTexture(int col, int row, float width, float height);
+  void SetTextureRect(const sf::IntRect& rect);
   void Initialize() override;
 };
@@ -1,21 +1,63 @@
-const unsigned int WINDOW_WIDTH{760};
-const unsigned int WINDOW_HEIGHT{760};
-const char* GAME_NAME{"Game1"};
-const char* ASSETS_SPRITES{"assets/sprites.png"};
-const char* ASSETS_TILES{"assets/tiles.png"};
-const char* ASSETS_MAPS_JSON{"assets/maps/level1.json"};
-const char* ASSETS_MAPS_JSON_TWO{"assets/maps/level2.json"};
-const char* ASSETS_MAPS_JSON_THREE{"assets/maps/level4.json"};
-const char* ASSETS_FONT_ARCADECLASSIC{"assets/fonts/ARCADECLASSIC.TTF"};
+#pragma once
+
+// inline so every translation unit including this shares one definition
+inline constexpr unsigned int WINDOW_WIDTH{760};
+inline constexpr unsigned int WINDOW_HEIGHT{760};
+inline constexpr const char* GAME_NAME{"Game1"};
+inline constexpr const char* ASSETS_DIRECTORY{"assets"};
+inline constexpr const char* ASSETS_SPRITES{"assets/sprites.png"};
+inline constexpr const char* ASSETS_TILES{"assets/tiles.png"};
+inline constexpr const char* ASSETS_MAPS_JSON{"assets/maps/level1.json"};
+inline constexpr const char* ASSETS_MAPS_JSON_TWO{"assets/maps/level2.json"};
+inline constexpr const char* ASSETS_MAPS_JSON_THREE{"assets/maps/level4.json"};
+inline constexpr const char* ASSETS_FONT_ARCADECLASSIC{
+    "assets/fonts/ARCADECLASSIC.TTF"};
+inline constexpr const char* ASSETS_INPUT_BINDINGS{
+    "assets/input/bindings.json"};
+inline constexpr const char* ASSETS_PREFABS{"assets/prefabs/prefabs.json"};
+// Optional background track, streamed if present
+inline constexpr const char* ASSETS_MUSIC{"assets/audio/music.ogg"};
+// Archive built from assets/ by AssetPacker; loose files are used without it
+inline constexpr const char* ASSETS_PACK{"assets.bpak"};
+// Written by AssetCooker; sources are loaded directly without it
+inline constexpr const char* ASSETS_COOKED_MANIFEST{
+    "assets/cooked/manifest.txt"};
+// Shared-memory ring written with --telemetry and read by TelemetryViewer
+inline constexpr const char* TELEMETRY_SEGMENT{"/blackengine-telemetry"};
 
 // Game constants
 namespace GameConstants {
-constexpr float PLAYER_SPEED = 200.0f;
-constexpr float PLAYER_FRICTION = 0.28f;
 constexpr int PHYSICS_VELOCITY_ITERATIONS = 8;
 constexpr int PHYSICS_POSITION_ITERATIONS = 8;
 constexpr float TILE_SIZE = 16.0f;
 constexpr float TILE_SCALE = 4.0f;
 constexpr int MAP_WIDTH = 12;
 constexpr int MAP_HEIGHT = 12;
+// One scaled tile (TILE_SIZE * TILE_SCALE) is one Box2D meter
+constexpr float PIXELS_PER_METER = TILE_SIZE * TILE_SCALE;
+// Split the map into independently stepped physics cells (large maps only)
+constexpr bool PHYSICS_PARTITIONED = false;
+constexpr float PHYSICS_CELL_SIZE = 16.0f;    // meters
+constexpr float PHYSICS_GHOST_MARGIN = 1.0f;  // meters
+// Simulation LOD around the hero: rings of SIM_LOD_CELL_SIZE pixel cells
+constexpr float SIM_LOD_CELL_SIZE = TILE_SIZE * TILE_SCALE * 4.0f;
+constexpr int SIM_LOD_FULL_RADIUS = 2;
+constexpr int SIM_LOD_REDUCED_RADIUS = 4;
+constexpr int SIM_LOD_REDUCED_INTERVAL = 4;  // frames between reduced updates
+// Mixer voices shared by all one-shots; the quietest are stolen past this
+constexpr int AUDIO_VOICE_COUNT = 256;
+constexpr float MUSIC_CROSSFADE_SECONDS = 1.5f;
+// Tick length for --record/--replay/--headless runs, and ticks between world
+// checksums
+constexpr float FIXED_TIME_STEP = 1.0f / 60.0f;
+constexpr unsigned int REPLAY_CHECKSUM_INTERVAL = 60;
+// Ticks a --headless run simulates when --ticks isn't given
+constexpr unsigned int HEADLESS_TICKS = 600;
+// Windowed frame cap (see FramePacer); --fps and --vsync override it
+constexpr float FRAME_RATE_TARGET = 60.0f;
+constexpr float FRAME_RATE_BACKGROUND = 10.0f;  // unfocused or minimized
+// Ticks between lines of the --metrics JSONL log
+constexpr unsigned int METRICS_LOG_INTERVAL = 60;
+// Frames --alloc-budget lets allocate before requiring zero per frame
+constexpr unsigned int ALLOC_BUDGET_WARMUP_FRAMES = 120;
 }  // namespace GameConstants
\ No newline at end of file
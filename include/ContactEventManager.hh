@@ -3,11 +3,20 @@
 
 #include <iostream>
 
+#include "PartitionedPhysicsWorld.hh"
+
+class Entity;
+
 class ContactEventManager : public b2ContactListener {
  private:
+  void HandleBeginContact(Entity* actorA, Entity* actorB);
+  void HandleEndContact(Entity* actorA, Entity* actorB);
+
  public:
   ContactEventManager();
   ~ContactEventManager();
   void BeginContact(b2Contact* contact) override;
   void EndContact(b2Contact* contact) override;
+  // Merged events from a PartitionedPhysicsWorld step
+  void Dispatch(const std::vector<PhysicsContactEvent>& events);
 };
\ No newline at end of file
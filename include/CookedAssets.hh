@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sf {
+class Image;
+class Texture;
+}
+
+// Runtime-ready versions of source assets, written by the AssetCooker tool
+// to assets/cooked/ and listed in its manifest. All formats are
+// little-endian and start with a magic and COOKED_VERSION; bump it whenever
+// one changes so every asset is cooked again.
+inline constexpr std::uint32_t COOKED_VERSION{1};
+inline constexpr const char* COOKED_DIRECTORY{"cooked"};
+inline constexpr const char* COOKED_MANIFEST{"manifest.txt"};
+
+enum class CookedKind : std::uint32_t {
+  Texture,  // *.png, decoded to RGBA8
+  Map,      // maps/*.json, tiles as a flat grid
+  Clip,     // animations/**/*.json with an "animation" object
+  Count
+};
+
+// Texture: the header, then width * height RGBA8 pixels, row by row
+inline constexpr char COOKED_TEXTURE_MAGIC[4]{'B', 'T', 'E', 'X'};
+struct CookedTextureHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t width;
+  std::uint32_t height;
+};
+
+// Map: the header, then per layer a CookedMapLayer, its tileset path
+// (tilesetLength bytes, empty for TileGroup's default) and columns * rows
+// cells, row by row. Zero tile sizes also mean TileGroup's default.
+inline constexpr char COOKED_MAP_MAGIC[4]{'B', 'M', 'A', 'P'};
+struct CookedMapHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t layerCount;
+  std::uint32_t reserved;
+};
+struct CookedMapLayer {
+  std::uint32_t tileWidth;
+  std::uint32_t tileHeight;
+  std::uint32_t columns;
+  std::uint32_t rows;
+  std::uint32_t tilesetLength;
+  std::uint32_t reserved;
+};
+struct CookedMapCell {
+  std::uint16_t column;  // in the tileset; 0,0 is an empty cell
+  std::uint16_t row;
+};
+
+inline constexpr char COOKED_CLIP_MAGIC[4]{'B', 'C', 'L', 'P'};
+struct CookedClip {
+  char magic[4];
+  std::uint32_t version;
+  std::int32_t startFrame;
+  std::int32_t endFrame;
+  std::int32_t row;
+  float delay;
+};
+
+static_assert(sizeof(CookedTextureHeader) == 16);
+static_assert(sizeof(CookedMapHeader) == 16);
+static_assert(sizeof(CookedMapLayer) == 24);
+static_assert(sizeof(CookedMapCell) == 4);
+static_assert(sizeof(CookedClip) == 24);
+
+// One manifest line, tab separated:
+//   kind key sourceHash sourceSize sourceTime source cooked [dependency...]
+// 'key' hashes the source, its dependencies and COOKED_VERSION; the cooker
+// redoes an asset only when it changes. Sources that turned out to need no
+// cooking are listed with an empty 'cooked' so they aren't looked at again.
+struct ManifestRecord {
+  CookedKind kind{};
+  std::uint64_t key{};
+  std::uint64_t sourceHash{};
+  std::int64_t sourceSize{};
+  std::int64_t sourceTime{};  // raw file_time ticks
+  std::string source;
+  std::string cooked;
+  std::vector<std::string> dependencies;
+};
+
+namespace CookedManifest {
+
+// False for comments, blank lines and malformed lines
+bool Parse(std::string_view line, ManifestRecord& record);
+// Without the trailing newline
+std::string Format(const ManifestRecord& record);
+const char* GetKindName(CookedKind kind);
+// FNV-1a; 'seed' chains several buffers into one hash
+std::uint64_t Hash(const void* data, std::size_t size,
+                   std::uint64_t seed = 14695981039346656037ull);
+
+}  // namespace CookedManifest
+
+// Which sources have a cooked version. Load the manifest once at startup,
+// after AssetFiles::Mount; loaders then ask Find for the cooked path and
+// fall back to the source when there is none. Development builds also skip
+// entries whose loose source changed since it was cooked, so edits show up
+// without re-running the cooker.
+class CookedAssets {
+ public:
+  // False (and sources only) if there is no manifest
+  static bool Load(const std::string& manifestPath);
+  static void Clear();
+  static int GetEntryCount();
+
+  // Cooked path for 'source', or null
+  static const std::string* Find(std::string_view source, CookedKind kind);
+  // Loads 'source' itself from now on, e.g. once it was edited while the
+  // game runs. Not thread-safe with Find: only while nothing else loads.
+  static void Forget(std::string_view source);
+
+  // The cooked texture when there is one, else the source image
+  static bool LoadTexture(sf::Texture& texture, const std::string& path);
+  // Same, decoded into memory only, so safe off the main thread
+  static bool LoadImage(sf::Image& image, const std::string& path);
+};
@@ -6,12 +6,20 @@
 #include <gsl/assert>
 #include <gsl/narrow>
 
+#include "PhysicsUnits.hh"
+
 class DrawPhysics : public b2Draw {
  private:
-  sf::RenderWindow* window{};
+  sf::RenderTarget* target{};
+  // Reused by every polygon so debug drawing doesn't allocate per shape
+  sf::ConvexShape polygon;
+
+  // Loads 'vertices', in pixels, into polygon
+  sf::ConvexShape& BuildPolygon(const b2Vec2* vertices, int32 vertexCount);
 
  public:
-  DrawPhysics(sf::RenderWindow* window);
+  // A null target turns every draw into a no-op (headless runs)
+  explicit DrawPhysics(sf::RenderTarget* target);
   ~DrawPhysics();
 
   /// Convert Box2D's OpenGL style color definition[0-1] to SFML's color
@@ -27,10 +35,11 @@ class DrawPhysics : public b2Draw {
   }
 
   /// Convert Box2D's vector to SFML vector [Default - scales the vector up by
-  /// SCALE constants amount]
+  /// PhysicsUnits pixels per meter]
   static sf::Vector2f B2VecToSFVec(const b2Vec2& vector,
                                    bool scaleToPixels = true) {
-    return sf::Vector2f(vector.x, vector.y);
+    return scaleToPixels ? PhysicsUnits::ToPixels(vector)
+                         : sf::Vector2f(vector.x, vector.y);
   }
 
   /// Draw a closed polygon provided in CCW order.
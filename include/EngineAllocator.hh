@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Subsystems whose heap usage is reported separately in the debug stats.
+enum class MemoryTag : std::uint8_t {
+  General,
+  Physics,
+  Audio,
+  Animation,
+  Assets,
+  Scratch,  // FrameArena chunks
+  Count
+};
+
+struct MemorySnapshot {
+  std::int64_t currentBytes{};
+  std::int64_t peakBytes{};
+  std::int64_t allocations{};
+  std::int64_t frees{};
+};
+
+// Tagged malloc/free used by engine subsystems and third-party allocation
+// hooks (see b2_user_settings.h). Each block carries a small header with its
+// size and tag so Free can account without the caller passing them back.
+// Only standard headers are included here because Box2D's sources include
+// this file when built with B2_USER_SETTINGS.
+class EngineAllocator {
+ public:
+  static void* Allocate(std::size_t size, MemoryTag tag);
+  static void Free(void* memory);
+
+  static MemorySnapshot GetSnapshot(MemoryTag tag);
+  static const char* GetTagName(MemoryTag tag);
+};
@@ -2,14 +2,17 @@
 #include "Components/Component.hh"
 #include "Components/SpriteComponent.hh"
 #include "Components/TransformComponent.hh"
+#include "InputSystem.hh"
 
 class FlipSprite : public Component {
  private:
+  const InputSystem& input;
+  InputAxisId moveX{INVALID_INPUT_ID};
   SpriteComponent* spriteComponent;
   TransformComponent* transform;
 
  public:
-  FlipSprite();
+  explicit FlipSprite(const InputSystem& input);
   ~FlipSprite();
   void Initialize() override;
   void Update(float& deltaTime) override;
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+
+// Bump allocator for scratch memory that only lives until the end of the
+// frame. Allocation is a pointer bump; deallocation does nothing, and the
+// whole arena is released at once by Reset. A std::pmr::memory_resource, so
+// standard containers can use it:
+//
+//   std::pmr::vector<Entity*> visible{&FrameArena::ForThread()};
+//
+// Memory comes from EngineAllocator under MemoryTag::Scratch in chunks. A
+// frame that outgrows the arena chains another chunk; the next Reset merges
+// them into one, so after the first heavy frames the arena stops touching
+// the heap. Not thread-safe: use one arena per thread (ForThread).
+class FrameArena final : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t DEFAULT_CAPACITY{256 * 1024};
+
+ private:
+  struct Chunk {
+    Chunk* previous;
+    std::size_t size;  // including this header
+  };
+
+  std::size_t initialCapacity;
+  Chunk* head{};  // chunk being allocated from; null until first use
+  std::byte* cursor{};
+  std::byte* end{};
+  std::size_t capacity{};      // all chunks
+  std::size_t retiredBytes{};  // used in chunks before head
+  std::size_t highWaterBytes{};
+  std::int64_t overflows{};
+  std::uint64_t epoch{};  // FrameArena::EndFrame count at the last Reset
+
+  void Grow(std::size_t minBytes);
+  void FreeChunks();
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+ public:
+  explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY);
+  ~FrameArena() override;
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // Uninitialized storage for 'count' objects; never destroyed, hence the
+  // restriction to trivially destructible types
+  template <typename T>
+  T* AllocateArray(std::size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>);
+    return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Invalidates everything allocated since the last Reset
+  void Reset();
+
+  std::size_t GetUsedBytes() const;
+  std::size_t GetCapacity() const;
+  // Most bytes used between two Resets
+  std::size_t GetHighWaterBytes() const;
+  // Chunks added because a frame didn't fit
+  std::int64_t GetOverflowCount() const;
+
+  // The calling thread's arena, reset first if a frame ended since this
+  // thread last used it. Scratch memory from it must not be kept past
+  // EndFrame.
+  static FrameArena& ForThread();
+  // Ends the frame for every thread's arena. Call once per frame on the
+  // main thread, when no job is running.
+  static void EndFrame();
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+struct FramePacerSettings {
+  float targetRate{60.f};     // frames per second; 0 = uncapped
+  bool vsync{};               // let the driver pace instead (see FramePacer)
+  float backgroundRate{10.f};  // cap while unfocused or minimized; 0 = none
+};
+
+struct FramePacerStats {
+  // Frame-to-frame deviation from the target period (the running mean under
+  // vsync or uncapped), in buckets bounded by JITTER_BUCKET_EDGES_MS
+  static constexpr std::size_t JITTER_BUCKETS{8};
+  static constexpr std::array<float, JITTER_BUCKETS - 1> JITTER_BUCKET_EDGES_MS{
+      0.1f, 0.25f, 0.5f, 1.f, 2.f, 4.f, 8.f};
+
+  std::array<std::int64_t, JITTER_BUCKETS> jitterHistogram{};
+  std::int64_t frames{};
+  std::int64_t missedDeadlines{};  // frames whose work ran past the deadline
+  float lastFrameMs{};
+  float meanFrameMs{};
+  float spinMarginMs{};  // how early sleeping hands over to spinning
+  bool background{};
+};
+
+// Caps the main loop to a target frame rate. Each frame has a deadline one
+// period after the previous one; EndFrame sleeps until shortly before it and
+// spins the remainder, since OS sleeps overshoot by up to a scheduler tick.
+// The spin margin follows the worst recent overshoot, so on a quiet system
+// very little time is spent spinning.
+//
+// With vsync the driver blocks in display() and the pacer only measures,
+// except in the background, where vsync is often not applied (minimized
+// windows) and the background cap is enforced instead. A frame that ends
+// after its deadline restarts the cadence from that point rather than
+// shortening the next frame to catch up.
+class FramePacer {
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  FramePacerSettings settings;
+  bool background{};
+  Clock::time_point deadline;
+  Clock::time_point lastFrame;
+  bool started{};
+  double sleepOvershootMs{};  // decaying max of measured oversleep
+  FramePacerStats stats;
+
+  double CurrentPeriodMs() const;
+  double SpinMarginMs() const;
+  void WaitUntil(Clock::time_point target);
+  void Record(double frameMs, double periodMs);
+
+ public:
+  explicit FramePacer(const FramePacerSettings& settings = {});
+
+  // Applies on the next EndFrame
+  void SetSettings(const FramePacerSettings& settings);
+  const FramePacerSettings& GetSettings() const;
+  // Unfocused or minimized windows drop to settings.backgroundRate
+  void SetBackground(bool background);
+
+  // Call once per frame after display(); blocks until the frame's deadline
+  void EndFrame();
+
+  const FramePacerStats& GetStats() const;
+  void ResetStats();
+};
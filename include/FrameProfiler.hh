@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Parts of a main-loop iteration timed by FrameProfiler
+enum class FramePhase : std::uint8_t {
+  Input,
+  Physics,
+  Entities,
+  Animation,
+  Render,
+  Ui,
+  Overlay,  // building the F4 overlay; also counted in Ui
+  Checksum,
+  Count
+};
+
+struct FramePhaseStats {
+  float lastMs{};  // time in the phase during the last completed frame
+  double totalMs{};
+  float maxMs{};           // slowest single frame
+  std::int64_t frames{};  // frames that ran the phase at all
+};
+
+// Wall time per phase of the main loop. The last frame feeds the live
+// overlay, totals and maxima feed end-of-run reports, and a short history of
+// whole frame times (EndFrame to EndFrame, so pacing waits and vsync
+// included) feeds the frame-time graph.
+//
+// Timing a phase costs two steady_clock reads; nothing allocates.
+// Single-threaded: call from the thread that runs the loop.
+class FrameProfiler {
+ public:
+  static constexpr std::size_t HISTORY_FRAMES{120};
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  static constexpr std::size_t PHASE_COUNT{
+      static_cast<std::size_t>(FramePhase::Count)};
+
+  std::array<FramePhaseStats, PHASE_COUNT> phases{};
+  std::array<double, PHASE_COUNT> currentMs{};  // this frame so far
+  std::array<bool, PHASE_COUNT> ranThisFrame{};
+  std::array<float, HISTORY_FRAMES> frameHistory{};
+  std::size_t historyNext{};  // oldest entry, overwritten next
+  std::int64_t frames{};
+  Clock::time_point lastFrameEnd;
+  // Phase being timed on this thread; Count outside of Time()
+  inline static thread_local FramePhase activePhase{FramePhase::Count};
+
+ public:
+  // Runs 'work' and charges its wall time to 'phase'. A phase may run
+  // several times per frame; the samples add up.
+  template <typename Work>
+  void Time(FramePhase phase, Work&& work) {
+    const FramePhase outer{activePhase};
+    activePhase = phase;
+    const Clock::time_point start{Clock::now()};
+    work();
+    activePhase = outer;
+    AddSample(phase, std::chrono::duration<double, std::milli>(
+                         Clock::now() - start)
+                         .count());
+  }
+  void AddSample(FramePhase phase, double ms);
+
+  // Closes the frame: publishes the per-phase times and records the time
+  // since the previous EndFrame in the history
+  void EndFrame();
+
+  const FramePhaseStats& GetPhase(FramePhase phase) const;
+  // The innermost phase Time() is running on the calling thread, or
+  // FramePhase::Count; lets AllocationTracker attribute allocations
+  static FramePhase GetActivePhase() { return activePhase; }
+  static const char* GetPhaseName(FramePhase phase);
+
+  // Ring buffer of frame times in ms; GetHistoryOffset() is the oldest
+  // entry, as ImGui::PlotLines expects for values_offset
+  const std::array<float, HISTORY_FRAMES>& GetFrameHistory() const;
+  std::size_t GetHistoryOffset() const;
+  float GetLastFrameMs() const;
+  // Mean frame time over the filled part of the history
+  float GetAverageFrameMs() const;
+  std::int64_t GetFrameCount() const;
+};
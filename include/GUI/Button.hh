@@ -1,11 +1,13 @@
 #pragma once
 #include <functional>
 #include <gsl/assert>
+#include <memory>
 #include <string>
 
 #include "Components/Component.hh"
 #include "Components/EntityManager.hh"
 #include "Components/TransformComponent.hh"
+#include "InputSystem.hh"
 
 class Button : public Component {
  private:
@@ -14,13 +16,16 @@ class Button : public Component {
   sf::Color fillColor;
   sf::Color borderColor;
   TransformComponent& transform;
+  const InputSystem& input;
+  InputActionId clickAction{INVALID_INPUT_ID};
   std::function<void()> onClickAction;
   bool clicked = false;
-  sf::Texture texture{};
+  std::shared_ptr<const sf::Texture> texture;
 
  public:
-  Button(TransformComponent& transform, float borderSize, sf::Color fillColor,
-         sf::Color borderColor, std::function<void()> onClickAction);
+  Button(TransformComponent& transform, const InputSystem& input,
+         float borderSize, sf::Color fillColor, sf::Color borderColor,
+         std::function<void()> onClickAction);
   ~Button();
   void OnClick();
   void Initialize() override;
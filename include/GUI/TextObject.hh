@@ -6,8 +6,12 @@
 #include <memory>
 #include <string>
 
+#include "AssetFiles.hh"
+
 class TextObject {
  private:
+  // Backs 'font', so declared first to be destroyed after it
+  AssetData fontData;
   sf::Font font{};
   std::unique_ptr<sf::Text> text{};
   std::string fontUrl;
@@ -15,6 +19,8 @@ class TextObject {
   sf::Color color;
   std::string textStr{};
 
+  void LoadFont();
+
  public:
   TextObject(std::string fontUrl, int size, sf::Color color,
              std::uint32_t style);
@@ -3,46 +3,122 @@
 #include <box2d/box2d.h>
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <memory>
+#include <string>
 
-#include "ContactEventManager.hh"
 #include "DrawPhysics.hh"
 #include "ImGuiManager.hh"
+#include "Log.hh"
 
 // Forward declarations to reduce header coupling
 class TextObject;
 class TileGroup;
-class EntityManager;
+class JobSystem;
+class AudioMixer;
+class MusicPlayer;
+class InputRecorder;
+class InputReplayer;
+class SimulationInstance;
+class FramePacer;
+class FrameProfiler;
+class HotReload;
+class MetricsLog;
+class TelemetryWriter;
+
+// Command-line driven run modes (see main.cpp)
+struct GameOptions {
+  std::string recordPath;  // log input per tick to this file
+  std::string replayPath;  // feed input from this file instead of devices
+  std::string metricsPath;  // append a metrics snapshot here periodically
+  bool telemetry{};         // publish per-frame stats for TelemetryViewer
+  bool allocBudget{};  // fail the run if steady-state frames call new
+  std::string logPath;  // log to this file instead of the console
+  LogLevel logLevel{LogLevel::Info};
+  bool headless{};         // no window, GL context or audio device
+  std::uint32_t ticks{};   // stop after this many ticks; 0 = no limit
+  float frameRate{};       // frame cap; 0 = GameConstants::FRAME_RATE_TARGET
+  bool vsync{};            // pace on the display instead of frameRate
+  bool hotReload{};  // reload edited assets while running (see HotReload)
+};
 
 class Game {
  private:
   std::unique_ptr<sf::RenderWindow> window;
-  std::unique_ptr<ContactEventManager> contactEventManager;
   std::unique_ptr<ImGuiManager> imguiManager;
-  std::unique_ptr<b2Vec2> gravity;
-  std::unique_ptr<b2World> world;
+  // Steps the physics cells when GameConstants::PHYSICS_PARTITIONED is set
+  std::unique_ptr<JobSystem> jobSystem;
   std::unique_ptr<DrawPhysics> drawPhysics;
+  // Caps windowed frames; replays and headless runs go as fast as they can
+  std::unique_ptr<FramePacer> framePacer;
+  // Per-phase timings for the performance overlay and headless report
+  std::unique_ptr<FrameProfiler> frameProfiler;
+  // Every GameConstants::METRICS_LOG_INTERVAL ticks when --metrics is given
+  std::unique_ptr<MetricsLog> metricsLog;
+  // Shared-memory ring of per-frame stats when --telemetry is given
+  std::unique_ptr<TelemetryWriter> telemetry;
+  // Recording and replay run on a fixed step so ticks are reproducible
+  std::unique_ptr<InputRecorder> inputRecorder;
+  std::unique_ptr<InputReplayer> inputReplayer;
+  float fixedTimeStep{};  // 0: wall-clock delta time
+  std::uint32_t tick{};
+  std::uint32_t tickLimit{};  // 0: run until the window closes
+  std::uint32_t checksumInterval{};
+  std::uint32_t checksumMismatches{};
   bool debugPhysics{};
+  bool sceneComplete{};  // see SimulationInstance::IsSceneComplete
+  // A --replay, --record or --metrics file couldn't be opened; nothing else
+  // is set up
+  bool startFailed{};
 
   // Moved from file-scope globals to class members to control lifetime
   std::unique_ptr<TextObject> textObj1;
   std::unique_ptr<sf::Clock> gameClock;
   float deltaTime{};
-  std::unique_ptr<TileGroup> tileGroup;
+  // Shared read-only with the simulation; only hotReload changes it
+  std::shared_ptr<TileGroup> tileGroup;
+  // Outlives simulation: audio listeners hold a reference to it
+  std::unique_ptr<AudioMixer> audioMixer;
+  // Streams into audioMixer, so it has to go first
+  std::unique_ptr<MusicPlayer> musicPlayer;
 
-  // Ensure this is destroyed before 'world' so Box2D world is still valid
-  // during component (RigidBodyComponent) destruction.
-  // Destruction is in reverse declaration order, so declare this AFTER 'world'.
-  std::unique_ptr<EntityManager> entityManager;
+  // Physics world, entities, animation and input. Declared after everything
+  // it references (mixer, job pool) so it is destroyed first.
+  std::unique_ptr<SimulationInstance> simulation;
+  // Watches the assets when --hot-reload is given; refers to tileGroup and
+  // simulation, so declared after them
+  std::unique_ptr<HotReload> hotReload;
 
   void Update();
   void Render();
+  // Tiles, entities, debug shapes and text; Render adds ImGui and presents
+  void RenderWorld();
   void MainLoop();
+  // Simulates tickLimit ticks without a window and prints per-phase timings
+  void HeadlessLoop();
+  // Draw calls a rendered frame would submit
+  std::size_t CountDrawCommands();
   void Destroy();
   void UpdatePhysics();
+  // Throttles the frame pacer while the window is unfocused or minimized
+  void UpdateBackground(const sf::Event& event);
+  // Feeds the next recorded tick; false once the replay is over
+  bool ReplayInput();
+  void CheckWorldState();
+  // Samples the world, asset and audio gauges and appends a log line
+  void WriteMetrics();
+  // Hands the frame just closed by frameProfiler to the telemetry ring
+  void PublishTelemetry();
+  // Prints the --alloc-budget verdict
+  void ReportAllocations() const;
 
  public:
-  Game();
+  explicit Game(const GameOptions& options = {});
   ~Game();
   void Initialize();
+  // For main: failure when a --replay, --record or --metrics file couldn't
+  // be opened, a replay diverged from its recorded checksums,
+  // --alloc-budget caught steady-state allocations, or a headless run had
+  // no complete scene
+  int GetExitCode() const;
 };
@@ -0,0 +1,15 @@
+#pragma once
+
+// Textures live on the GPU, and SFML can only upload them through a GL
+// context; without a display (build servers, CI) creating one aborts the
+// process. Headless runs switch this off before any asset is loaded:
+// components then skip texture uploads but keep all CPU-side state (sprite
+// rects, transforms, animation frames), so simulation behaves the same.
+namespace GraphicsContext {
+inline bool available{true};
+
+/// Must be set before any texture-owning object is created.
+inline void SetAvailable(bool isAvailable) { available = isAvailable; }
+
+inline bool IsAvailable() { return available; }
+}  // namespace GraphicsContext
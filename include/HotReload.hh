@@ -0,0 +1,95 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AnimationLibrary.hh"
+#include "AssetWatcher.hh"
+#include "TileGroup.hh"
+
+class SimulationInstance;
+
+struct HotReloadStats {
+  std::int64_t batches{};
+  std::int64_t textures{};
+  std::int64_t tiles{};  // map tiles rebuilt
+  std::int64_t clips{};
+  std::int64_t failures{};  // files that changed but didn't load
+  double lastLoadMs{};      // on the loader thread
+  double lastApplyMs{};     // on the main thread, inside the frame
+};
+
+// Picks up asset edits (from TileMapEditor, an image editor, by hand) while
+// the game runs, without restarting or rebuilding the world. An
+// AssetWatcher marks changed files dirty; Update, called once per frame,
+// hands them to a loader thread that decodes and parses only those files,
+// then swaps the results in on a later frame boundary:
+//   textures  re-uploaded in place through the TextureCache
+//   the map   diffed cell by cell by TileGroup::Reload
+//   clips     rewritten in the AnimationLibrary, then refreshed in the
+//             animators playing them
+// Work is bounded by what changed. One batch is in flight at a time; edits
+// made meanwhile wait for the next. Anything else (state machines, input
+// bindings, audio) still needs a restart.
+class HotReload {
+ private:
+  struct LoadedTexture {
+    std::string path;
+    sf::Image image;
+  };
+  struct LoadedClip {
+    std::string path;
+    AnimationClipSource source;
+  };
+  struct Batch {
+    // Filled on the main thread
+    std::vector<std::string> texturePaths;
+    std::vector<std::string> clipPaths;
+    bool map{};
+    // Filled by the loader
+    std::vector<LoadedTexture> textures;
+    std::vector<LoadedClip> clips;
+    std::optional<MapData> mapData;
+    int failures{};
+    double loadMs{};
+  };
+
+  TileGroup& map;
+  SimulationInstance& simulation;
+  AssetWatcher watcher;
+  std::vector<std::string> changed;  // reused by every Update
+  bool inFlight{};                   // a batch was queued, not yet applied
+  HotReloadStats stats;
+
+  std::mutex mutex;
+  std::condition_variable requestReady;
+  std::optional<Batch> request;
+  std::optional<Batch> result;
+  bool quit{};
+  std::thread loader;
+
+  void LoaderLoop();
+  void Load(Batch& batch) const;
+  void Apply(Batch& batch);
+  // Sorts what the watcher reported into a batch; false if nothing applies
+  bool Collect(Batch& batch);
+
+ public:
+  // Watches 'directory' (normally ASSETS_DIRECTORY)
+  HotReload(const std::string& directory, TileGroup& map,
+            SimulationInstance& simulation);
+  ~HotReload();
+
+  HotReload(const HotReload&) = delete;
+  HotReload& operator=(const HotReload&) = delete;
+
+  // Main thread, between frames
+  void Update();
+  bool IsWatching() const;
+  const HotReloadStats& GetStats() const;
+};
@@ -1,15 +1,32 @@
 #pragma once
 
+#include "ImGuiSfmlRenderer.hh"
 #include "SFML/Graphics.hpp"
 #include "imgui.h"
 
+class SimulationLOD;
+class SimulationInstance;
+class FrameProfiler;
+class AudioMixer;
+class MusicPlayer;
+class FramePacer;
+
 class ImGuiManager {
  private:
   bool m_showDemoWindow = false;
   bool m_showDebugInfo = false;
   bool m_showEntityInfo = false;
-  bool m_showTestWindow = true;  // Show by default for testing
+  bool m_showTestWindow = false;
+  bool m_showPerformanceOverlay = false;
   bool m_initialized = false;
+  bool m_frameStarted = false;  // NewFrame ran and Render has not yet
+  ImGuiSfmlRenderer m_renderer;
+  const SimulationLOD* m_simulationLOD = nullptr;
+  const AudioMixer* m_audioMixer = nullptr;
+  const MusicPlayer* m_musicPlayer = nullptr;
+  const FramePacer* m_framePacer = nullptr;
+  FrameProfiler* m_frameProfiler = nullptr;
+  const SimulationInstance* m_simulation = nullptr;
 
  public:
   ImGuiManager();
@@ -20,6 +37,13 @@ class ImGuiManager {
   void Update(sf::RenderWindow& window, sf::Time deltaTime);
   void Render(sf::RenderWindow& window);
   void Shutdown();
+  void SetSimulationLOD(const SimulationLOD* simulationLOD);
+  void SetAudioMixer(const AudioMixer* audioMixer);
+  void SetMusicPlayer(const MusicPlayer* musicPlayer);
+  void SetFramePacer(const FramePacer* framePacer);
+  // Also charges the overlay's own cost to FramePhase::Overlay
+  void SetFrameProfiler(FrameProfiler* frameProfiler);
+  void SetSimulation(const SimulationInstance* simulation);
 
   // Debug UI functions
   void ShowMainMenuBar();
@@ -27,12 +51,15 @@ class ImGuiManager {
   void ShowDebugInfo();
   void ShowEntityInfo();
   void ShowTestWindow();
-  void RenderTestIndicator(sf::RenderWindow& window);
+  // Corner overlay: frame-time graph, per-phase timings, world counts and
+  // engine memory. Toggled with F4.
+  void ShowPerformanceOverlay();
 
   // Getters for UI state
   bool IsDemoWindowVisible() const { return m_showDemoWindow; }
   bool IsDebugInfoVisible() const { return m_showDebugInfo; }
   bool IsEntityInfoVisible() const { return m_showEntityInfo; }
   bool IsTestWindowVisible() const { return m_showTestWindow; }
+  bool IsPerformanceOverlayVisible() const { return m_showPerformanceOverlay; }
   bool IsInitialized() const { return m_initialized; }
 };
@@ -0,0 +1,30 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "imgui.h"
+
+// Draws Dear ImGui's output through SFML, so the UI needs no OpenGL code of
+// its own. The font atlas is uploaded once by CreateFontTexture. Each frame
+// the indexed meshes are expanded into one vertex buffer that keeps its
+// capacity between frames (SFML has no indexed draws), and every ImDrawCmd
+// becomes one draw() through a view whose scissor is the command's clip
+// rectangle.
+class ImGuiSfmlRenderer {
+ private:
+  sf::Texture fontTexture;
+  std::vector<sf::Vertex> vertices;
+  std::size_t drawCalls{};
+
+ public:
+  // Rasterizes the fonts in io.Fonts and points the atlas at the texture.
+  // Needs a current ImGui context and GL context.
+  bool CreateFontTexture();
+
+  // Draws on top of whatever is in 'target'; its view is restored afterwards
+  void RenderDrawData(sf::RenderTarget& target, const ImDrawData& drawData);
+
+  // draw() calls issued by the last RenderDrawData
+  std::size_t GetDrawCallCount() const;
+};
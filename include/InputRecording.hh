@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "InputSystem.hh"
+
+// Binary input log for deterministic replays. Little-endian throughout:
+//
+//   header   "BEIR", u16 version, f32 fixed step, u32 checksum interval
+//   record   u8 type, u32 tick, payload
+//     Input     key down/pressed/released bitsets, mouse button
+//               down/pressed/released, i32 mouse x, y
+//     Checksum  u64 world state hash after the tick
+//     End       (no payload) tick = number of ticks recorded
+//
+// Input records are only written on ticks whose device state differs from
+// the previous tick, so idle stretches cost nothing.
+class InputRecorder {
+ private:
+  std::ofstream out;
+  InputSnapshot previous;
+  bool hasPrevious{};
+  std::uint32_t tickCount{};
+
+ public:
+  ~InputRecorder();
+
+  // Returns false (and logs) if path can't be written
+  bool Open(const std::string& path, float fixedStep,
+            std::uint32_t checksumInterval);
+  void WriteFrame(std::uint32_t tick, const InputSnapshot& snapshot);
+  void WriteChecksum(std::uint32_t tick, std::uint64_t checksum);
+  // Writes the End record; also done by the destructor
+  void Close();
+};
+
+class InputReplayer : public InputSource {
+ private:
+  std::ifstream in;
+  float fixedStep{};
+  std::uint32_t checksumInterval{};
+  InputSnapshot state;
+  // Next unread record, peeked ahead of the tick being replayed
+  std::uint8_t nextType{};
+  std::uint32_t nextTick{};
+  std::optional<std::uint64_t> expectedChecksum;
+
+  bool ReadRecordHeader();
+
+ public:
+  // Reads the header; false (and logs) if path isn't an input recording
+  bool Open(const std::string& path);
+
+  // Returns false once every recorded tick has been replayed
+  bool ReadFrame(std::uint32_t tick, InputSnapshot& frameState) override;
+  // Checksum recorded after the tick last passed to ReadFrame, if any
+  std::optional<std::uint64_t> GetExpectedChecksum() const;
+
+  float GetFixedStep() const;
+  std::uint32_t GetChecksumInterval() const;
+};
@@ -1,30 +1,111 @@
+#pragma once
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
 
+// Actions and axes are addressed by index, resolved once by name
+using InputActionId = std::uint16_t;
+using InputAxisId = std::uint16_t;
+constexpr std::uint16_t INVALID_INPUT_ID{0xFFFF};
+
+// Everything gameplay may know about input for one frame. Built once after
+// the frame's events are processed and read-only afterwards, so every
+// component sees the same state and none of them queries the OS.
+struct InputSnapshot {
+  static constexpr std::size_t MAX_ACTIONS{32};
+  static constexpr std::size_t MAX_AXES{16};
+
+  std::uint64_t frame{};
+  std::bitset<sf::Keyboard::KeyCount> keysDown;
+  std::bitset<sf::Keyboard::KeyCount> keysPressed;   // went down this frame
+  std::bitset<sf::Keyboard::KeyCount> keysReleased;  // went up this frame
+  std::bitset<sf::Mouse::ButtonCount> mouseDown;
+  std::bitset<sf::Mouse::ButtonCount> mousePressed;
+  std::bitset<sf::Mouse::ButtonCount> mouseReleased;
+  sf::Vector2i mousePosition;  // window pixels
+  std::bitset<MAX_ACTIONS> actionsDown;
+  std::bitset<MAX_ACTIONS> actionsPressed;
+  std::bitset<MAX_ACTIONS> actionsReleased;
+  std::array<float, MAX_AXES> axes{};
+
+  bool IsKeyDown(sf::Keyboard::Key key) const;
+  bool WasKeyPressed(sf::Keyboard::Key key) const;
+  bool WasKeyReleased(sf::Keyboard::Key key) const;
+  bool IsMouseDown(sf::Mouse::Button button) const;
+  bool WasMousePressed(sf::Mouse::Button button) const;
+  bool WasMouseReleased(sf::Mouse::Button button) const;
+  // Unknown ids (INVALID_INPUT_ID) read as released / zero
+  bool IsActionDown(InputActionId action) const;
+  bool WasActionPressed(InputActionId action) const;
+  bool WasActionReleased(InputActionId action) const;
+  float GetAxis(InputAxisId axis) const;
+};
+
+// Device state that doesn't come from window events: a recording, a bot, a
+// test script. Feed it to an InputSystem with OverrideDeviceState.
+class InputSource {
+ public:
+  virtual ~InputSource() = default;
+  // Keys, mouse buttons, edges and mouse position for tick, which increases
+  // by one per call. Returns false once the source has nothing more to play.
+  virtual bool ReadFrame(std::uint32_t tick, InputSnapshot& frameState) = 0;
+};
+
+// Turns window events into one InputSnapshot per frame and maps named
+// actions and axes onto keys and mouse buttons from a JSON file:
+//
+// {
+//   "actions": { "click": ["MouseLeft"], "pause": ["Escape", "P"] },
+//   "axes": {
+//     "moveX": { "positive": ["D", "Right"], "negative": ["A", "Left"] }
+//   }
+// }
+//
+// Key names are the sf::Keyboard::Key enumerator names ("A", "Num1", "F5",
+// "LShift", "Space", ...); mouse buttons are "MouseLeft", "MouseRight",
+// "MouseMiddle". An axis is the sum of its held positive (+1) and negative
+// (-1) inputs, clamped to [-1, 1].
+//
+// Per frame: BeginFrame(), ProcessEvent() for each polled event, EndFrame().
 class InputSystem {
+ private:
+  struct Binding {
+    bool mouse{};
+    int code{};
+  };
+  struct Axis {
+    std::vector<Binding> positive;
+    std::vector<Binding> negative;
+  };
+
+  std::vector<std::string> actionNames;
+  std::vector<std::vector<Binding>> actions;
+  std::vector<std::string> axisNames;
+  std::vector<Axis> axes;
+
+  InputSnapshot pending;   // accumulates the current frame's events
+  InputSnapshot snapshot;  // last completed frame
+
+  bool IsDown(const Binding& binding) const;
+  bool WasPressed(const Binding& binding) const;
+  bool WasReleased(const Binding& binding) const;
+  void ReleaseAll();
+
  public:
-  InputSystem() {}
-  ~InputSystem() {}
-
-  static sf::Vector2f Axis() {
-    sf::Vector2f axis{};
-
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) {
-      axis.x = 1;
-    }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) {
-      axis.x = -1;
-    }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W)) {
-      axis.y = -1;
-    }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S)) {
-      axis.y = 1;
-    }
-
-    return axis;
-  }
+  // Replaces the current bindings; returns false (and logs) on bad files
+  bool LoadBindings(const std::string& path);
+
+  void BeginFrame();
+  void ProcessEvent(const sf::Event& event);
+  void EndFrame();
+  // Replaces this frame's keys, mouse buttons, edges and mouse position
+  // (e.g. from an InputReplayer); actions and axes still resolve in EndFrame
+  void OverrideDeviceState(const InputSnapshot& state);
+
+  const InputSnapshot& GetSnapshot() const;
+  InputActionId FindAction(const std::string& name) const;
+  InputAxisId FindAxis(const std::string& name) const;
 };
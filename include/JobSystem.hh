@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads for data-parallel engine work. ParallelFor
+// blocks until every index has run; the calling thread takes part, so a pool
+// with zero workers simply runs inline. Calls made from inside a job run
+// inline as well, which keeps nested use (a parallel system stepped by a
+// parallel batch) deadlock free.
+class JobSystem {
+ private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wakeWorkers;
+  std::condition_variable batchDone;
+  const std::function<void(std::size_t)>* job{};
+  std::size_t jobCount{};
+  std::atomic<std::size_t> nextIndex{};
+  std::size_t busyWorkers{};
+  std::uint64_t generation{};
+  bool stopping{false};
+
+  void WorkerLoop();
+  void RunIndices();
+
+ public:
+  explicit JobSystem(unsigned workerCount = DefaultWorkerCount());
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // Runs fn(i) for i in [0, count). Not reentrant across threads: one batch
+  // at a time per JobSystem.
+  void ParallelFor(std::size_t count,
+                   const std::function<void(std::size_t)>& fn);
+  unsigned GetWorkerCount() const;
+
+  // hardware_concurrency - 1, leaving the calling thread its own core
+  static unsigned DefaultWorkerCount();
+};
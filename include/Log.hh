@@ -0,0 +1,169 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+enum class LogLevel : std::uint8_t { Trace, Debug, Info, Warning, Error, Off };
+
+enum class LogCategory : std::uint8_t {
+  General,
+  Physics,
+  Animation,
+  Audio,
+  Assets,
+  Input,
+  Count
+};
+
+// Log calls below this level compile to nothing, arguments included.
+// Override with -DBEP_LOG_MIN_LEVEL=<0..5> (see LogLevel).
+#ifndef BEP_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define BEP_LOG_MIN_LEVEL 2  // Info
+#else
+#define BEP_LOG_MIN_LEVEL 1  // Debug
+#endif
+#endif
+
+// One log call with its arguments captured by value, formatted later on the
+// sink thread. Strings are copied into 'text' and cut short if they don't
+// fit; the format string must be a literal, since only its address is kept.
+struct LogRecord {
+  static constexpr std::size_t MAX_ARGS{8};
+  static constexpr std::size_t TEXT_BYTES{192};
+
+  enum class ArgType : std::uint8_t { Int, UInt, Double, Bool, Char, Text };
+  struct TextSpan {
+    std::uint16_t offset;
+    std::uint16_t length;
+  };
+  union ArgValue {
+    std::int64_t i;
+    std::uint64_t u;
+    double d;
+    TextSpan text;
+  };
+
+  // Left uninitialized: a record is filled on every log call
+  std::int64_t microseconds;  // since the log started
+  const char* format;
+  LogLevel level;
+  LogCategory category;
+  std::uint8_t argCount;
+  std::uint16_t textUsed;
+  std::array<ArgType, MAX_ARGS> types;
+  std::array<ArgValue, MAX_ARGS> values;
+  std::array<char, TEXT_BYTES> text;
+
+  void Begin(LogLevel logLevel, LogCategory logCategory, const char* fmt) {
+    format = fmt;
+    level = logLevel;
+    category = logCategory;
+    argCount = 0;
+    textUsed = 0;
+  }
+
+  template <typename T>
+  void Capture(const T& value) {
+    using Value = std::decay_t<T>;
+    if constexpr (std::is_same_v<Value, bool>) {
+      Push(ArgType::Bool).u = value;
+    } else if constexpr (std::is_same_v<Value, char>) {
+      Push(ArgType::Char).u = static_cast<unsigned char>(value);
+    } else if constexpr (std::is_enum_v<Value>) {
+      Push(ArgType::Int).i = static_cast<std::int64_t>(value);
+    } else if constexpr (std::is_integral_v<Value> &&
+                         std::is_signed_v<Value>) {
+      Push(ArgType::Int).i = value;
+    } else if constexpr (std::is_integral_v<Value>) {
+      Push(ArgType::UInt).u = value;
+    } else if constexpr (std::is_floating_point_v<Value>) {
+      Push(ArgType::Double).d = value;
+    } else if constexpr (std::is_same_v<Value, const char*> ||
+                         std::is_same_v<Value, char*>) {
+      CaptureText(value ? std::string_view(value) : "(null)");
+    } else {
+      static_assert(std::is_convertible_v<const T&, std::string_view>,
+                    "Log arguments must be numbers, chars or strings");
+      CaptureText(std::string_view(value));
+    }
+  }
+
+ private:
+  ArgValue& Push(ArgType type) {
+    types[argCount] = type;
+    return values[argCount++];
+  }
+  void CaptureText(std::string_view value);
+};
+
+struct LogSettings {
+  std::string path;  // append to this file; empty: stdout, stderr for warnings
+  LogLevel level{LogLevel::Info};
+  std::size_t queueCapacity{4096};  // records; more are dropped and counted
+};
+
+// Leveled, categorized logging that keeps I/O off the calling thread. A log
+// call captures its arguments into a LogRecord and pushes it onto a lock-free
+// queue; a sink thread formats and writes the records and flushes once per
+// batch. Calls never block or allocate: with the queue full the record is
+// dropped and counted. Before Start and after Stop, calls are formatted and
+// written on the calling thread instead.
+//
+// Use the BEP_LOG_* macros, which skip argument evaluation for levels
+// disabled at compile time (BEP_LOG_MIN_LEVEL) or at run time (SetLevel).
+// The format string takes "{}" for each argument:
+//
+//   BEP_LOG_WARNING(LogCategory::Audio, "No voice for '{}' ({} busy)", path,
+//                   busy);
+class Log {
+ public:
+  static void Start(const LogSettings& settings);
+  // Writes everything queued, then stops the sink thread
+  static void Stop();
+
+  static void SetLevel(LogLevel level);
+  static void SetLevel(LogCategory category, LogLevel level);
+  static bool IsEnabled(LogLevel level, LogCategory category);
+  // Records lost to a full queue
+  static std::uint64_t GetDropped();
+
+  template <typename... Args>
+  static void Write(LogLevel level, LogCategory category, const char* format,
+                    const Args&... args) {
+    static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS);
+    LogRecord record;
+    record.Begin(level, category, format);
+    (record.Capture(args), ...);
+    Submit(record);
+  }
+
+  static const char* GetLevelName(LogLevel level);
+  static const char* GetCategoryName(LogCategory category);
+
+ private:
+  static void Submit(LogRecord& record);
+};
+
+#define BEP_LOG(level, category, ...)                               \
+  do {                                                              \
+    if constexpr (static_cast<int>(level) >= BEP_LOG_MIN_LEVEL) {   \
+      if (Log::IsEnabled(level, category)) {                        \
+        Log::Write(level, category, __VA_ARGS__);                   \
+      }                                                             \
+    }                                                               \
+  } while (false)
+
+#define BEP_LOG_TRACE(category, ...) \
+  BEP_LOG(LogLevel::Trace, category, __VA_ARGS__)
+#define BEP_LOG_DEBUG(category, ...) \
+  BEP_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#define BEP_LOG_INFO(category, ...) \
+  BEP_LOG(LogLevel::Info, category, __VA_ARGS__)
+#define BEP_LOG_WARNING(category, ...) \
+  BEP_LOG(LogLevel::Warning, category, __VA_ARGS__)
+#define BEP_LOG_ERROR(category, ...) \
+  BEP_LOG(LogLevel::Error, category, __VA_ARGS__)
@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Monotonic count of events or amounts
+class MetricCounter {
+ private:
+  std::atomic<std::int64_t> value{};
+
+ public:
+  void Add(std::int64_t amount = 1) {
+    value.fetch_add(amount, std::memory_order_relaxed);
+  }
+  std::int64_t Get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Most recently sampled level (bodies, voices, resident bytes)
+class MetricGauge {
+ private:
+  std::atomic<double> value{};
+
+ public:
+  void Set(double level) { value.store(level, std::memory_order_relaxed); }
+  double Get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Distribution over upper bucket edges fixed at registration; values above
+// the last edge land in an overflow bucket
+class MetricHistogram {
+ public:
+  static constexpr std::size_t MAX_BUCKETS{16};
+
+ private:
+  std::array<double, MAX_BUCKETS - 1> edges{};
+  std::size_t edgeCount{};
+  std::array<std::atomic<std::int64_t>, MAX_BUCKETS> buckets{};
+  std::atomic<std::int64_t> count{};
+  std::atomic<double> sum{};
+
+ public:
+  // Edges must be ascending; at most MAX_BUCKETS - 1 of them
+  explicit MetricHistogram(std::span<const double> upperEdges);
+
+  void Observe(double value);
+
+  std::span<const double> GetEdges() const;
+  // edgeCount + 1 entries, the last one the overflow bucket
+  std::int64_t GetBucket(std::size_t bucket) const;
+  std::int64_t GetCount() const;
+  double GetSum() const;
+};
+
+// Process-wide registry of named metrics. Register once at startup and keep
+// the returned reference: updates are then a single relaxed atomic, safe
+// from any thread, while registration takes a lock. Registering a name
+// again returns the existing metric, so every SimulationInstance in a batch
+// feeds the same counters and histograms.
+//
+// Names are dotted identifiers ("physics.step_ms") and are written to JSON
+// unescaped.
+class Metrics {
+ public:
+  static MetricCounter& RegisterCounter(std::string_view name);
+  static MetricGauge& RegisterGauge(std::string_view name);
+  static MetricHistogram& RegisterHistogram(std::string_view name,
+                                            std::span<const double> upperEdges);
+
+  // {"counters":{...},"gauges":{...},"histograms":{name:{"edges":[...],
+  // "buckets":[...],"count":n,"sum":x}}}, on one line
+  static void WriteJson(std::ostream& out);
+};
+
+// Appends a snapshot of every metric to a JSON Lines file, one object per
+// Write, for offline analysis. Each line is flushed so a crashed run keeps
+// what it logged.
+class MetricsLog {
+ private:
+  std::ofstream file;
+  std::chrono::steady_clock::time_point opened;
+
+ public:
+  // Truncates the file; logs and returns false if it can't be created
+  bool Open(const std::string& path);
+  // {"tick":N,"seconds":wall time since Open,"metrics":{...}}
+  void Write(std::uint32_t tick);
+};
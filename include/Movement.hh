@@ -1,17 +1,21 @@
 #pragma once
 #include "AudioClip.hh"
-#include "Components/AnimatorComponent.hh"
+#include "Components/AnimationStateMachineComponent.hh"
 #include "Components/AudioListenerComponent.hh"
 #include "Components/Component.hh"
 #include "Components/RigidBodyComponent.hh"
 #include "Components/SpriteComponent.hh"
 #include "Components/TransformComponent.hh"
+#include "InputSystem.hh"
 
 class Movement : public Component {
  private:
+  const InputSystem& input;
+  InputAxisId moveX{INVALID_INPUT_ID};
+  InputAxisId moveY{INVALID_INPUT_ID};
   float moveSpeed;
   RigidBodyComponent* rigidbody{};
-  AnimatorComponent* animator{};
+  AnimationStateMachineComponent* animationStates{};
   TransformComponent* transform{};
   SpriteComponent* sprite{};
   AudioListenerComponent* audioListener{};  // optional
@@ -21,8 +25,12 @@ class Movement : public Component {
   float stepsTimer{};
   float stepsDelay{};
 
+  AnimationStateMachine::Index speedParameter{
+      AnimationStateMachine::INVALID_INDEX};
+
  public:
-  Movement(float moveSpeed, float stepsDelay, AudioClip stepsAudio);
+  Movement(const InputSystem& input, float moveSpeed, float stepsDelay,
+           AudioClip stepsAudio);
   ~Movement();
   void Initialize() override;
   void Update(float& deltaTime) override;
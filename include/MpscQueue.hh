@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Bounded lock-free queue for many producers and one consumer. Each cell
+// carries a sequence number that tells producers whether it is free and
+// the consumer whether it has been filled (Vyukov's bounded queue with the
+// consumer side simplified). Producers never wait: TryPush fails when the
+// queue is full. Storage is allocated once, in the constructor.
+template <typename T>
+class MpscQueue {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Cell[]> cells;
+  std::size_t mask;
+  alignas(64) std::atomic<std::size_t> enqueuePos{};
+  alignas(64) std::size_t dequeuePos{};  // consumer only
+
+ public:
+  // 'capacity' is rounded up to a power of two
+  explicit MpscQueue(std::size_t capacity)
+      : cells(new Cell[std::bit_ceil(capacity)]),
+        mask(std::bit_ceil(capacity) - 1) {
+    for (std::size_t i{}; i <= mask; ++i) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Any thread. False if the queue is full.
+  bool TryPush(const T& value) {
+    std::size_t pos{enqueuePos.load(std::memory_order_relaxed)};
+    Cell* cell;
+    while (true) {
+      cell = &cells[pos & mask];
+      const std::size_t sequence{
+          cell->sequence.load(std::memory_order_acquire)};
+      const auto diff{static_cast<std::intptr_t>(sequence) -
+                      static_cast<std::intptr_t>(pos)};
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // the consumer hasn't freed this cell yet
+      } else {
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread only. False if nothing is ready.
+  bool TryPop(T& value) {
+    Cell& cell{cells[dequeuePos & mask]};
+    if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+      return false;
+    }
+    value = cell.value;
+    cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+  }
+
+  std::size_t GetCapacity() const { return mask + 1; }
+};
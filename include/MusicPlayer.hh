@@ -0,0 +1,120 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AssetFiles.hh"
+#include "AudioMixer.hh"
+#include "SFML/Audio.hpp"
+
+struct MusicStats {
+  std::string track;          // last requested track, empty when stopped
+  float bufferedSeconds{};    // decoded ahead for the current track
+  std::int64_t underruns{};   // chunks the decoder didn't keep up with
+  std::int64_t residentBytes{};
+};
+
+// Streams music from disk into the mixer's music bus. A decoder thread reads
+// small blocks with sf::InputSoundFile, resamples them to the mixer rate and
+// keeps a fixed prefetch ring per deck full; the audio thread only reads
+// from the rings. Memory stays bounded by the rings no matter how long the
+// track is.
+//
+// Two decks allow crossfades: Play opens the new track on the idle deck,
+// prefetches it, then fades it in while the previous one fades out. Looping
+// seeks back to the start inside the decoder, so the seam has no gap.
+//
+// Play and Stop are meant to be called from the game thread.
+class MusicPlayer : public AudioMixerSource {
+ public:
+  static constexpr std::size_t RING_FRAMES{32768};  // ~0.74 s, power of two
+  static constexpr std::size_t DECODE_FRAMES{4096};
+
+ private:
+  // Idle decks belong to the decoder thread; Playing ones are shared with
+  // the audio thread, which hands them back once silent or drained
+  enum class DeckState : std::uint8_t { Idle, Playing };
+
+  struct Deck {
+    std::atomic<DeckState> state{DeckState::Idle};
+
+    // Decoder thread. 'file' streams from disk for loose tracks, or out of
+    // 'source' for packed ones.
+    AssetData source;
+    // Heap bytes 'source' holds (a decompressed pack entry), for GetStats
+    std::atomic<std::int64_t> sourceBytes{};
+    sf::InputSoundFile file;
+    unsigned channels{};
+    bool loop{};
+    double step{};   // source frames per output frame
+    double phase{};  // output position past 'previous', in source frames
+    float previous[2]{};
+    bool primed{};
+
+    // Ring of resampled stereo frames: the decoder advances writeIndex, the
+    // audio thread readIndex; both only ever grow
+    std::vector<float> left;
+    std::vector<float> right;
+    std::atomic<std::size_t> writeIndex{};
+    std::atomic<std::size_t> readIndex{};
+    std::atomic<bool> endOfStream{};
+
+    // Fade, set by the decoder thread and applied per frame on the audio
+    // thread. gain itself belongs to whichever side owns the deck's state.
+    float gain{};
+    std::atomic<float> targetGain{};
+    std::atomic<float> fadeStep{};  // gain change per output frame
+  };
+
+  struct Request {
+    std::string path;
+    float fadeSeconds{};
+    bool loop{};
+    bool stop{};
+  };
+
+  AudioMixer& mixer;
+  std::array<Deck, 2> decks;
+  int primary{-1};  // deck of the latest track, decoder thread only
+  std::vector<std::int16_t> decodeBuffer;
+
+  mutable std::mutex requestMutex;
+  std::condition_variable requestReady;
+  std::optional<Request> request;  // the latest request replaces older ones
+  std::string track;
+  bool quit{};
+  std::atomic<std::int64_t> underruns{};
+  std::thread decoder;
+
+  void DecoderLoop();
+  // Returns false if the request has to wait for a deck to drain
+  bool Start(const Request& next);
+  bool Open(Deck& deck, const Request& next);
+  void Fill(Deck& deck);
+  void FadeOut(Deck& deck, float fadeSeconds);
+
+ public:
+  // Registers itself as a source on the mixer's music bus
+  explicit MusicPlayer(AudioMixer& mixer);
+  ~MusicPlayer();
+
+  MusicPlayer(const MusicPlayer&) = delete;
+  MusicPlayer& operator=(const MusicPlayer&) = delete;
+
+  // Crossfades from the current track over fadeSeconds (0 cuts)
+  void Play(const std::string& path, float fadeSeconds = 1.f,
+            bool loop = true);
+  void Stop(float fadeSeconds = 1.f);
+
+  // Audio thread
+  void Mix(float* left, float* right, std::size_t frames,
+           float gain) override;
+
+  MusicStats GetStats() const;
+};
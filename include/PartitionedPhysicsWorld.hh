@@ -0,0 +1,150 @@
+#pragma once
+#include <box2d/box2d.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.hh"
+
+// Contact begin/end between two bodies, identified by their b2Body user data
+// (the owning Entity* for engine bodies).
+struct PhysicsContactEvent {
+  enum class Type : std::uint8_t { Begin, End };
+  Type type{};
+  std::uintptr_t userDataA{};
+  std::uintptr_t userDataB{};
+};
+
+// Optional region-partitioned physics for large maps. The world is split into
+// square cells that each own a b2World and are stepped concurrently on the
+// JobSystem. A body lives in the cell containing its center and is handed
+// off (recreated) when it crosses a border. Bodies within ghostMargin of a
+// neighbouring cell get a proxy there: kinematic for moving bodies, static
+// for static ones, so contacts across seams are still found. Contact events
+// from all cells are merged into one deduplicated stream per Step.
+//
+// Seam collisions are one-sided. A kinematic proxy has infinite mass and
+// never reports back to the body it mirrors, so a dynamic body pushing
+// into a moving body's proxy is shoved away while the owner feels nothing.
+// Contacts between two dynamic bodies therefore resolve differently near a
+// seam than in one b2World, and replays are only deterministic against the
+// same partitioning. Collisions with static geometry are unaffected.
+//
+// Bodies are addressed by BodyId because handoff replaces the b2Body; resolve
+// with GetBody() each time instead of caching the pointer. Static bodies are
+// expected to stay where they were created.
+class PartitionedPhysicsWorld {
+ public:
+  using BodyId = std::uint32_t;
+  static constexpr BodyId INVALID_BODY{~BodyId{}};
+
+ private:
+  class CellContactListener : public b2ContactListener {
+   public:
+    std::vector<PhysicsContactEvent> events;
+    void BeginContact(b2Contact* contact) override;
+    void EndContact(b2Contact* contact) override;
+  };
+
+  struct Cell {
+    std::unique_ptr<b2World> world;
+    CellContactListener listener;
+  };
+
+  struct Ghost {
+    int cell{};
+    b2Body* body{};
+  };
+
+  struct BodyRecord {
+    b2Body* body{};
+    int cell{-1};
+    bool ghostsDirty{true};
+    std::vector<Ghost> ghosts;
+  };
+
+  struct PairKey {
+    std::uintptr_t a{};
+    std::uintptr_t b{};
+    bool operator==(const PairKey& other) const {
+      return a == other.a && b == other.b;
+    }
+  };
+
+  struct PairKeyHash {
+    std::size_t operator()(const PairKey& key) const {
+      return std::hash<std::uintptr_t>{}(key.a) * 31u ^
+             std::hash<std::uintptr_t>{}(key.b);
+    }
+  };
+
+  struct PairState {
+    PhysicsContactEvent first{};  // keeps the A/B order of the first report
+    int touching{};
+    int batchStart{};
+    bool inBatch{};
+    bool peaked{};
+    bool pendingEnd{};
+  };
+
+  JobSystem& jobs;
+  b2Vec2 origin{};
+  float cellSize{};
+  float ghostMargin{};
+  int cols{};
+  int rows{};
+  std::vector<Cell> cells;
+  std::vector<BodyRecord> records;
+  std::vector<BodyId> freeIds;
+  std::unordered_map<PairKey, PairState, PairKeyHash> pairs;
+  std::vector<PairKey> batchPairs;
+  std::vector<PairKey> deferredEnds;
+  std::vector<PhysicsContactEvent> contactEvents;
+  int ghostCount{};
+
+  int CellAt(const b2Vec2& position) const;
+  b2AABB ComputeAABB(b2Body& body) const;
+  b2Body* CloneBody(b2World& target, b2Body& source, b2BodyType type) const;
+  void SyncGhosts(BodyRecord& record);
+  void DestroyGhosts(BodyRecord& record);
+  void MigrateBodies();
+  void MergeContactEvents();
+
+ public:
+  // worldSize and cellSize are in meters; bodies outside the bounds are kept
+  // in the nearest edge cell.
+  PartitionedPhysicsWorld(const b2Vec2& gravity, const b2Vec2& worldOrigin,
+                          const b2Vec2& worldSize, float cellSize,
+                          float ghostMargin, JobSystem& jobs);
+  ~PartitionedPhysicsWorld();
+
+  PartitionedPhysicsWorld(const PartitionedPhysicsWorld&) = delete;
+  PartitionedPhysicsWorld& operator=(const PartitionedPhysicsWorld&) = delete;
+
+  BodyId CreateBody(const b2BodyDef& bodyDef, const b2FixtureDef& fixtureDef);
+  void DestroyBody(BodyId id);
+  b2Body* GetBody(BodyId id) const;
+  // Disabled bodies drop their proxies and are neither stepped nor handed
+  // off until enabled again
+  void SetEnabled(BodyId id, bool enabled);
+  // Moves a body (static ones too) into the cell at 'position'
+  void SetTransform(BodyId id, const b2Vec2& position, float angle);
+
+  void Step(float timeStep, int velocityIterations, int positionIterations);
+  // Merged contact events produced by the last Step. End events arrive one
+  // Step after the contact is lost.
+  const std::vector<PhysicsContactEvent>& GetContactEvents() const;
+
+  void SetDebugDraw(b2Draw* debugDraw);
+  void DebugDraw();
+
+  int GetCellCount() const;
+  int GetBodyCount() const;
+  int GetGhostCount() const;
+  // Summed over cells, ghosts included. Profile times add up the time of
+  // cells stepped concurrently, so step can exceed the wall time of Step.
+  int GetContactCount() const;
+  b2Profile GetProfile() const;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <box2d/box2d.h>
+
+#include <SFML/System/Vector2.hpp>
+#include <gsl/assert>
+
+// Box2D is tuned for moving objects between 0.1 and 10 meters and clamps
+// per-step motion to b2_maxTranslation (2m). Game code works in pixels, so
+// every value crossing into Box2D goes through these conversions; inside the
+// solver one scaled tile (16px * 4) is one meter by default.
+namespace PhysicsUnits {
+inline float pixelsPerMeter{64.f};
+inline float metersPerPixel{1.f / 64.f};
+
+/// Must be set before any body is created; existing bodies are not rescaled.
+inline void SetPixelsPerMeter(float ppm) {
+  Expects(ppm > 0.f);
+  pixelsPerMeter = ppm;
+  metersPerPixel = 1.f / ppm;
+}
+
+inline float GetPixelsPerMeter() { return pixelsPerMeter; }
+
+inline float ToMeters(float pixels) { return pixels * metersPerPixel; }
+inline float ToPixels(float meters) { return meters * pixelsPerMeter; }
+
+inline b2Vec2 ToMeters(const sf::Vector2f& pixels) {
+  return b2Vec2(pixels.x * metersPerPixel, pixels.y * metersPerPixel);
+}
+
+inline sf::Vector2f ToPixels(const b2Vec2& meters) {
+  return sf::Vector2f(meters.x * pixelsPerMeter, meters.y * pixelsPerMeter);
+}
+}  // namespace PhysicsUnits
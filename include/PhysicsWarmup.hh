@@ -0,0 +1,27 @@
+#pragma once
+#include <box2d/box2d.h>
+
+#include <mutex>
+
+namespace PhysicsWarmup {
+
+// Box2D fills its static contact registers lazily on the first contact of any
+// world. Trigger that once on the calling thread before worlds are stepped
+// in parallel (partitioned cells, batched instances), so their first
+// contacts don't race on it. (Box2D's GJK/TOI call counters are also plain
+// globals; concurrent steps only make those statistics approximate.)
+inline void WarmContactRegisters() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    b2World scratch(b2Vec2(0.f, 0.f));
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    b2PolygonShape box;
+    box.SetAsBox(0.5f, 0.5f);
+    scratch.CreateBody(&bodyDef)->CreateFixture(&box, 1.f);
+    scratch.CreateBody(&bodyDef)->CreateFixture(&box, 1.f);
+    scratch.Step(1.f / 60.f, 1, 1);
+  });
+}
+
+}  // namespace PhysicsWarmup
@@ -0,0 +1,93 @@
+#pragma once
+#include <box2d/box2d.h>
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AnimationClip.hh"
+#include "AnimationStateMachine.hh"
+#include "AudioClip.hh"
+
+// An entity definition compiled for spawning: every asset it names is
+// already resolved (textures, clip handles, the state machine, sounds), so
+// instances only construct components. Components are added in the order
+// of the members below, which is also the order they depend on each other.
+struct Prefab {
+  struct Sprite {
+    std::shared_ptr<const sf::Texture> texture;  // never null
+    unsigned int column{};
+    unsigned int row{};
+  };
+  struct RigidBody {
+    b2BodyType type{b2_staticBody};
+    float density{};
+    float friction{};
+    float restitution{};
+    bool freezeRotation{};
+  };
+  struct Movement {
+    float speed{};
+    float stepsDelay{};  // seconds between footsteps
+    AudioClip stepsAudio;
+  };
+
+  std::string name;
+  // TransformComponent; the position comes from the spawn
+  float width{};
+  float height{};
+  float scale{1.f};
+  std::optional<Sprite> sprite;
+  std::optional<RigidBody> rigidBody;  // needs the sprite
+  // AnimatorComponent, added when there are clips or a state machine; the
+  // first clip plays
+  bool animator{};
+  std::vector<std::pair<std::string, AnimationClipHandle>> clips;
+  std::shared_ptr<const AnimationStateMachine> stateMachine;
+  // Only added where the simulation has an AudioMixer
+  bool audioListener{};
+  std::optional<Movement> movement;  // needs the state machine
+  bool flipSprite{};
+};
+
+// Prefabs compiled from a JSON file:
+//
+// {
+//   "prefabs": {
+//     "chest": {
+//       "transform": { "width": 16, "height": 16, "scale": 4 },
+//       "sprite": { "texture": "assets/sprites.png", "column": 6, "row": 1 },
+//       "rigidBody": { "type": "static", "density": 1,
+//                      "freezeRotation": true },
+//       "animations": [ { "name": "idle", "clip": "..." } ],
+//       "stateMachine": "assets/animations/player/states.json",
+//       "audioListener": true,
+//       "movement": { "speed": 200, "stepsDelay": 0.28,
+//                     "stepsAudio": "assets/audio/steps.ogg" },
+//       "flipSprite": true
+//     }
+//   }
+// }
+//
+// Only "transform" is required. "type" is "static", "dynamic" or
+// "kinematic"; clips and the state machine use the transform size as frame
+// size. Assets come from the process-wide caches, so load on the thread
+// that constructs simulations.
+class PrefabLibrary {
+ private:
+  // Stable addresses: entities and spawn pools point at them
+  std::vector<std::unique_ptr<Prefab>> prefabs;
+
+ public:
+  // Adds the prefabs in 'path'. False (and logged) if the file or a prefab
+  // in it can't be read, or a name is already taken; the valid ones are
+  // kept.
+  bool Load(const std::string& path);
+  // Null if there is no such prefab
+  const Prefab* Find(std::string_view name) const;
+  std::size_t GetCount() const;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <box2d/box2d.h>
+
+#include <SFML/Graphics.hpp>
+#include <gsl/span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "PrefabLibrary.hh"
+
+class AnimationSystem;
+class AudioMixer;
+class Entity;
+class EntityManager;
+class InputSystem;
+class PartitionedPhysicsWorld;
+
+// Instantiates prefabs into one simulation's entities. A spawn of N
+// instances makes one allocation per component type, with the N components
+// of that type constructed side by side in it; the block is freed once the
+// last of those entities is gone.
+//
+// Despawned instances are parked in a pool per prefab instead of being
+// destroyed: disabled, with their body out of the world and their
+// components still wired up. Spawning takes from the pool first and only
+// moves the entity back (velocity cleared; animation and other component
+// state carry over), so despawn/respawn cycles never construct, allocate
+// or reload anything. Destroy()ing a parked entity takes it out of its pool.
+class PrefabSpawner {
+ private:
+  const PrefabLibrary& library;
+  EntityManager& entityManager;
+  AnimationSystem& animationSystem;
+  const InputSystem& input;
+  // Exactly one of the two worlds is set
+  b2World* world{};
+  PartitionedPhysicsWorld* partitionedWorld{};
+  AudioMixer* audioMixer{};  // optional
+  std::unordered_map<const Prefab*, std::vector<Entity*>> pools;
+
+  void Instantiate(const Prefab& prefab,
+                   gsl::span<const sf::Vector2f> positions, Entity** spawned);
+  void Respawn(Entity& entity, sf::Vector2f position);
+
+ public:
+  PrefabSpawner(const PrefabLibrary& library, EntityManager& entityManager,
+                AnimationSystem& animationSystem, const InputSystem& input,
+                b2World* world, PartitionedPhysicsWorld* partitionedWorld,
+                AudioMixer* audioMixer);
+
+  PrefabSpawner(const PrefabSpawner&) = delete;
+  PrefabSpawner& operator=(const PrefabSpawner&) = delete;
+
+  // 'count' instances of 'name', the i-th at positions[i] (pixels). Returns
+  // them in the thread's FrameArena, valid until the frame ends; empty
+  // (and logged) if there is no such prefab.
+  gsl::span<Entity*> Spawn(std::string_view name, std::size_t count,
+                           gsl::span<const sf::Vector2f> positions);
+  // Parks an entity spawned by Spawn for reuse
+  void Despawn(Entity& entity);
+  // Drops a parked entity from its pool; called by Entity::Destroy
+  void Forget(Entity& entity);
+  // Instances waiting in the pool of 'name'
+  std::size_t GetPooledCount(std::string_view name) const;
+};
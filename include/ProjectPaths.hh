@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+// Locating the project's assets. Nothing here changes the working directory:
+// Game and SimulationBatch switch to the project root once during startup,
+// before any simulation exists, and asset paths are relative to it.
+namespace ProjectPaths {
+
+/// Walks up from the executable to the first folder containing "assets";
+/// falls back to the current working directory.
+std::string FindProjectRoot();
+
+/// Map the game starts on, relative to the project root: the first of the
+/// ASSETS_MAPS_JSON* constants that exists, else the newest JSON in
+/// assets/maps. Empty if there is none.
+std::string FindDefaultMap();
+
+}  // namespace ProjectPaths
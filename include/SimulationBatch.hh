@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "InputSystem.hh"
+#include "JobSystem.hh"
+#include "SimulationInstance.hh"
+
+class TileGroup;
+
+struct SimulationBatchStats {
+  std::size_t instances{};
+  std::uint64_t ticks{};  // summed over every instance
+  double wallMs{};
+  double ticksPerSecond{};
+  // Combined world checksum of every instance; equal across runs with the
+  // same instance count and ticks unless the simulation changed
+  std::uint64_t checksum{};
+};
+
+// Steps many headless SimulationInstances in parallel, for bot testing and
+// training workloads. Every instance is driven by its own seeded bot that
+// wanders the hero around, so instances diverge but each run of the batch is
+// reproducible.
+//
+// The map is loaded once and shared; textures are never created. Each job
+// runs one instance for all of its ticks, so instances never wait on each
+// other between ticks.
+class SimulationBatch {
+ private:
+  JobSystem jobs;
+  std::shared_ptr<const TileGroup> map;
+  // Declared before the instances that read from them
+  std::vector<std::unique_ptr<InputSource>> bots;
+  std::vector<std::unique_ptr<SimulationInstance>> instances;
+
+ public:
+  // Switches to the project root and disables GraphicsContext, then spawns
+  // the instances on the calling thread
+  SimulationBatch(std::size_t instanceCount,
+                  unsigned workerCount = JobSystem::DefaultWorkerCount());
+  ~SimulationBatch();
+
+  SimulationBatch(const SimulationBatch&) = delete;
+  SimulationBatch& operator=(const SimulationBatch&) = delete;
+
+  // Advances every instance by ticks fixed steps
+  SimulationBatchStats Run(std::uint32_t ticks);
+  // False if any instance is missing part of its scene; such a batch
+  // measures and checksums the wrong world
+  bool IsSceneComplete() const;
+};
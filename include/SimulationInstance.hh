@@ -0,0 +1,113 @@
+#pragma once
+#include <box2d/box2d.h>
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <gsl/span>
+#include <memory>
+#include <string_view>
+
+#include "InputSystem.hh"
+
+class AnimationSystem;
+class AudioMixer;
+class ContactEventManager;
+class Entity;
+class EntityManager;
+class JobSystem;
+class PartitionedPhysicsWorld;
+class PrefabLibrary;
+class PrefabSpawner;
+class TileGroup;
+
+struct SimulationOptions {
+  float fixedStep{};  // seconds per Step()
+  // Optional: the hero's footsteps and hits play through it. AudioMixer is
+  // single-threaded, so leave this null for instances stepped in parallel.
+  AudioMixer* audioMixer{};
+  // Steps the physics cells; required with GameConstants::PHYSICS_PARTITIONED
+  JobSystem* physicsJobs{};
+  // Optional device state per Step(); must outlive the instance
+  InputSource* inputSource{};
+};
+
+struct SimulationStats {
+  std::size_t entities{};
+  std::size_t bodies{};
+  std::size_t contacts{};  // touching or not, as Box2D counts them
+  std::size_t tiles{};  // in the shared map
+};
+
+// One self-contained copy of the game simulation: its own physics world,
+// entities, animation and input, spawned on a shared map. Nothing in it
+// touches process state (window, working directory, devices), so separate
+// instances can be stepped on separate threads at the same time.
+//
+// Immutable assets are shared: the map is one TileGroup handed to every
+// instance, and clips, state machines and sound buffers come from the
+// process-wide caches. Those caches are filled while instances are
+// constructed, so construct them on one thread; afterwards each instance
+// may be stepped from any thread, one call at a time.
+class SimulationInstance {
+ private:
+  std::shared_ptr<const TileGroup> map;
+  std::unique_ptr<ContactEventManager> contactEventManager;
+  std::unique_ptr<b2World> world;
+  // Used instead of 'world' when GameConstants::PHYSICS_PARTITIONED is set
+  std::unique_ptr<PartitionedPhysicsWorld> partitionedWorld;
+  std::unique_ptr<InputSystem> input;
+  InputSource* inputSource{};
+  // Outlives entityManager: animators release their slots on destruction
+  std::unique_ptr<AnimationSystem> animationSystem;
+  // Declared after the worlds so bodies are destroyed first
+  std::unique_ptr<EntityManager> entityManager;
+  std::unique_ptr<PrefabLibrary> prefabLibrary;
+  std::unique_ptr<PrefabSpawner> prefabSpawner;
+  float fixedStep{};
+  std::uint32_t tick{};
+  bool sceneComplete{};
+
+  // False if a prefab the scene needs is missing; the rest still spawn
+  bool SpawnScene();
+
+ public:
+  SimulationInstance(std::shared_ptr<const TileGroup> map,
+                     const SimulationOptions& options);
+  ~SimulationInstance();
+
+  SimulationInstance(const SimulationInstance&) = delete;
+  SimulationInstance& operator=(const SimulationInstance&) = delete;
+
+  // One fixed tick: input from the source, physics, entities, animation.
+  // Returns false without stepping once the input source runs out.
+  bool Step();
+
+  // The phases of Step(), for callers that feed input and pick the delta
+  // time themselves (Game)
+  void StepPhysics(float deltaTime);
+  void UpdateEntities(float deltaTime);
+  void UpdateAnimation(float deltaTime);
+  // After AnimationLibrary::Reload, so playing clips pick up the change
+  void RefreshAnimationClips();
+
+  // Prefabs from ASSETS_PREFABS; see PrefabSpawner
+  gsl::span<Entity*> SpawnPrefab(std::string_view name, std::size_t count,
+                                 gsl::span<const sf::Vector2f> positions);
+  void DespawnPrefab(Entity& entity);
+
+  void SetDebugDraw(b2Draw* debugDraw);
+  void DebugDraw();
+  // See EntityManager::ComputeChecksum
+  std::uint64_t ComputeChecksum() const;
+
+  InputSystem& GetInput();
+  EntityManager& GetEntityManager();
+  const TileGroup* GetMap() const;
+  // Ticks run through Step()
+  std::uint32_t GetTick() const;
+  // False if the prefab file didn't load cleanly or lacks a prefab the
+  // scene spawns (logged); such an instance still steps what it has
+  bool IsSceneComplete() const;
+  SimulationStats GetStats() const;
+};
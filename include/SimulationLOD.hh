@@ -0,0 +1,55 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstdint>
+
+enum class SimulationTier : std::uint8_t { Full, Reduced, Dormant, Count };
+
+// Distance-based simulation level of detail. Positions are bucketed into a
+// coarse square grid and an entity's tier is the ring distance (in cells)
+// between its cell and the focus cell, so classifying is a couple of integer
+// ops per entity. Full entities update every frame, Reduced ones every
+// reducedInterval frames with the skipped time accumulated, Dormant ones not
+// at all (their bodies are put to sleep).
+class SimulationLOD {
+ public:
+  struct Settings {
+    float cellSize{256.f};  // pixels
+    int fullRadius{2};      // cells around the focus updated every frame
+    int reducedRadius{4};   // beyond this ring entities are dormant
+    int reducedInterval{4};
+  };
+
+ private:
+  Settings settings;
+  sf::Vector2i focusCell{};
+  bool hasFocus{};
+  std::uint32_t frame{};
+  std::array<int, static_cast<std::size_t>(SimulationTier::Count)>
+      tierCounts{};
+
+ public:
+  SimulationLOD() = default;
+  explicit SimulationLOD(const Settings& settings);
+
+  void SetSettings(const Settings& settings);
+  const Settings& GetSettings() const;
+
+  // Without a focus every entity is Full
+  void SetFocus(const sf::Vector2f& position);
+  void ClearFocus();
+  bool HasFocus() const;
+
+  sf::Vector2i CellOf(const sf::Vector2f& position) const;
+  SimulationTier Classify(const sf::Vector2f& position) const;
+
+  // Advances the frame counter and resets the per-tier counters
+  void BeginFrame();
+  void Count(SimulationTier tier);
+  // Whether a Reduced entity runs this frame; slot staggers entities so they
+  // don't all catch up on the same frame.
+  bool IsReducedUpdateDue(std::uint32_t slot) const;
+
+  int GetTierCount(SimulationTier tier) const;
+  static const char* GetTierName(SimulationTier tier);
+};
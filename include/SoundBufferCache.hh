@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "SFML/Audio.hpp"
+
+struct SoundBufferStats {
+  int buffers{};           // decoded assets currently resident
+  std::int64_t bytes{};    // PCM bytes held by those buffers
+  std::int64_t decodes{};  // files decoded since startup
+  std::int64_t cacheHits{};
+};
+
+// Process-wide cache of decoded sound buffers keyed by path. Every AudioClip
+// for the same file shares one refcounted sf::SoundBuffer, so each asset is
+// decoded once. Entries stay resident until Trim() drops the ones no clip
+// references anymore.
+class SoundBufferCache {
+ public:
+  // Null (and logged) if the file can't be decoded
+  static std::shared_ptr<const sf::SoundBuffer> Acquire(
+      const std::string& path);
+  // Frees buffers that only the cache still holds; returns how many
+  static int Trim();
+  static SoundBufferStats GetStats();
+};
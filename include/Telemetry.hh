@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameProfiler.hh"
+
+// One frame of stats as published to the telemetry ring. Plain data: the
+// layout is shared with other processes, so bump TELEMETRY_VERSION when it
+// changes.
+struct TelemetryFrame {
+  static constexpr std::size_t PHASES{
+      static_cast<std::size_t>(FramePhase::Count)};
+
+  std::uint64_t frame{};
+  float frameMs{};  // since the previous frame, waits included
+  float phaseMs[PHASES]{};
+  std::uint32_t entities{};
+  std::uint32_t bodies{};
+  std::uint32_t contacts{};
+  std::int64_t allocatedBytes{};  // EngineAllocator, all tags
+  std::int64_t allocations{};     // cumulative
+};
+
+inline constexpr std::uint32_t TELEMETRY_VERSION{2};
+
+// Publishes frames into a POSIX shared-memory ring for out-of-process
+// viewers (TelemetryViewer), so a soak test can be watched without an overlay
+// or debugger touching the game's timing.
+//
+// Publish is wait-free: it claims the next slot, marks it busy, copies the
+// frame and marks it done (a per-slot seqlock). It never looks at readers,
+// which simply miss frames if they fall more than a ring behind. Not
+// available on Windows, where Open fails.
+class TelemetryWriter {
+ private:
+  void* mapping{};
+  std::size_t mappingSize{};
+  std::string name;
+  std::uint64_t next{};
+
+ public:
+  static constexpr std::uint32_t RING_FRAMES{1024};
+
+  TelemetryWriter() = default;
+  ~TelemetryWriter();
+
+  TelemetryWriter(const TelemetryWriter&) = delete;
+  TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+  // Creates (or replaces) the segment, e.g. "/blackengine-telemetry"
+  bool Open(const std::string& name);
+  void Publish(const TelemetryFrame& frame);
+  // Marks the ring closed for readers and unlinks it
+  void Close();
+};
+
+// Tails a TelemetryWriter's ring from another process
+class TelemetryReader {
+ private:
+  const void* mapping{};
+  std::size_t mappingSize{};
+  std::uint64_t next{};
+  std::uint64_t dropped{};
+
+ public:
+  TelemetryReader() = default;
+  ~TelemetryReader();
+
+  TelemetryReader(const TelemetryReader&) = delete;
+  TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+  // False while no writer has created the segment
+  bool Open(const std::string& name);
+  void Close();
+  bool IsOpen() const;
+
+  // Appends frames published since the last call, oldest first. Frames
+  // overwritten before they could be read are counted in GetDropped().
+  std::size_t Poll(std::vector<TelemetryFrame>& frames);
+  // The writer closed the ring; reopen to follow a restarted game
+  bool IsWriterClosed() const;
+  std::uint64_t GetDropped() const;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct TextureCacheStats {
+  int textures{};          // uploaded images currently resident
+  std::int64_t bytes{};    // RGBA8 texels held by those textures
+  std::int64_t loads{};    // images decoded (or cooked ones uploaded)
+  std::int64_t cacheHits{};
+  std::int64_t reloads{};  // Replace calls
+};
+
+// Process-wide cache of GPU textures keyed by asset path. Every sprite,
+// tile and button drawing the same image shares one refcounted sf::Texture,
+// so each asset is decoded and uploaded once, and a hot reload can replace
+// the pixels in place: everything drawing it picks the new image up on its
+// next draw. Lookups are thread-safe; loads and Replace upload through the
+// GL context, so make them from the main thread.
+class TextureCache {
+ public:
+  // Never null: an empty texture (logged) if the image can't be loaded, and
+  // never loaded at all without a GraphicsContext
+  static std::shared_ptr<const sf::Texture> Acquire(const std::string& path);
+  static bool Contains(std::string_view path);
+  // Uploads 'image' over the resident texture for 'path'; false if there is
+  // none or the upload fails
+  static bool Replace(std::string_view path, const sf::Image& image);
+  // Frees textures nothing else holds anymore; returns how many
+  static int Trim();
+  static TextureCacheStats GetStats();
+};
@@ -15,14 +15,16 @@ class Tile {
   int row{};
   float posX{};
   float posY{};
+  // Shared through the TextureCache with every tile of the same tileset
+  std::shared_ptr<const sf::Texture> texture;
   std::unique_ptr<sf::Sprite> sprite;
-  std::unique_ptr<sf::Texture> texture;
-  sf::RenderWindow* window;
 
  public:
-  Tile(const std::string& textureUrl, float scale, int width, int height,
-       int column, int row, float posX, float posY, sf::RenderWindow*& window);
+  Tile(std::shared_ptr<const sf::Texture> texture, float scale, int width,
+       int height, int column, int row, float posX, float posY);
   ~Tile();
 
-  void Draw();
+  void Draw(sf::RenderTarget& target) const;
+  int GetColumn() const { return column; }
+  int GetRow() const { return row; }
 };
\ No newline at end of file
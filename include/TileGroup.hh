@@ -2,26 +2,65 @@
 #include <gsl/assert>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Tile.hh"
 
+// One layer of a map file: tileset cells row by row, {0, 0} being empty.
+// An empty tileset or zero tile size means the TileGroup's default.
+struct MapLayerData {
+  std::string tileset;
+  int tileWidth{};
+  int tileHeight{};
+  int columns{};
+  int rows{};
+  std::vector<sf::Vector2i> cells;  // columns * rows
+};
+
+// A map file as read, before any tile exists
+struct MapData {
+  std::vector<MapLayerData> layers;
+};
+
 class TileGroup {
  private:
-  sf::RenderWindow* window;
+  // A built layer: its data with the defaults resolved, and one tile per
+  // non-empty cell (null elsewhere) so a reload can diff cell by cell
+  struct Layer {
+    MapLayerData data;
+    std::vector<std::unique_ptr<Tile>> tiles;
+  };
+
   // Multiple layers of tiles (drawn in order)
-  std::unique_ptr<std::vector<std::vector<std::unique_ptr<Tile>>>> layerTiles;
+  std::vector<Layer> layers;
   int COLS{}, ROWS{};
   std::string filePathStr{};
   float scale;
   float tileWidth{}, tileHeight{};
   std::string textureUrlStr{};
+  std::size_t tileCount{};
+
+  // Fills in the defaults of a layer just read
+  void ResolveLayer(MapLayerData& layer) const;
+  // Returns the number of tiles created
+  std::size_t BuildLayer(Layer& layer);
 
  public:
-  TileGroup(sf::RenderWindow* window, int COLS, int ROWS, const char* filePath,
-            float scale, float tileWidth, float tileHeight,
-            const char* textureUrl);
+  TileGroup(int COLS, int ROWS, const char* filePath, float scale,
+            float tileWidth, float tileHeight, const char* textureUrl);
   ~TileGroup();
 
+  // Reads a map (cooked, or else its JSON) without building tiles, so it is
+  // safe on any thread. False (and logged) if it can't be read.
+  static bool ReadMap(const std::string& path, MapData& map);
+
   void GenerateMap();
-  void Draw();
-};
\ No newline at end of file
+  // Swaps in a new version of the map: only cells that changed get new
+  // tiles, and a layer is rebuilt whole only when its size or tileset did.
+  // Returns the number of tiles created.
+  std::size_t Reload(const MapData& map);
+  void Draw(sf::RenderTarget& target) const;
+  // Tiles across all layers, i.e. draw calls per Draw()
+  std::size_t GetTileCount() const;
+  const std::string& GetPath() const;
+};
@@ -0,0 +1,60 @@
+// Box2D user settings, picked up by box2d/b2_settings.h when the library and
+// its users are compiled with B2_USER_SETTINGS (set by CMakeLists.txt when
+// Box2D is built from source). Mirrors the stock defaults except that
+// b2Alloc/b2Free go through EngineAllocator under MemoryTag::Physics.
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "EngineAllocator.hh"
+
+// Tunable Constants
+
+/// Length scaling is done by the engine (PhysicsUnits.hh), keep Box2D at 1.
+#define b2_lengthUnitsPerMeter 1.0f
+
+#define b2_maxPolygonVertices 8
+
+// User data
+
+struct B2_API b2BodyUserData {
+  b2BodyUserData() { pointer = 0; }
+
+  uintptr_t pointer;
+};
+
+struct B2_API b2FixtureUserData {
+  b2FixtureUserData() { pointer = 0; }
+
+  uintptr_t pointer;
+};
+
+struct B2_API b2JointUserData {
+  b2JointUserData() { pointer = 0; }
+
+  uintptr_t pointer;
+};
+
+// Memory Allocation
+
+B2_API void* b2Alloc_Default(int32 size);
+B2_API void b2Free_Default(void* mem);
+
+inline void* b2Alloc(int32 size) {
+  return EngineAllocator::Allocate(static_cast<size_t>(size),
+                                   MemoryTag::Physics);
+}
+
+inline void b2Free(void* mem) { EngineAllocator::Free(mem); }
+
+// Logging
+
+B2_API void b2Log_Default(const char* string, va_list args);
+
+inline void b2Log(const char* string, ...) {
+  va_list args;
+  va_start(args, string);
+  b2Log_Default(string, args);
+  va_end(args);
+}
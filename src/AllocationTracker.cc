@@ -0,0 +1,234 @@
+#include "AllocationTracker.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define ALLOCATION_TRACKER_BACKTRACE 1
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int MAX_STACK_FRAMES{32};
+
+struct TrackerState {
+  std::atomic<bool> enabled{};
+  // Set between warm-up and the end of the run; arms stack capture
+  std::atomic<bool> enforcing{};
+  std::array<std::atomic<std::int64_t>, AllocationFrameStats::ZONES>
+      allocations{};
+  std::array<std::atomic<std::int64_t>, AllocationFrameStats::ZONES> bytes{};
+
+  // First allocation of the current frame while enforcing
+  std::atomic<bool> stackTaken{};
+  void* stack[MAX_STACK_FRAMES]{};
+  int stackDepth{};
+
+  // Main-thread only (Enable / EndFrame)
+  AllocationBudget budget;
+  std::int64_t frames{};
+  std::int64_t checkedFrames{};
+  std::int64_t violations{};
+  AllocationFrameStats lastFrame;
+};
+
+// Constant-initialized, so it is usable from operator new before main
+constinit TrackerState state;
+
+// Stops the tracker counting its own (or backtrace's) allocations
+thread_local bool insideHook{};
+
+void Record(std::size_t size) {
+  if (!state.enabled.load(std::memory_order_relaxed) || insideHook) return;
+  insideHook = true;
+  const bool frameThread{AllocationTracker::IsFrameThread()};
+  const auto zone{
+      frameThread ? static_cast<std::size_t>(FrameProfiler::GetActivePhase())
+                  : AllocationFrameStats::BACKGROUND_ZONE};
+  state.allocations[zone].fetch_add(1, std::memory_order_relaxed);
+  state.bytes[zone].fetch_add(static_cast<std::int64_t>(size),
+                              std::memory_order_relaxed);
+#ifdef ALLOCATION_TRACKER_BACKTRACE
+  if (frameThread && state.enforcing.load(std::memory_order_relaxed) &&
+      !state.stackTaken.exchange(true, std::memory_order_relaxed)) {
+    state.stackDepth = backtrace(state.stack, MAX_STACK_FRAMES);
+  }
+#endif
+  insideHook = false;
+}
+
+void* Allocate(std::size_t size) {
+  Record(size);
+  // malloc(0) may return null; new must not
+  return std::malloc(size > 0 ? size : 1);
+}
+
+void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+  Record(size);
+  const auto align{static_cast<std::size_t>(alignment)};
+#ifdef _WIN32
+  return _aligned_malloc(size > 0 ? size : 1, align);
+#else
+  // aligned_alloc wants a multiple of the alignment
+  const std::size_t rounded{(size + align - 1) / align * align};
+  return std::aligned_alloc(align, rounded > 0 ? rounded : align);
+#endif
+}
+
+void FreeAligned(void* memory) {
+#ifdef _WIN32
+  _aligned_free(memory);
+#else
+  std::free(memory);
+#endif
+}
+
+void Report(const AllocationFrameStats& frame) {
+  std::cerr << "Allocation budget exceeded in frame " << state.frames << ": "
+            << frame.totalAllocations << " allocations, " << frame.totalBytes
+            << " bytes (limit " << state.budget.maxAllocationsPerFrame
+            << ")\n";
+  for (std::size_t zone{}; zone < AllocationFrameStats::ZONES; ++zone) {
+    if (frame.allocations[zone] == 0) continue;
+    std::cerr << "  " << AllocationTracker::GetZoneName(zone) << ": "
+              << frame.allocations[zone] << " / " << frame.bytes[zone]
+              << " bytes\n";
+  }
+#ifdef ALLOCATION_TRACKER_BACKTRACE
+  if (state.stackDepth > 0) {
+    std::cerr << "  first allocation from:" << std::endl;
+    backtrace_symbols_fd(state.stack, state.stackDepth, STDERR_FILENO);
+  }
+#endif
+  std::cerr.flush();
+}
+
+}  // namespace
+
+void AllocationTracker::Enable(const AllocationBudget& budget) {
+#ifdef ALLOCATION_TRACKER_BACKTRACE
+  // The first backtrace() loads the unwinder; do it before counting starts
+  void* warm[1];
+  backtrace(warm, 1);
+#endif
+  MarkFrameThread();
+  state.budget = budget;
+  state.frames = 0;
+  state.enforcing.store(budget.warmupFrames == 0, std::memory_order_relaxed);
+  state.enabled.store(true, std::memory_order_relaxed);
+}
+
+bool AllocationTracker::IsEnabled() {
+  return state.enabled.load(std::memory_order_relaxed);
+}
+
+const AllocationFrameStats& AllocationTracker::EndFrame() {
+  AllocationFrameStats& frame{state.lastFrame};
+  frame.totalAllocations = 0;
+  frame.totalBytes = 0;
+  for (std::size_t zone{}; zone < AllocationFrameStats::ZONES; ++zone) {
+    frame.allocations[zone] =
+        state.allocations[zone].exchange(0, std::memory_order_relaxed);
+    frame.bytes[zone] =
+        state.bytes[zone].exchange(0, std::memory_order_relaxed);
+    if (zone == AllocationFrameStats::BACKGROUND_ZONE) continue;
+    frame.totalAllocations += frame.allocations[zone];
+    frame.totalBytes += frame.bytes[zone];
+  }
+  if (!IsEnabled()) return frame;
+
+  if (state.enforcing.load(std::memory_order_relaxed)) {
+    ++state.checkedFrames;
+    if (frame.totalAllocations > state.budget.maxAllocationsPerFrame) {
+      if (state.violations < state.budget.maxReports) Report(frame);
+      ++state.violations;
+    }
+  }
+  ++state.frames;
+  state.stackDepth = 0;
+  state.stackTaken.store(false, std::memory_order_relaxed);
+  if (state.frames >= state.budget.warmupFrames) {
+    state.enforcing.store(true, std::memory_order_relaxed);
+  }
+  return frame;
+}
+
+const AllocationFrameStats& AllocationTracker::GetLastFrame() {
+  return state.lastFrame;
+}
+
+std::int64_t AllocationTracker::GetCheckedFrames() {
+  return state.checkedFrames;
+}
+
+std::int64_t AllocationTracker::GetViolations() { return state.violations; }
+
+const char* AllocationTracker::GetZoneName(std::size_t zone) {
+  if (zone == AllocationFrameStats::BACKGROUND_ZONE) return "background";
+  if (zone >= AllocationFrameStats::OTHER_ZONE) return "other";
+  return FrameProfiler::GetPhaseName(static_cast<FramePhase>(zone));
+}
+
+// Replacements for the global allocation functions. The array, nothrow and
+// sized forms are replaced too, since not every standard library routes
+// them through the plain ones.
+
+void* operator new(std::size_t size) {
+  if (void* memory{Allocate(size)}) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  if (void* memory{Allocate(size)}) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  if (void* memory{AllocateAligned(size, alignment)}) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  if (void* memory{AllocateAligned(size, alignment)}) return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete[](void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+  FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+  FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+  FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+  FreeAligned(memory);
+}
@@ -1,50 +1,44 @@
 #include "Animation.hh"
 
-#include <iostream>
+#include "AssetFiles.hh"
+#include "Log.hh"
 
 Animation::Animation(SpriteComponent& sprite, TransformComponent& transform,
                      const char* animUrl)
     : sprite(sprite), transform(transform) {
-  std::ifstream reader;
-  reader.open(animUrl);
-
-  if (!reader.is_open()) {
-    std::cerr << "Failed to open animation file: " << animUrl << std::endl;
+  const AssetData data{AssetFiles::Read(animUrl)};
+  if (!data) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Failed to open animation file: {}",
+                  animUrl);
     return;
   }
 
   root = Json::Value();
+  std::string errors;
+  if (!AssetFiles::ParseJson(data, root, errors)) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "JSON parsing error in animation file {}: {}", animUrl,
+                  errors);
+    return;
+  }
 
-  try {
-    reader >> root;
-
-    if (root.isNull() || !root.isObject()) {
-      std::cerr << "Invalid JSON format in animation file: " << animUrl
-                << std::endl;
-      return;
-    }
-
-    if (!root["animation"].isObject()) {
-      std::cerr << "Missing 'animation' object in file: " << animUrl
-                << std::endl;
-      return;
-    }
-
-    startFrame = root["animation"]["startFrame"].asInt();
-    endFrame = root["animation"]["endFrame"].asInt();
-    animationDelay = root["animation"]["delay"].asFloat();
-    currentAnimation = root["animation"]["row"].asInt();
-    animationIndex = startFrame;
+  if (root.isNull() || !root.isObject()) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Invalid JSON format in animation file: {}", animUrl);
+    return;
+  }
 
-  } catch (const Json::RuntimeError& e) {
-    std::cerr << "JSON parsing error in animation file " << animUrl << ": "
-              << e.what() << std::endl;
-  } catch (const std::exception& e) {
-    std::cerr << "Error reading animation file " << animUrl << ": " << e.what()
-              << std::endl;
+  if (!root["animation"].isObject()) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Missing 'animation' object in file: {}", animUrl);
+    return;
   }
 
-  reader.close();
+  startFrame = root["animation"]["startFrame"].asInt();
+  endFrame = root["animation"]["endFrame"].asInt();
+  animationDelay = root["animation"]["delay"].asFloat();
+  currentAnimation = root["animation"]["row"].asInt();
+  animationIndex = startFrame;
 }
 
 void Animation::Play(float& deltaTime) {
@@ -54,7 +48,7 @@ void Animation::Play(float& deltaTime) {
                            transform.GetWidth(), transform.GetHeight());
 
   if (currentTime > animationDelay) {
-    std::cout << "index: " << animationIndex;
+    BEP_LOG_TRACE(LogCategory::Animation, "index: {}", animationIndex);
     if (animationIndex == endFrame) {
       animationIndex = startFrame;
     } else {
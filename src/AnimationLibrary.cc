@@ -0,0 +1,210 @@
+#include "AnimationLibrary.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <gsl/assert>
+#include <gsl/narrow>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetFiles.hh"
+#include "CookedAssets.hh"
+#include "Log.hh"
+
+#include "json/json.h"
+
+namespace {
+
+// Where a clip came from, so Reload can find and rebuild it
+struct ClipOrigin {
+  std::string path;
+  sf::Vector2i frameSize;
+  std::uint32_t frameCapacity{};  // rects reserved at firstFrame
+};
+
+struct LibraryState {
+  std::vector<AnimationClip> clips;
+  std::vector<ClipOrigin> origins;  // by handle
+  std::vector<sf::IntRect> frames;
+  std::unordered_map<std::string, AnimationClipHandle> handles;
+};
+
+LibraryState& State() {
+  static LibraryState state;
+  return state;
+}
+
+std::string MakeKey(const std::string& path, sf::Vector2i frameSize) {
+  return path + '@' + std::to_string(frameSize.x) + 'x' +
+         std::to_string(frameSize.y);
+}
+
+bool ReadClipJson(const std::string& path, Json::Value& animation) {
+  const AssetData data{AssetFiles::Read(path)};
+  if (!data) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Failed to open animation file: {}",
+                  path);
+    return false;
+  }
+
+  Json::Value root;
+  std::string errors;
+  if (!AssetFiles::ParseJson(data, root, errors)) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "JSON parsing error in animation file {}: {}", path, errors);
+    return false;
+  }
+
+  if (root.isNull() || !root.isObject()) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Invalid JSON format in animation file: {}", path);
+    return false;
+  }
+  if (!root["animation"].isObject()) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Missing 'animation' object in file: {}", path);
+    return false;
+  }
+  animation = root["animation"];
+  return true;
+}
+
+// Fills 'clip' from the cooked clip when there is one, else from the JSON
+bool ReadClip(const std::string& path, CookedClip& clip) {
+  if (const std::string* cooked{CookedAssets::Find(path, CookedKind::Clip)}) {
+    const AssetData data{AssetFiles::Read(*cooked)};
+    if (data.GetSize() == sizeof(clip)) {
+      std::memcpy(&clip, data.GetData(), sizeof(clip));
+      if (std::memcmp(clip.magic, COOKED_CLIP_MAGIC,
+                      sizeof(COOKED_CLIP_MAGIC)) == 0 &&
+          clip.version == COOKED_VERSION) {
+        return true;
+      }
+    }
+    BEP_LOG_WARNING(LogCategory::Assets,
+                    "Ignoring invalid cooked clip {} for {}", *cooked, path);
+  }
+
+  Json::Value animation;
+  if (!ReadClipJson(path, animation)) return false;
+  clip.startFrame = animation["startFrame"].asInt();
+  clip.endFrame = animation["endFrame"].asInt();
+  clip.row = animation["row"].asInt();
+  clip.delay = animation["delay"].asFloat();
+  return true;
+}
+
+void WriteFrames(LibraryState& state, std::uint32_t first,
+                 const AnimationClipSource& source, sf::Vector2i frameSize) {
+  for (int frame{source.startFrame}; frame <= source.endFrame; ++frame) {
+    state.frames[first++] = sf::IntRect(
+        sf::Vector2i(frame * frameSize.x, source.row * frameSize.y),
+        frameSize);
+  }
+}
+
+}  // namespace
+
+AnimationClipHandle AnimationLibrary::Load(const std::string& path,
+                                           sf::Vector2i frameSize) {
+  Expects(frameSize.x > 0 && frameSize.y > 0);
+  LibraryState& state{State()};
+  const std::string key{MakeKey(path, frameSize)};
+  if (auto it = state.handles.find(key); it != state.handles.end()) {
+    return it->second;
+  }
+
+  AnimationClipSource source;
+  if (!ReadSource(path, source)) return INVALID_ANIMATION_CLIP;
+  Expects(state.clips.size() < INVALID_ANIMATION_CLIP);
+
+  const auto count{
+      gsl::narrow_cast<std::uint32_t>(source.endFrame - source.startFrame + 1)};
+  AnimationClip clip;
+  clip.firstFrame = gsl::narrow_cast<std::uint32_t>(state.frames.size());
+  clip.frameCount = gsl::narrow_cast<std::uint16_t>(count);
+  clip.frameDelay = source.delay;
+  state.frames.resize(state.frames.size() + count);
+  WriteFrames(state, clip.firstFrame, source, frameSize);
+
+  const auto handle{gsl::narrow_cast<AnimationClipHandle>(state.clips.size())};
+  state.clips.push_back(clip);
+  // Normalized like the paths HotReload reports
+  state.origins.push_back(ClipOrigin{
+      std::filesystem::path(path).lexically_normal().generic_string(),
+      frameSize, count});
+  state.handles.emplace(key, handle);
+  return handle;
+}
+
+bool AnimationLibrary::ReadSource(const std::string& path,
+                                  AnimationClipSource& source) {
+  CookedClip clip{};
+  if (!ReadClip(path, clip)) return false;
+  if (clip.startFrame < 0 || clip.endFrame < clip.startFrame) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Invalid frame range in animation file: {}", path);
+    return false;
+  }
+  source.startFrame = clip.startFrame;
+  source.endFrame = clip.endFrame;
+  source.row = clip.row;
+  source.delay = clip.delay;
+  return true;
+}
+
+bool AnimationLibrary::IsLoaded(std::string_view path) {
+  const LibraryState& state{State()};
+  return std::any_of(
+      state.origins.begin(), state.origins.end(),
+      [path](const ClipOrigin& origin) { return origin.path == path; });
+}
+
+int AnimationLibrary::Reload(std::string_view path,
+                             const AnimationClipSource& source) {
+  Expects(source.startFrame >= 0 && source.endFrame >= source.startFrame);
+  LibraryState& state{State()};
+  const auto count{
+      gsl::narrow_cast<std::uint32_t>(source.endFrame - source.startFrame + 1)};
+  int updated{};
+  for (std::size_t handle{}; handle < state.clips.size(); ++handle) {
+    ClipOrigin& origin{state.origins[handle]};
+    if (origin.path != path) continue;
+    AnimationClip& clip{state.clips[handle]};
+    // Rects no clip points at anymore when it grows are left behind; edits
+    // are rare enough that compacting isn't worth moving every clip
+    if (count > origin.frameCapacity) {
+      clip.firstFrame = gsl::narrow_cast<std::uint32_t>(state.frames.size());
+      state.frames.resize(state.frames.size() + count);
+      origin.frameCapacity = count;
+    }
+    WriteFrames(state, clip.firstFrame, source, origin.frameSize);
+    clip.frameCount = gsl::narrow_cast<std::uint16_t>(count);
+    clip.frameDelay = source.delay;
+    ++updated;
+  }
+  return updated;
+}
+
+const AnimationClip& AnimationLibrary::GetClip(AnimationClipHandle clip) {
+  Expects(clip < State().clips.size());
+  return State().clips[clip];
+}
+
+const sf::IntRect& AnimationLibrary::GetFrame(std::uint32_t frame) {
+  Expects(frame < State().frames.size());
+  return State().frames[frame];
+}
+
+int AnimationLibrary::GetClipCount() {
+  return gsl::narrow_cast<int>(State().clips.size());
+}
+
+void AnimationLibrary::Clear() {
+  LibraryState& state{State()};
+  state.clips.clear();
+  state.origins.clear();
+  state.frames.clear();
+  state.handles.clear();
+}
@@ -0,0 +1,280 @@
+#include "AnimationStateMachine.hh"
+
+#include <algorithm>
+#include <gsl/assert>
+#include <gsl/narrow>
+#include <unordered_map>
+
+#include "AnimationLibrary.hh"
+#include "AssetFiles.hh"
+#include "Log.hh"
+#include "json/json.h"
+
+namespace {
+
+bool ParseCompareOp(const std::string& text,
+                    AnimationStateMachine::CompareOp& op) {
+  using Op = AnimationStateMachine::CompareOp;
+  static const std::pair<const char*, Op> ops[]{
+      {">", Op::Greater}, {">=", Op::GreaterEqual}, {"<", Op::Less},
+      {"<=", Op::LessEqual}, {"==", Op::Equal},     {"!=", Op::NotEqual}};
+  for (const auto& [name, value] : ops) {
+    if (text == name) {
+      op = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+AnimationStateMachine::Index IndexOf(const std::vector<T>& values,
+                                     const T& value) {
+  auto it = std::find(values.begin(), values.end(), value);
+  if (it == values.end()) return AnimationStateMachine::INVALID_INDEX;
+  return gsl::narrow_cast<AnimationStateMachine::Index>(it - values.begin());
+}
+
+}  // namespace
+
+std::shared_ptr<const AnimationStateMachine> AnimationStateMachine::Load(
+    const std::string& path, sf::Vector2i frameSize) {
+  static std::unordered_map<std::string,
+                            std::shared_ptr<const AnimationStateMachine>>
+      cache;
+  const std::string key{path + '@' + std::to_string(frameSize.x) + 'x' +
+                        std::to_string(frameSize.y)};
+  if (auto it = cache.find(key); it != cache.end()) return it->second;
+
+  auto machine = std::make_shared<AnimationStateMachine>();
+  if (!machine->Compile(path, frameSize)) return nullptr;
+  cache.emplace(key, machine);
+  return machine;
+}
+
+bool AnimationStateMachine::Compile(const std::string& path,
+                                    sf::Vector2i frameSize) {
+  const AssetData data{AssetFiles::Read(path)};
+  if (!data) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Failed to open animation state machine: {}", path);
+    return false;
+  }
+
+  Json::Value root;
+  std::string errors;
+  if (!AssetFiles::ParseJson(data, root, errors)) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "JSON parsing error in animation state machine {}: {}", path,
+                  errors);
+    return false;
+  }
+  if (!root.isObject() || !root["states"].isArray() ||
+      root["states"].empty()) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Missing 'states' array in animation state machine: {}",
+                  path);
+    return false;
+  }
+
+  const Json::Value& parameters{root["parameters"]};
+  if (parameters.isObject()) {
+    for (const auto& name : parameters.getMemberNames()) {
+      parameterNames.push_back(name);
+      defaultParameters.push_back(parameters[name].asFloat());
+    }
+  }
+
+  // Each state's event run is contiguous because states are parsed in order
+  for (const Json::Value& stateJson : root["states"]) {
+    const std::string name{stateJson["name"].asString()};
+    if (name.empty() || IndexOf(stateNames, name) != INVALID_INDEX) {
+      BEP_LOG_ERROR(LogCategory::Assets,
+                    "Missing or duplicate state name '{}' in {}", name, path);
+      return false;
+    }
+
+    State state;
+    state.clip = AnimationLibrary::Load(stateJson["clip"].asString(),
+                                        frameSize);
+    if (state.clip == INVALID_ANIMATION_CLIP) return false;
+    state.frameCount = AnimationLibrary::GetClip(state.clip).frameCount;
+    state.loop = stateJson.get("mode", "loop").asString() != "once";
+
+    state.firstEvent = gsl::narrow_cast<Index>(events.size());
+    for (const Json::Value& eventJson : stateJson["events"]) {
+      const std::string eventName{eventJson["name"].asString()};
+      Index nameIndex{IndexOf(eventNames, eventName)};
+      if (nameIndex == INVALID_INDEX) {
+        nameIndex = gsl::narrow_cast<Index>(eventNames.size());
+        eventNames.push_back(eventName);
+      }
+      events.push_back(FrameEvent{eventJson["frame"].asInt(), nameIndex});
+    }
+    state.eventCount =
+        gsl::narrow_cast<Index>(events.size() - state.firstEvent);
+
+    stateNames.push_back(name);
+    states.push_back(state);
+  }
+
+  // Parse transitions with their source, then lay them out grouped by
+  // source with "any" first
+  struct ParsedTransition {
+    Index from{};
+    Transition transition;
+  };
+  std::vector<ParsedTransition> parsed;
+  for (const Json::Value& transitionJson : root["transitions"]) {
+    const std::string from{transitionJson["from"].asString()};
+    const std::string to{transitionJson["to"].asString()};
+    ParsedTransition entry;
+    entry.from = from == "any" ? INVALID_INDEX : IndexOf(stateNames, from);
+    entry.transition.target = IndexOf(stateNames, to);
+    if ((from != "any" && entry.from == INVALID_INDEX) ||
+        entry.transition.target == INVALID_INDEX) {
+      BEP_LOG_ERROR(LogCategory::Assets,
+                    "Unknown state in transition '{}' -> '{}' in {}", from, to,
+                    path);
+      return false;
+    }
+    entry.transition.onFinished = transitionJson["onFinished"].asBool();
+
+    entry.transition.firstCondition =
+        gsl::narrow_cast<Index>(conditions.size());
+    for (const Json::Value& conditionJson : transitionJson["conditions"]) {
+      Condition condition;
+      condition.parameter =
+          IndexOf(parameterNames, conditionJson["param"].asString());
+      if (condition.parameter == INVALID_INDEX ||
+          !ParseCompareOp(conditionJson["op"].asString(), condition.op)) {
+        BEP_LOG_ERROR(LogCategory::Assets,
+                      "Invalid condition on '{}' -> '{}' in {}", from, to,
+                      path);
+        return false;
+      }
+      condition.value = conditionJson["value"].asFloat();
+      conditions.push_back(condition);
+    }
+    entry.transition.conditionCount = gsl::narrow_cast<Index>(
+        conditions.size() - entry.transition.firstCondition);
+    parsed.push_back(entry);
+  }
+
+  std::stable_sort(parsed.begin(), parsed.end(),
+                   [](const ParsedTransition& a, const ParsedTransition& b) {
+                     // INVALID_INDEX ("any") sorts first
+                     return static_cast<Index>(a.from + 1) <
+                            static_cast<Index>(b.from + 1);
+                   });
+  for (const ParsedTransition& entry : parsed) {
+    if (entry.from == INVALID_INDEX) {
+      ++anyTransitionCount;
+    } else {
+      State& state{states[entry.from]};
+      if (state.transitionCount == 0) {
+        state.firstTransition = gsl::narrow_cast<Index>(transitions.size());
+      }
+      ++state.transitionCount;
+    }
+    transitions.push_back(entry.transition);
+  }
+
+  const std::string initial{root.get("initial", stateNames.front()).asString()};
+  initialState = IndexOf(stateNames, initial);
+  if (initialState == INVALID_INDEX) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Unknown initial state '{}' in {}",
+                  initial, path);
+    return false;
+  }
+  return true;
+}
+
+bool AnimationStateMachine::Passes(const Transition& transition,
+                                   const float* parameters,
+                                   bool clipFinished) const {
+  if (transition.onFinished && !clipFinished) return false;
+  for (Index i{}; i < transition.conditionCount; ++i) {
+    const Condition& condition{conditions[transition.firstCondition + i]};
+    const float value{parameters[condition.parameter]};
+    bool holds{};
+    switch (condition.op) {
+      case CompareOp::Greater:
+        holds = value > condition.value;
+        break;
+      case CompareOp::GreaterEqual:
+        holds = value >= condition.value;
+        break;
+      case CompareOp::Less:
+        holds = value < condition.value;
+        break;
+      case CompareOp::LessEqual:
+        holds = value <= condition.value;
+        break;
+      case CompareOp::Equal:
+        holds = value == condition.value;
+        break;
+      case CompareOp::NotEqual:
+        holds = value != condition.value;
+        break;
+    }
+    if (!holds) return false;
+  }
+  return true;
+}
+
+AnimationStateMachine::Index AnimationStateMachine::Evaluate(
+    Index state, const float* parameters, bool clipFinished) const {
+  Expects(state < states.size());
+  for (Index i{}; i < anyTransitionCount; ++i) {
+    const Transition& transition{transitions[i]};
+    if (transition.target == state) continue;
+    if (Passes(transition, parameters, clipFinished)) return transition.target;
+  }
+  const State& current{states[state]};
+  for (Index i{}; i < current.transitionCount; ++i) {
+    const Transition& transition{transitions[current.firstTransition + i]};
+    if (Passes(transition, parameters, clipFinished)) return transition.target;
+  }
+  return INVALID_INDEX;
+}
+
+AnimationStateMachine::Index AnimationStateMachine::FindParameter(
+    const std::string& name) const {
+  return IndexOf(parameterNames, name);
+}
+
+AnimationStateMachine::Index AnimationStateMachine::FindState(
+    const std::string& name) const {
+  return IndexOf(stateNames, name);
+}
+
+AnimationStateMachine::Index AnimationStateMachine::GetInitialState() const {
+  return initialState;
+}
+
+const AnimationStateMachine::State& AnimationStateMachine::GetState(
+    Index state) const {
+  Expects(state < states.size());
+  return states[state];
+}
+
+const std::string& AnimationStateMachine::GetStateName(Index state) const {
+  Expects(state < stateNames.size());
+  return stateNames[state];
+}
+
+const AnimationStateMachine::FrameEvent& AnimationStateMachine::GetEvent(
+    Index event) const {
+  Expects(event < events.size());
+  return events[event];
+}
+
+const std::string& AnimationStateMachine::GetEventName(Index name) const {
+  Expects(name < eventNames.size());
+  return eventNames[name];
+}
+
+const std::vector<float>& AnimationStateMachine::GetDefaultParameters() const {
+  return defaultParameters;
+}
@@ -0,0 +1,201 @@
+#include "AnimationSystem.hh"
+
+#include <algorithm>
+#include <gsl/assert>
+#include <gsl/narrow>
+
+#include "AnimationLibrary.hh"
+#include "Components/SpriteComponent.hh"
+
+namespace {
+// Guards the per-frame division against clips authored with a zero delay
+constexpr float MIN_FRAME_DELAY{1.f / 1000.f};
+}  // namespace
+
+std::uint32_t AnimationSystem::SlotOf(AnimatorId id) const {
+  Expects(id < slotOfId.size());
+  const std::uint32_t slot{slotOfId[id]};
+  Expects(slot < slotOwners.size());
+  return slot;
+}
+
+AnimationSystem::AnimatorId AnimationSystem::Add(SpriteComponent* sprite) {
+  AnimatorId id;
+  if (!freeIds.empty()) {
+    id = freeIds.back();
+    freeIds.pop_back();
+  } else {
+    id = gsl::narrow_cast<AnimatorId>(slotOfId.size());
+    slotOfId.emplace_back();
+  }
+  slotOfId[id] = gsl::narrow_cast<std::uint32_t>(slotOwners.size());
+
+  timers.push_back(0.f);
+  delays.push_back(1.f);
+  rates.push_back(0.f);  // nothing to play until the first Play
+  pending.push_back(0.f);
+  frames.push_back(0);
+  frameCounts.push_back(1);
+  firstFrames.push_back(0);
+  dirty.push_back(0);
+  paused.push_back(0);
+  looping.push_back(1);
+  finished.push_back(0);
+  throttled.push_back(0);
+  due.push_back(0);
+  clips.push_back(INVALID_ANIMATION_CLIP);
+  sprites.push_back(sprite);
+  slotOwners.push_back(id);
+  return id;
+}
+
+void AnimationSystem::Remove(AnimatorId id) {
+  const std::uint32_t slot{SlotOf(id)};
+  const std::size_t last{slotOwners.size() - 1};
+
+  auto moveLast = [slot, last](auto& values) {
+    values[slot] = values[last];
+    values.pop_back();
+  };
+  moveLast(timers);
+  moveLast(delays);
+  moveLast(rates);
+  moveLast(pending);
+  moveLast(frames);
+  moveLast(frameCounts);
+  moveLast(firstFrames);
+  moveLast(dirty);
+  moveLast(paused);
+  moveLast(looping);
+  moveLast(finished);
+  moveLast(throttled);
+  moveLast(due);
+  moveLast(clips);
+  moveLast(sprites);
+  moveLast(slotOwners);
+
+  if (slot < slotOwners.size()) slotOfId[slotOwners[slot]] = slot;
+  freeIds.push_back(id);
+}
+
+void AnimationSystem::Play(AnimatorId id, AnimationClipHandle clip,
+                           bool loop) {
+  const std::uint32_t slot{SlotOf(id)};
+  if (clips[slot] == clip && looping[slot] == loop && !finished[slot]) return;
+  Expects(clip != INVALID_ANIMATION_CLIP);
+
+  const AnimationClip& data{AnimationLibrary::GetClip(clip)};
+  clips[slot] = clip;
+  firstFrames[slot] = data.firstFrame;
+  frameCounts[slot] = std::max<std::int32_t>(1, data.frameCount);
+  delays[slot] = std::max(MIN_FRAME_DELAY, data.frameDelay);
+  timers[slot] = 0.f;
+  frames[slot] = 0;
+  looping[slot] = loop ? 1 : 0;
+  finished[slot] = 0;
+  dirty[slot] = 1;
+  RefreshRate(slot);
+}
+
+AnimationClipHandle AnimationSystem::GetClip(AnimatorId id) const {
+  return clips[SlotOf(id)];
+}
+
+int AnimationSystem::GetFrameIndex(AnimatorId id) const {
+  return frames[SlotOf(id)];
+}
+
+bool AnimationSystem::IsFinished(AnimatorId id) const {
+  return finished[SlotOf(id)] != 0;
+}
+
+void AnimationSystem::SetPaused(AnimatorId id, bool paused) {
+  const std::uint32_t slot{SlotOf(id)};
+  this->paused[slot] = paused ? 1 : 0;
+  // Dormant time is dropped, not caught up
+  if (paused) pending[slot] = 0.f;
+  RefreshRate(slot);
+}
+
+void AnimationSystem::SetThrottled(AnimatorId id, bool throttled) {
+  this->throttled[SlotOf(id)] = throttled ? 1 : 0;
+}
+
+void AnimationSystem::MarkDue(AnimatorId id) { due[SlotOf(id)] = 1; }
+
+void AnimationSystem::RefreshRate(std::uint32_t slot) {
+  const bool playing{clips[slot] != INVALID_ANIMATION_CLIP && !paused[slot]};
+  rates[slot] = playing ? 1.f : 0.f;
+}
+
+void AnimationSystem::RefreshClips() {
+  for (std::size_t slot{}; slot < slotOwners.size(); ++slot) {
+    if (clips[slot] == INVALID_ANIMATION_CLIP) continue;
+    const AnimationClip& data{AnimationLibrary::GetClip(clips[slot])};
+    firstFrames[slot] = data.firstFrame;
+    frameCounts[slot] = std::max<std::int32_t>(1, data.frameCount);
+    delays[slot] = std::max(MIN_FRAME_DELAY, data.frameDelay);
+    frames[slot] = std::min(frames[slot], frameCounts[slot] - 1);
+    timers[slot] = std::min(timers[slot], delays[slot]);
+    dirty[slot] = 1;
+  }
+}
+
+void AnimationSystem::Update(float deltaTime) {
+  const std::size_t count{slotOwners.size()};
+  float* timer{timers.data()};
+  const float* delay{delays.data()};
+  const float* rate{rates.data()};
+  float* banked{pending.data()};
+  const std::uint8_t* throttle{throttled.data()};
+  std::uint8_t* runs{due.data()};
+  std::int32_t* frame{frames.data()};
+  const std::int32_t* frameCount{frameCounts.data()};
+  std::uint8_t* changed{dirty.data()};
+  const std::uint8_t* loops{looping.data()};
+  std::uint8_t* done{finished.data()};
+
+  // Branch-free so the compiler can vectorize it. A step longer than a whole
+  // loop of the clip is clamped to one loop; phase is meaningless by then.
+  for (std::size_t i{}; i < count; ++i) {
+    // A throttled animator off its update banks the time instead
+    const float elapsed{banked[i] + deltaTime * rate[i]};
+    const float run{static_cast<float>(1 - throttle[i] * (1 - runs[i]))};
+    banked[i] = elapsed * (1.f - run);
+    runs[i] = 0;
+    const float time{timer[i] + elapsed * run};
+    const float loop{static_cast<float>(frameCount[i])};
+    const std::int32_t advance{
+        static_cast<std::int32_t>(std::min(time / delay[i], loop))};
+    const float remainder{time - static_cast<float>(advance) * delay[i]};
+    timer[i] = std::clamp(remainder, 0.f, delay[i]);
+    const std::int32_t next{frame[i] + advance};
+    // Looping clips wrap, one-shot clips hold their last frame; selected
+    // with 0/1 arithmetic rather than branches
+    const std::int32_t pastEnd{next >= frameCount[i]};
+    const std::int32_t loopFlag{loops[i]};
+    const std::int32_t wrapped{next - pastEnd * frameCount[i]};
+    const std::int32_t held{next - pastEnd * (next - frameCount[i] + 1)};
+    const std::int32_t current{loopFlag * wrapped + (1 - loopFlag) * held};
+    changed[i] |= static_cast<std::uint8_t>(current != frame[i]);
+    done[i] |= static_cast<std::uint8_t>(pastEnd & (1 - loopFlag));
+    frame[i] = current;
+  }
+
+  int touched{};
+  for (std::size_t i{}; i < count; ++i) {
+    if (!changed[i]) continue;
+    changed[i] = 0;
+    if (!sprites[i]) continue;
+    sprites[i]->SetTextureRect(AnimationLibrary::GetFrame(
+        firstFrames[i] + static_cast<std::uint32_t>(frame[i])));
+    ++touched;
+  }
+  touchedLastUpdate = touched;
+}
+
+int AnimationSystem::GetAnimatorCount() const {
+  return gsl::narrow_cast<int>(slotOwners.size());
+}
+
+int AnimationSystem::GetTouchedCount() const { return touchedLastUpdate; }
@@ -0,0 +1,537 @@
+// Asset cooker: turns the sources under an asset directory into the
+// runtime formats in CookedAssets.hh (decoded textures, flat tile maps,
+// binary animation clips) under <dir>/cooked/, plus a manifest the game
+// loads instead of parsing sources.
+//
+// Incremental: every source is content-hashed (skipped when its size and
+// time match the manifest), and an asset is cooked again only when the hash
+// of its source and dependencies (a map's tilesets) changed. Work runs on a
+// JobSystem in two waves, textures first, since cooking a map reads its
+// tilesets' cooked headers.
+//
+// Usage: AssetCooker [--force] [--jobs <n>] <assets dir>
+
+#include <json/json.h>
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Constants.hh"
+#include "CookedAssets.hh"
+#include "JobSystem.hh"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+enum class CookStatus { UpToDate, Cooked, Skipped, Failed };
+
+struct Source {
+  std::string name;  // relative to the asset directory's parent
+  fs::path path;
+  CookedKind kind{};
+  std::int64_t size{};
+  std::int64_t time{};
+  std::uint64_t hash{};
+  const ManifestRecord* previous{};
+
+  CookStatus status{CookStatus::UpToDate};
+  ManifestRecord record;
+  std::vector<std::string> messages;  // printed once the wave is done
+};
+
+struct Cooker {
+  fs::path base;  // the asset directory's parent; names are relative to it
+  std::string rootName;
+  std::unordered_map<std::string, Source*> byName;
+
+  fs::path PathOf(const std::string& name) const { return base / name; }
+
+  std::string CookedName(const Source& source) const {
+    static constexpr const char* EXTENSIONS[]{".tex", ".map", ".clip"};
+    const std::string relative{source.name.substr(rootName.size() + 1)};
+    return rootName + '/' + COOKED_DIRECTORY + '/' + relative +
+           EXTENSIONS[static_cast<std::size_t>(source.kind)];
+  }
+
+  std::uint64_t HashOf(const std::string& name) const {
+    const auto it{byName.find(name)};
+    return it == byName.end() ? 0 : it->second->hash;
+  }
+
+  // Changes with the cooker version, the source and any dependency
+  std::uint64_t ComputeKey(const Source& source,
+                           const std::vector<std::string>& dependencies) const {
+    using CookedManifest::Hash;
+    std::uint64_t key{Hash(&COOKED_VERSION, sizeof(COOKED_VERSION))};
+    key = Hash(&source.kind, sizeof(source.kind), key);
+    key = Hash(&source.hash, sizeof(source.hash), key);
+    for (const std::string& dependency : dependencies) {
+      const std::uint64_t hash{HashOf(dependency)};
+      key = Hash(dependency.data(), dependency.size(), key);
+      key = Hash(&hash, sizeof(hash), key);
+    }
+    return key;
+  }
+};
+
+std::optional<CookedKind> Classify(const fs::path& relative) {
+  std::string extension{relative.extension().string()};
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  const std::string top{relative.begin()->string()};
+  if (extension == ".png") return CookedKind::Texture;
+  if (extension == ".json" && top == "maps") return CookedKind::Map;
+  if (extension == ".json" && top == "animations") return CookedKind::Clip;
+  return std::nullopt;
+}
+
+bool ReadFile(const fs::path& path, std::string& bytes) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;
+  const std::streamsize size{in.tellg()};
+  if (size < 0) return false;
+  bytes.resize(static_cast<std::size_t>(size));
+  in.seekg(0);
+  return static_cast<bool>(in.read(bytes.data(), size));
+}
+
+// Through a temporary and a rename, so a running game never sees half a file
+bool WriteFile(const fs::path& path, const std::string& bytes) {
+  std::error_code ec;
+  fs::create_directories(path.parent_path(), ec);
+  fs::path temporary{path};
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.write(bytes.data(),
+                   static_cast<std::streamsize>(bytes.size()))) {
+      return false;
+    }
+  }
+  fs::rename(temporary, path, ec);
+  return !ec;
+}
+
+template <typename T>
+void Append(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool ParseJson(const Source& source, Json::Value& root, std::string& error) {
+  std::string text;
+  if (!ReadFile(source.path, text)) {
+    error = "can't read the file";
+    return false;
+  }
+  Json::CharReaderBuilder builder;
+  builder["collectComments"] = false;
+  const std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+  return reader->parse(text.data(), text.data() + text.size(), &root, &error);
+}
+
+bool CookTexture(const Source& source, std::string& out, std::string& error) {
+  sf::Image image;
+  if (!image.loadFromFile(source.path)) {
+    error = "can't decode the image";
+    return false;
+  }
+  const sf::Vector2u size{image.getSize()};
+  CookedTextureHeader header{};
+  std::memcpy(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic));
+  header.version = COOKED_VERSION;
+  header.width = size.x;
+  header.height = size.y;
+  Append(out, header);
+  out.append(reinterpret_cast<const char*>(image.getPixelsPtr()),
+             std::size_t{size.x} * size.y * 4);
+  return true;
+}
+
+// Pixel size of a tileset's cooked texture, or nullopt if it has none
+std::optional<sf::Vector2u> ReadTextureSize(const Cooker& cooker,
+                                            const std::string& name) {
+  const auto it{cooker.byName.find(name)};
+  if (it == cooker.byName.end() || it->second->kind != CookedKind::Texture ||
+      it->second->status == CookStatus::Failed) {
+    return std::nullopt;
+  }
+  std::ifstream in(cooker.PathOf(cooker.CookedName(*it->second)),
+                   std::ios::binary);
+  CookedTextureHeader header{};
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return std::nullopt;
+  }
+  return sf::Vector2u(header.width, header.height);
+}
+
+bool CookMap(const Cooker& cooker, Source& source, std::string& out,
+             std::string& error) {
+  Json::Value root;
+  if (!ParseJson(source, root, error)) return false;
+  // Layered maps list layers; older ones are a single layer at the root
+  std::vector<const Json::Value*> layerJsons;
+  if (root["layers"].isArray()) {
+    for (const Json::Value& layer : root["layers"]) {
+      layerJsons.push_back(&layer);
+    }
+  } else {
+    layerJsons.push_back(&root);
+  }
+
+  std::string layers;
+  std::uint32_t layerCount{};
+  std::vector<std::string>& dependencies{source.record.dependencies};
+  for (const Json::Value* layerJson : layerJsons) {
+    const Json::Value& grid{(*layerJson)["grid"]};
+    if (!grid.isArray() || grid.empty() || !grid[0].isArray() ||
+        grid[0].empty()) {
+      continue;  // skipped at runtime as well
+    }
+    const std::string tileset{(*layerJson).get("tileset", "").asString()};
+    CookedMapLayer layer{};
+    layer.tileWidth = (*layerJson).get("tileW", 0).asUInt();
+    layer.tileHeight = (*layerJson).get("tileH", 0).asUInt();
+    layer.rows = grid.size();
+    for (const Json::Value& row : grid) {
+      layer.columns = std::max(layer.columns, row.size());
+    }
+    layer.tilesetLength = static_cast<std::uint32_t>(tileset.size());
+
+    // Tiles past the tileset's edge would draw garbage; catch them here
+    const std::string tilesetName{
+        fs::path(tileset.empty() ? ASSETS_TILES : tileset)
+            .lexically_normal()
+            .generic_string()};
+    if (std::find(dependencies.begin(), dependencies.end(), tilesetName) ==
+        dependencies.end()) {
+      dependencies.push_back(tilesetName);
+    }
+    const std::optional<sf::Vector2u> tilesetSize{
+        ReadTextureSize(cooker, tilesetName)};
+    const std::string where{"layer " + std::to_string(layerCount) + ": "};
+    if (!tilesetSize) {
+      source.messages.push_back(where + "tileset " + tilesetName +
+                                " isn't a cooked texture; cells unchecked");
+    }
+    const auto tileSize{static_cast<std::uint32_t>(GameConstants::TILE_SIZE)};
+    const std::uint32_t tileW{layer.tileWidth ? layer.tileWidth : tileSize};
+    const std::uint32_t tileH{layer.tileHeight ? layer.tileHeight : tileSize};
+
+    Append(layers, layer);
+    layers += tileset;
+    int outside{};
+    for (const Json::Value& row : grid) {
+      for (Json::ArrayIndex x{}; x < layer.columns; ++x) {
+        CookedMapCell cell{};
+        const Json::Value& value{row.isArray() && x < row.size()
+                                     ? row[x]
+                                     : Json::Value::nullSingleton()};
+        if (value.isArray() && value.size() == 2) {
+          const int column{value[0].asInt()};
+          const int tileRow{value[1].asInt()};
+          constexpr int MAX_CELL{std::numeric_limits<std::uint16_t>::max()};
+          if (column < 0 || tileRow < 0 || column > MAX_CELL ||
+              tileRow > MAX_CELL) {
+            error = where + "cell out of range";
+            return false;
+          }
+          cell.column = static_cast<std::uint16_t>(column);
+          cell.row = static_cast<std::uint16_t>(tileRow);
+        }
+        const bool empty{cell.column == 0 && cell.row == 0};
+        if (!empty && tilesetSize &&
+            ((cell.column + 1u) * tileW > tilesetSize->x ||
+             (cell.row + 1u) * tileH > tilesetSize->y)) {
+          ++outside;
+        }
+        Append(layers, cell);
+      }
+    }
+    if (outside > 0) {
+      source.messages.push_back(where + std::to_string(outside) +
+                                " cells outside tileset " + tilesetName);
+    }
+    ++layerCount;
+  }
+  if (layerCount == 0) {
+    error = "no layer has a grid";
+    return false;
+  }
+
+  CookedMapHeader header{};
+  std::memcpy(header.magic, COOKED_MAP_MAGIC, sizeof(header.magic));
+  header.version = COOKED_VERSION;
+  header.layerCount = layerCount;
+  Append(out, header);
+  out += layers;
+  return true;
+}
+
+// False with an empty 'error' for JSON that isn't a clip (state machines)
+bool CookClip(const Source& source, std::string& out, std::string& error) {
+  Json::Value root;
+  if (!ParseJson(source, root, error)) return false;
+  const Json::Value& animation{root["animation"]};
+  if (!animation.isObject()) return false;
+
+  CookedClip clip{};
+  std::memcpy(clip.magic, COOKED_CLIP_MAGIC, sizeof(clip.magic));
+  clip.version = COOKED_VERSION;
+  clip.startFrame = animation["startFrame"].asInt();
+  clip.endFrame = animation["endFrame"].asInt();
+  clip.row = animation["row"].asInt();
+  clip.delay = animation["delay"].asFloat();
+  if (clip.startFrame < 0 || clip.endFrame < clip.startFrame) {
+    error = "invalid frame range";
+    return false;
+  }
+  Append(out, clip);
+  return true;
+}
+
+void Cook(const Cooker& cooker, Source& source) {
+  ManifestRecord& record{source.record};
+  record.kind = source.kind;
+  record.sourceHash = source.hash;
+  record.sourceSize = source.size;
+  record.sourceTime = source.time;
+  record.source = source.name;
+  record.dependencies.clear();
+
+  std::string out;
+  std::string error;
+  bool cooked{};
+  try {
+    switch (source.kind) {
+      case CookedKind::Texture:
+        cooked = CookTexture(source, out, error);
+        break;
+      case CookedKind::Map:
+        cooked = CookMap(cooker, source, out, error);
+        break;
+      case CookedKind::Clip:
+        cooked = CookClip(source, out, error);
+        break;
+      case CookedKind::Count:
+        break;
+    }
+  } catch (const std::exception& e) {
+    // jsoncpp throws on values of the wrong type
+    cooked = false;
+    error = e.what();
+  }
+  // Dependencies are only known now, so the key is computed after cooking
+  record.key = cooker.ComputeKey(source, record.dependencies);
+  if (!cooked && error.empty()) {
+    record.cooked.clear();
+    source.status = CookStatus::Skipped;
+    return;
+  }
+  record.cooked = cooker.CookedName(source);
+  if (cooked && !WriteFile(cooker.PathOf(record.cooked), out)) {
+    error = "can't write " + record.cooked;
+    cooked = false;
+  }
+  if (!cooked) {
+    source.messages.push_back("error: " + error);
+    source.status = CookStatus::Failed;
+    return;
+  }
+  source.status = CookStatus::Cooked;
+}
+
+bool IsUpToDate(const Cooker& cooker, const Source& source) {
+  const ManifestRecord* previous{source.previous};
+  if (!previous || previous->kind != source.kind ||
+      previous->sourceHash != source.hash ||
+      previous->key != cooker.ComputeKey(source, previous->dependencies)) {
+    return false;
+  }
+  std::error_code ec;
+  return previous->cooked.empty() ||
+         fs::exists(cooker.PathOf(previous->cooked), ec);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool force{};
+  unsigned workers{JobSystem::DefaultWorkerCount()};
+  std::string input;
+  for (int i{1}; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--force") == 0) {
+      force = true;
+    } else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+      // The calling thread cooks too
+      workers = static_cast<unsigned>(
+          std::max(1, std::atoi(argv[++i])) - 1);
+    } else if (input.empty() && argv[i][0] != '-') {
+      input = argv[i];
+    } else {
+      input.clear();
+      break;
+    }
+  }
+  if (input.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--force] [--jobs <n>] <assets dir>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto start{std::chrono::steady_clock::now()};
+  std::error_code ec;
+  fs::path root{fs::absolute(input, ec).lexically_normal()};
+  if (!root.has_filename()) root = root.parent_path();  // trailing '/'
+  if (!fs::is_directory(root, ec)) {
+    std::cerr << "Not a directory: " << input << std::endl;
+    return EXIT_FAILURE;
+  }
+  Cooker cooker;
+  cooker.base = root.parent_path();
+  cooker.rootName = root.filename().generic_string();
+  const fs::path cookedRoot{root / COOKED_DIRECTORY};
+  const fs::path manifestPath{cookedRoot / COOKED_MANIFEST};
+
+  std::unordered_map<std::string, ManifestRecord> previous;
+  if (std::ifstream in{manifestPath}) {
+    std::string line;
+    ManifestRecord record;
+    while (std::getline(in, line)) {
+      if (CookedManifest::Parse(line, record)) {
+        previous.insert_or_assign(record.source, record);
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Source>> sources;
+  for (auto it = fs::recursive_directory_iterator(root, ec);
+       !ec && it != fs::end(it); it.increment(ec)) {
+    if (it->path() == cookedRoot) {
+      it.disable_recursion_pending();
+      continue;
+    }
+    if (!it->is_regular_file(ec)) continue;
+    const fs::path relative{fs::relative(it->path(), root, ec)};
+    const std::optional<CookedKind> kind{Classify(relative)};
+    if (!kind) continue;
+    auto source{std::make_unique<Source>()};
+    source->name = cooker.rootName + '/' + relative.generic_string();
+    source->path = it->path();
+    source->kind = *kind;
+    source->size = static_cast<std::int64_t>(it->file_size(ec));
+    source->time = it->last_write_time(ec).time_since_epoch().count();
+    if (const auto found{previous.find(source->name)};
+        found != previous.end()) {
+      source->previous = &found->second;
+    }
+    cooker.byName.emplace(source->name, source.get());
+    sources.push_back(std::move(source));
+  }
+  if (ec) {
+    std::cerr << "Failed to scan " << root << ": " << ec.message()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::sort(sources.begin(), sources.end(),
+            [](const auto& a, const auto& b) { return a->name < b->name; });
+
+  JobSystem jobs(workers);
+  // Content hashes, reusing the manifest's for files that weren't touched
+  std::vector<Source*> toHash;
+  for (const auto& source : sources) {
+    const ManifestRecord* old{source->previous};
+    if (old && old->sourceSize == source->size &&
+        old->sourceTime == source->time) {
+      source->hash = old->sourceHash;
+    } else {
+      toHash.push_back(source.get());
+    }
+  }
+  jobs.ParallelFor(toHash.size(), [&](std::size_t i) {
+    std::string bytes;
+    if (ReadFile(toHash[i]->path, bytes)) {
+      toHash[i]->hash = CookedManifest::Hash(bytes.data(), bytes.size());
+    }
+  });
+
+  // Two waves, textures first: maps read their tilesets' cooked headers
+  int cookedCount{};
+  int failedCount{};
+  int skippedCount{};
+  for (const bool textures : {true, false}) {
+    std::vector<Source*> dirty;
+    for (const auto& source : sources) {
+      if ((source->kind == CookedKind::Texture) != textures) continue;
+      if (!force && IsUpToDate(cooker, *source)) {
+        source->record = *source->previous;
+        source->record.sourceSize = source->size;
+        source->record.sourceTime = source->time;
+        if (source->record.cooked.empty()) ++skippedCount;
+      } else {
+        dirty.push_back(source.get());
+      }
+    }
+    jobs.ParallelFor(dirty.size(),
+                     [&](std::size_t i) { Cook(cooker, *dirty[i]); });
+    for (const Source* source : dirty) {
+      for (const std::string& message : source->messages) {
+        std::cout << source->name << ": " << message << std::endl;
+      }
+      cookedCount += source->status == CookStatus::Cooked;
+      failedCount += source->status == CookStatus::Failed;
+      skippedCount += source->status == CookStatus::Skipped;
+    }
+  }
+
+  // Outputs whose source is gone, failed or no longer cooks to them
+  std::unordered_set<std::string> kept;
+  for (const auto& source : sources) {
+    if (source->status != CookStatus::Failed) {
+      kept.insert(source->record.cooked);
+    }
+  }
+  for (const auto& [name, record] : previous) {
+    if (!record.cooked.empty() && !kept.contains(record.cooked)) {
+      fs::remove(cooker.PathOf(record.cooked), ec);
+    }
+  }
+
+  std::string manifest{"# BlackEngine cooked assets, version "};
+  manifest += std::to_string(COOKED_VERSION) + '\n';
+  for (const auto& source : sources) {
+    if (source->status == CookStatus::Failed) continue;
+    manifest += CookedManifest::Format(source->record);
+    manifest += '\n';
+  }
+  if (!WriteFile(manifestPath, manifest)) {
+    std::cerr << "Failed to write " << manifestPath << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start)};
+  const int upToDate{static_cast<int>(sources.size()) - cookedCount -
+                     failedCount - skippedCount};
+  std::cout << "Cooked " << cookedCount << ", up to date " << upToDate
+            << ", not cookable " << skippedCount << ", failed "
+            << failedCount << " (" << sources.size() << " sources, "
+            << toHash.size() << " hashed) in " << elapsed.count() << " ms on "
+            << jobs.GetWorkerCount() + 1 << " threads" << std::endl;
+  return failedCount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
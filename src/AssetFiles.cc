@@ -0,0 +1,213 @@
+#include "AssetFiles.hh"
+
+#include <json/json.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "AssetPack.hh"
+#include "Log.hh"
+
+namespace {
+
+// Whether paths missing from a mounted pack may still come from disk
+#ifdef NDEBUG
+constexpr bool LOOSE_FALLBACK{false};
+#else
+constexpr bool LOOSE_FALLBACK{true};
+#endif
+
+struct FilesState {
+  AssetPack pack;
+  std::atomic<std::int64_t> packReads{};
+  std::atomic<std::int64_t> looseReads{};
+  std::atomic<std::int64_t> decompressedBytes{};
+  // PreferLoose paths; the flag keeps reads lock-free until there are any
+  std::mutex looseMutex;
+  std::unordered_set<std::string> loosePaths;
+  std::atomic<bool> hasLoosePaths{};
+};
+
+FilesState& State() {
+  static FilesState state;
+  return state;
+}
+
+// "./assets/maps/../maps/a.json" -> "assets/maps/a.json", as stored in packs
+std::string Normalize(std::string_view path) {
+  return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+bool UseLooseFiles() { return !State().pack.IsOpen() || LOOSE_FALLBACK; }
+
+bool PrefersLoose(const std::string& normalized) {
+  FilesState& state{State()};
+  if (!state.hasLoosePaths.load(std::memory_order_acquire)) return false;
+  std::lock_guard<std::mutex> lock(state.looseMutex);
+  return state.loosePaths.contains(normalized);
+}
+
+AssetData ReadLoose(const std::string& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return {};
+  const std::streamsize size{in.tellg()};
+  if (size < 0) return {};
+  std::vector<std::byte> bytes(static_cast<std::size_t>(size));
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(bytes.data()), size)) return {};
+  State().looseReads.fetch_add(1, std::memory_order_relaxed);
+  return AssetData::Own(std::move(bytes));
+}
+
+}  // namespace
+
+AssetData AssetData::View(std::span<const std::byte> bytes) {
+  AssetData result;
+  result.data = bytes.data();
+  result.size = bytes.size();
+  result.found = true;
+  return result;
+}
+
+AssetData AssetData::Own(std::vector<std::byte> bytes) {
+  AssetData result;
+  result.owned = std::move(bytes);
+  result.data = result.owned.data();
+  result.size = result.owned.size();
+  result.found = true;
+  return result;
+}
+
+bool AssetFiles::Mount(const std::string& packPath) {
+  FilesState& state{State()};
+  if (!std::filesystem::exists(packPath)) {
+    BEP_LOG_INFO(LogCategory::Assets, "No {}; reading loose asset files",
+                 packPath);
+    return false;
+  }
+  if (!state.pack.Open(packPath)) return false;
+  BEP_LOG_INFO(LogCategory::Assets, "Mounted {}: {} assets", packPath,
+               state.pack.GetEntries().size());
+  return true;
+}
+
+void AssetFiles::Unmount() { State().pack.Close(); }
+
+bool AssetFiles::IsMounted() { return State().pack.IsOpen(); }
+
+AssetData AssetFiles::Read(std::string_view path) {
+  FilesState& state{State()};
+  const std::string normalized{Normalize(path)};
+  if (state.pack.IsOpen() && PrefersLoose(normalized)) {
+    if (AssetData loose{ReadLoose(normalized)}) return loose;
+  }
+  if (state.pack.IsOpen()) {
+    if (const PackEntry* entry{state.pack.Find(normalized)}) {
+      state.packReads.fetch_add(1, std::memory_order_relaxed);
+      const std::span<const std::byte> stored{state.pack.GetStored(*entry)};
+      if (entry->compression == PackCompression::None) {
+        return AssetData::View(stored);
+      }
+      std::vector<std::byte> bytes(static_cast<std::size_t>(entry->size));
+      if (!PackCodec::Decompress(stored, bytes)) {
+        BEP_LOG_ERROR(LogCategory::Assets, "Corrupt packed asset: {}",
+                      normalized);
+        return {};
+      }
+      state.decompressedBytes.fetch_add(
+          static_cast<std::int64_t>(bytes.size()), std::memory_order_relaxed);
+      return AssetData::Own(std::move(bytes));
+    }
+  }
+  if (!UseLooseFiles()) return {};
+  return ReadLoose(normalized);
+}
+
+bool AssetFiles::Exists(std::string_view path) {
+  const std::string normalized{Normalize(path)};
+  if (IsMounted() && State().pack.Find(normalized)) return true;
+  std::error_code ec;
+  return (UseLooseFiles() || PrefersLoose(normalized)) &&
+         std::filesystem::is_regular_file(normalized, ec);
+}
+
+bool AssetFiles::IsLoose(std::string_view path) {
+  FilesState& state{State()};
+  const std::string normalized{Normalize(path)};
+  std::error_code ec;
+  const bool onDisk{std::filesystem::is_regular_file(normalized, ec)};
+  if (!state.pack.IsOpen()) return onDisk;
+  if (PrefersLoose(normalized) && onDisk) return true;
+  if (state.pack.Find(normalized)) return false;
+  return LOOSE_FALLBACK && onDisk;
+}
+
+void AssetFiles::PreferLoose(std::string_view path) {
+  FilesState& state{State()};
+  std::lock_guard<std::mutex> lock(state.looseMutex);
+  state.loosePaths.insert(Normalize(path));
+  state.hasLoosePaths.store(true, std::memory_order_release);
+}
+
+std::string AssetFiles::FindNewest(std::string_view directory,
+                                   std::string_view extension) {
+  namespace fs = std::filesystem;
+  const std::string prefix{Normalize(directory) + '/'};
+  const AssetPack& pack{State().pack};
+  std::string best;
+  if (pack.IsOpen()) {
+    std::int64_t bestTime{};
+    for (const PackEntry& entry : pack.GetEntries()) {
+      const std::string_view path{pack.GetPath(entry)};
+      // Direct children only, like a directory listing
+      if (!path.starts_with(prefix) || !path.ends_with(extension) ||
+          path.find('/', prefix.size()) != std::string_view::npos) {
+        continue;
+      }
+      if (best.empty() || entry.modifiedTime > bestTime) {
+        best = path;
+        bestTime = entry.modifiedTime;
+      }
+    }
+    if (!best.empty() || !LOOSE_FALLBACK) return best;
+  }
+
+  std::error_code ec;
+  fs::file_time_type bestTime{};
+  for (auto it = fs::directory_iterator(prefix, ec); !ec && it != fs::end(it);
+       it.increment(ec)) {
+    const fs::directory_entry& entry{*it};
+    if (!entry.is_regular_file(ec) ||
+        entry.path().extension().string() != extension) {
+      continue;
+    }
+    const auto time{entry.last_write_time(ec)};
+    if (!ec && (best.empty() || time > bestTime)) {
+      best = entry.path().generic_string();
+      bestTime = time;
+    }
+  }
+  return best;
+}
+
+bool AssetFiles::ParseJson(const AssetData& data, Json::Value& root,
+                           std::string& errors) {
+  Json::CharReaderBuilder builder;
+  builder["collectComments"] = false;
+  const std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+  const std::string_view text{data.GetText()};
+  return reader->parse(text.data(), text.data() + text.size(), &root,
+                       &errors);
+}
+
+AssetFilesStats AssetFiles::GetStats() {
+  const FilesState& state{State()};
+  return AssetFilesStats{
+      state.packReads.load(std::memory_order_relaxed),
+      state.looseReads.load(std::memory_order_relaxed),
+      state.decompressedBytes.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,282 @@
+#include "AssetPack.hh"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Log.hh"
+
+namespace {
+
+// Codec parameters. A token byte holds the literal run length in its high
+// nibble and the match length minus MIN_MATCH in its low one; 15 means more
+// length bytes follow (255 continues, anything less ends).
+constexpr std::size_t MIN_MATCH{4};
+constexpr std::size_t MAX_OFFSET{65535};
+// The tail is always literals, so a match never runs to the end
+constexpr std::size_t TAIL_LITERALS{8};
+constexpr int HASH_BITS{14};
+
+std::uint32_t Read32(const std::byte* at) {
+  std::uint32_t value;
+  std::memcpy(&value, at, sizeof(value));
+  return value;
+}
+
+std::uint32_t Hash(std::uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void WriteLength(std::vector<std::byte>& out, std::size_t length) {
+  while (length >= 255) {
+    out.push_back(std::byte{255});
+    length -= 255;
+  }
+  out.push_back(static_cast<std::byte>(length));
+}
+
+void WriteSequence(std::vector<std::byte>& out,
+                   std::span<const std::byte> literals, std::size_t offset,
+                   std::size_t matchLength) {
+  const std::size_t literalCode{std::min<std::size_t>(literals.size(), 15)};
+  const std::size_t matchCode{
+      matchLength ? std::min<std::size_t>(matchLength - MIN_MATCH, 15) : 0};
+  out.push_back(static_cast<std::byte>(literalCode << 4 | matchCode));
+  if (literalCode == 15) WriteLength(out, literals.size() - 15);
+  out.insert(out.end(), literals.begin(), literals.end());
+  if (matchLength == 0) return;  // last sequence
+  out.push_back(static_cast<std::byte>(offset & 0xFF));
+  out.push_back(static_cast<std::byte>(offset >> 8));
+  if (matchCode == 15) WriteLength(out, matchLength - MIN_MATCH - 15);
+}
+
+// Reads an extended length; false if the input ends first
+bool ReadLength(std::span<const std::byte> input, std::size_t& in,
+                std::size_t& length) {
+  while (true) {
+    if (in >= input.size()) return false;
+    const auto next{static_cast<std::size_t>(input[in++])};
+    length += next;
+    if (next != 255) return true;
+  }
+}
+
+}  // namespace
+
+namespace PackCodec {
+
+std::vector<std::byte> Compress(std::span<const std::byte> input) {
+  std::vector<std::byte> out;
+  out.reserve(input.size() / 2 + 16);
+  std::vector<std::uint32_t> table(std::size_t{1} << HASH_BITS, UINT32_MAX);
+
+  std::size_t anchor{};
+  std::size_t i{};
+  const std::size_t limit{
+      input.size() > TAIL_LITERALS ? input.size() - TAIL_LITERALS : 0};
+  while (i + MIN_MATCH <= limit) {
+    const std::uint32_t sequence{Read32(&input[i])};
+    std::uint32_t& slot{table[Hash(sequence)]};
+    const std::size_t candidate{slot};
+    slot = static_cast<std::uint32_t>(i);
+    if (candidate == UINT32_MAX || i - candidate > MAX_OFFSET ||
+        Read32(&input[candidate]) != sequence) {
+      ++i;
+      continue;
+    }
+    std::size_t length{MIN_MATCH};
+    while (i + length < limit &&
+           input[candidate + length] == input[i + length]) {
+      ++length;
+    }
+    WriteSequence(out, input.subspan(anchor, i - anchor), i - candidate,
+                  length);
+    i += length;
+    anchor = i;
+  }
+  WriteSequence(out, input.subspan(anchor), 0, 0);
+  return out;
+}
+
+bool Decompress(std::span<const std::byte> input,
+                std::span<std::byte> output) {
+  std::size_t in{};
+  std::size_t out{};
+  while (in < input.size()) {
+    const auto token{static_cast<std::size_t>(input[in++])};
+    std::size_t literals{token >> 4};
+    if (literals == 15 && !ReadLength(input, in, literals)) return false;
+    if (literals > input.size() - in || literals > output.size() - out) {
+      return false;
+    }
+    std::memcpy(output.data() + out, input.data() + in, literals);
+    in += literals;
+    out += literals;
+    if (in == input.size()) break;  // the last sequence has no match
+
+    if (input.size() - in < 2) return false;
+    const std::size_t offset{static_cast<std::size_t>(input[in]) |
+                             static_cast<std::size_t>(input[in + 1]) << 8};
+    in += 2;
+    std::size_t length{token & 15};
+    if (length == 15 && !ReadLength(input, in, length)) return false;
+    length += MIN_MATCH;
+    if (offset == 0 || offset > out || length > output.size() - out) {
+      return false;
+    }
+    // Byte by byte: the source may overlap what is being written
+    for (std::size_t k{}; k < length; ++k, ++out) {
+      output[out] = output[out - offset];
+    }
+  }
+  return out == output.size();
+}
+
+}  // namespace PackCodec
+
+AssetPack::~AssetPack() { Close(); }
+
+bool AssetPack::Open(const std::string& path) {
+  Close();
+#ifdef _WIN32
+  HANDLE file{CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr)};
+  if (file == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER size{};
+  HANDLE view{};
+  void* memory{};
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (view) memory = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+  }
+  if (!memory) {
+    if (view) CloseHandle(view);
+    CloseHandle(file);
+    BEP_LOG_ERROR(LogCategory::Assets, "Failed to map asset pack {}", path);
+    return false;
+  }
+  fileHandle = file;
+  mappingHandle = view;
+  mapping = static_cast<const std::byte*>(memory);
+  mappingSize = static_cast<std::size_t>(size.QuadPart);
+#else
+  const int fd{open(path.c_str(), O_RDONLY)};
+  if (fd < 0) return false;
+  struct stat info {};
+  void* memory{MAP_FAILED};
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    memory = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ,
+                  MAP_PRIVATE, fd, 0);
+  }
+  // The mapping keeps the file alive
+  close(fd);
+  if (memory == MAP_FAILED) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Failed to map asset pack {}", path);
+    return false;
+  }
+  mapping = static_cast<const std::byte*>(memory);
+  mappingSize = static_cast<std::size_t>(info.st_size);
+#endif
+
+  // Validate everything up front so lookups can trust the table
+  PackHeader header{};
+  if (mappingSize >= sizeof(header)) {
+    std::memcpy(&header, mapping, sizeof(header));
+  }
+  const std::uint64_t entriesBytes{std::uint64_t{header.entryCount} *
+                                   sizeof(PackEntry)};
+  const bool valid{
+      mappingSize >= sizeof(header) &&
+      std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 &&
+      header.version == PACK_VERSION &&
+      header.entriesOffset % alignof(PackEntry) == 0 &&
+      header.entriesOffset <= mappingSize &&
+      entriesBytes <= mappingSize - header.entriesOffset &&
+      header.namesOffset <= mappingSize &&
+      header.namesSize <= mappingSize - header.namesOffset};
+  if (!valid) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Not a version {} asset pack: {}",
+                  PACK_VERSION, path);
+    Close();
+    return false;
+  }
+  entries = std::span<const PackEntry>(
+      reinterpret_cast<const PackEntry*>(mapping + header.entriesOffset),
+      header.entryCount);
+  names = reinterpret_cast<const char*>(mapping + header.namesOffset);
+  for (const PackEntry& entry : entries) {
+    const bool inBounds{
+        entry.offset <= mappingSize &&
+        entry.storedSize <= mappingSize - entry.offset &&
+        std::uint64_t{entry.nameOffset} + entry.nameLength <=
+            header.namesSize &&
+        (entry.compression == PackCompression::None
+             ? entry.storedSize == entry.size
+             : entry.compression == PackCompression::Lz)};
+    if (!inBounds) {
+      BEP_LOG_ERROR(LogCategory::Assets, "Corrupt entry in asset pack {}",
+                    path);
+      Close();
+      return false;
+    }
+  }
+  if (!std::is_sorted(entries.begin(), entries.end(),
+                      [this](const PackEntry& a, const PackEntry& b) {
+                        return GetPath(a) < GetPath(b);
+                      })) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Unsorted table in asset pack {}",
+                  path);
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void AssetPack::Close() {
+  if (!mapping) return;
+#ifdef _WIN32
+  UnmapViewOfFile(mapping);
+  CloseHandle(static_cast<HANDLE>(mappingHandle));
+  CloseHandle(static_cast<HANDLE>(fileHandle));
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+#else
+  munmap(const_cast<std::byte*>(mapping), mappingSize);
+#endif
+  mapping = nullptr;
+  mappingSize = 0;
+  entries = {};
+  names = nullptr;
+}
+
+bool AssetPack::IsOpen() const { return mapping != nullptr; }
+
+const PackEntry* AssetPack::Find(std::string_view path) const {
+  const auto it{std::lower_bound(
+      entries.begin(), entries.end(), path,
+      [this](const PackEntry& entry, std::string_view key) {
+        return GetPath(entry) < key;
+      })};
+  if (it == entries.end() || GetPath(*it) != path) return nullptr;
+  return &*it;
+}
+
+std::span<const PackEntry> AssetPack::GetEntries() const { return entries; }
+
+std::string_view AssetPack::GetPath(const PackEntry& entry) const {
+  return std::string_view(names + entry.nameOffset, entry.nameLength);
+}
+
+std::span<const std::byte> AssetPack::GetStored(const PackEntry& entry) const {
+  return std::span<const std::byte>(mapping + entry.offset, entry.storedSize);
+}
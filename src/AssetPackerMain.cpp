@@ -0,0 +1,174 @@
+// Asset packer: walks an asset directory and writes every file into one
+// .bpak archive that the game memory-maps at startup (see AssetFiles), so a
+// cold start opens one file instead of one per texture, font and map.
+// Paths are stored relative to the directory's parent, so packing "assets"
+// yields "assets/sprites.png" just as the engine requests it.
+//
+// Usage: AssetPacker [--compress] <assets dir> <output.bpak>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AssetPack.hh"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Compressed blobs are only kept when they save at least this much
+constexpr double MAX_COMPRESSED_RATIO{0.9};
+
+struct SourceFile {
+  fs::path path;
+  std::string name;  // as stored in the archive
+};
+
+bool ReadFile(const fs::path& path, std::vector<std::byte>& bytes) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;
+  const std::streamsize size{in.tellg()};
+  if (size < 0) return false;
+  bytes.resize(static_cast<std::size_t>(size));
+  in.seekg(0);
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char*>(bytes.data()), size));
+}
+
+// Zero-fills 'out' up to the next multiple of 'alignment'
+void Pad(std::ofstream& out, std::uint64_t& position,
+         std::uint64_t alignment) {
+  static constexpr char ZEROS[PACK_ALIGNMENT]{};
+  const std::uint64_t padding{(alignment - position % alignment) % alignment};
+  out.write(ZEROS, static_cast<std::streamsize>(padding));
+  position += padding;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool compress{};
+  std::vector<std::string> positional;
+  for (int i{1}; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--compress") == 0) {
+      compress = true;
+    } else {
+      positional.emplace_back(argv[i]);
+    }
+  }
+  if (positional.size() != 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--compress] <assets dir> <output.bpak>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::error_code ec;
+  fs::path root{fs::absolute(positional[0], ec).lexically_normal()};
+  if (!root.has_filename()) root = root.parent_path();  // trailing '/'
+  const fs::path output{fs::absolute(positional[1], ec).lexically_normal()};
+  if (!fs::is_directory(root, ec)) {
+    std::cerr << "Not a directory: " << positional[0] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<SourceFile> files;
+  for (auto it = fs::recursive_directory_iterator(root, ec);
+       !ec && it != fs::end(it); it.increment(ec)) {
+    if (!it->is_regular_file(ec) || it->path() == output) continue;
+    files.push_back(SourceFile{
+        it->path(),
+        (root.filename() / fs::relative(it->path(), root)).generic_string()});
+  }
+  if (ec) {
+    std::cerr << "Failed to scan " << root << ": " << ec.message()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  // AssetPack::Find binary-searches the table by path
+  std::sort(files.begin(), files.end(),
+            [](const SourceFile& a, const SourceFile& b) {
+              return a.name < b.name;
+            });
+
+  std::ofstream out(output, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    std::cerr << "Failed to create " << positional[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  PackHeader header{};
+  std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+  header.version = PACK_VERSION;
+  header.entryCount = static_cast<std::uint32_t>(files.size());
+  // Rewritten with the final offsets once the blobs are out
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  std::uint64_t position{sizeof(header)};
+
+  std::vector<PackEntry> entries;
+  entries.reserve(files.size());
+  std::string names;
+  std::uint64_t sourceBytes{};
+  std::vector<std::byte> bytes;
+  for (const SourceFile& file : files) {
+    if (!ReadFile(file.path, bytes)) {
+      std::cerr << "Failed to read " << file.path << std::endl;
+      return EXIT_FAILURE;
+    }
+    PackEntry entry{};
+    entry.size = bytes.size();
+    entry.modifiedTime = static_cast<std::int64_t>(
+        fs::last_write_time(file.path, ec).time_since_epoch().count());
+    entry.nameOffset = static_cast<std::uint32_t>(names.size());
+    entry.nameLength = static_cast<std::uint32_t>(file.name.size());
+    names += file.name;
+
+    std::vector<std::byte> compressed;
+    if (compress && !bytes.empty()) {
+      compressed = PackCodec::Compress(bytes);
+    }
+    const bool useCompressed{
+        !compressed.empty() &&
+        compressed.size() < bytes.size() * MAX_COMPRESSED_RATIO};
+    const std::vector<std::byte>& stored{useCompressed ? compressed : bytes};
+    entry.compression =
+        useCompressed ? PackCompression::Lz : PackCompression::None;
+    entry.storedSize = stored.size();
+
+    Pad(out, position, PACK_ALIGNMENT);
+    entry.offset = position;
+    out.write(reinterpret_cast<const char*>(stored.data()),
+              static_cast<std::streamsize>(stored.size()));
+    position += stored.size();
+    sourceBytes += bytes.size();
+    entries.push_back(entry);
+  }
+
+  Pad(out, position, PACK_ALIGNMENT);
+  header.entriesOffset = position;
+  out.write(reinterpret_cast<const char*>(entries.data()),
+            static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+  position += entries.size() * sizeof(PackEntry);
+  header.namesOffset = position;
+  header.namesSize = names.size();
+  out.write(names.data(), static_cast<std::streamsize>(names.size()));
+  position += names.size();
+
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.close();
+  if (!out) {
+    std::cerr << "Failed to write " << positional[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Packed " << files.size() << " files from " << root << " ("
+            << sourceBytes << " bytes) into " << positional[1] << " ("
+            << position << " bytes)" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+#include "AssetWatcher.hh"
+
+#include <cstdint>
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include "Log.hh"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string Normalize(const fs::path& path) {
+  return path.lexically_normal().generic_string();
+}
+
+#ifdef __linux__
+// Written files, files renamed into place (editors saving atomically) and
+// new directories, which need watches of their own
+constexpr std::uint32_t WATCH_MASK{IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE};
+#endif
+
+}  // namespace
+
+AssetWatcher::~AssetWatcher() { Stop(); }
+
+bool AssetWatcher::Start(const std::string& directory) {
+  Stop();
+  std::error_code ec;
+  if (!fs::is_directory(directory, ec)) {
+    BEP_LOG_WARNING(LogCategory::Assets, "Can't watch {}: not a directory",
+                    directory);
+    return false;
+  }
+  root = Normalize(directory);
+  quit = false;
+  changed.clear();
+
+#ifdef __linux__
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (inotifyFd < 0 || wakeFd < 0) {
+    BEP_LOG_WARNING(LogCategory::Assets, "Can't watch {}: {}", root,
+                    std::strerror(errno));
+    Stop();
+    return false;
+  }
+  AddWatches(root);
+  BEP_LOG_INFO(LogCategory::Assets, "Watching {} ({} directories, inotify)",
+               root, directories.size());
+#else
+  Scan(false);
+  BEP_LOG_INFO(LogCategory::Assets, "Watching {} ({} files, polling)", root,
+               times.size());
+#endif
+
+  running = true;
+  watcher = std::thread(&AssetWatcher::WatchLoop, this);
+  return true;
+}
+
+void AssetWatcher::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    quit = true;
+  }
+  stopRequested.notify_all();
+#ifdef __linux__
+  if (wakeFd >= 0) {
+    const std::uint64_t one{1};
+    [[maybe_unused]] const auto written{write(wakeFd, &one, sizeof(one))};
+  }
+#endif
+  if (watcher.joinable()) watcher.join();
+  running = false;
+
+#ifdef __linux__
+  if (inotifyFd >= 0) close(inotifyFd);
+  if (wakeFd >= 0) close(wakeFd);
+  inotifyFd = -1;
+  wakeFd = -1;
+  directories.clear();
+#else
+  times.clear();
+#endif
+}
+
+bool AssetWatcher::IsRunning() const { return running; }
+
+void AssetWatcher::Poll(std::vector<std::string>& paths) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (changed.empty() ||
+      std::chrono::steady_clock::now() - lastChange < ASSET_WATCH_SETTLE_TIME) {
+    return;
+  }
+  paths.insert(paths.end(), changed.begin(), changed.end());
+  changed.clear();
+}
+
+void AssetWatcher::MarkChanged(std::string path) {
+  std::lock_guard<std::mutex> lock(mutex);
+  changed.insert(std::move(path));
+  lastChange = std::chrono::steady_clock::now();
+}
+
+#ifdef __linux__
+
+void AssetWatcher::AddWatches(const std::string& directory) {
+  auto add = [this](const std::string& path) {
+    const int wd{inotify_add_watch(inotifyFd, path.c_str(), WATCH_MASK)};
+    if (wd < 0) {
+      BEP_LOG_WARNING(LogCategory::Assets, "Can't watch {}: {}", path,
+                      std::strerror(errno));
+      return;
+    }
+    directories.insert_or_assign(wd, path);
+  };
+  add(directory);
+  std::error_code ec;
+  for (auto it = fs::recursive_directory_iterator(directory, ec);
+       !ec && it != fs::end(it); it.increment(ec)) {
+    if (it->is_directory(ec)) add(Normalize(it->path()));
+  }
+}
+
+void AssetWatcher::WatchLoop() {
+  // Large enough for a burst; inotify never splits an event across reads
+  alignas(inotify_event) char buffer[16 * 1024];
+  while (true) {
+    pollfd fds[2]{{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      BEP_LOG_ERROR(LogCategory::Assets, "Asset watcher stopped: {}",
+                    std::strerror(errno));
+      return;
+    }
+    if (fds[1].revents != 0) return;
+
+    const ssize_t length{read(inotifyFd, buffer, sizeof(buffer))};
+    if (length <= 0) continue;
+    for (ssize_t offset{}; offset < length;) {
+      const auto* event{
+          reinterpret_cast<const inotify_event*>(buffer + offset)};
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      if (event->mask & IN_Q_OVERFLOW) {
+        BEP_LOG_WARNING(LogCategory::Assets,
+                        "Asset watcher queue overflowed; some changes missed");
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        directories.erase(event->wd);
+        continue;
+      }
+      const auto directory{directories.find(event->wd)};
+      if (directory == directories.end() || event->len == 0) continue;
+      const std::string path{
+          Normalize(fs::path(directory->second) / event->name)};
+      if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) AddWatches(path);
+      } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+        MarkChanged(path);
+      }
+    }
+  }
+}
+
+#else
+
+void AssetWatcher::Scan(bool report) {
+  std::error_code ec;
+  for (auto it = fs::recursive_directory_iterator(root, ec);
+       !ec && it != fs::end(it); it.increment(ec)) {
+    if (!it->is_regular_file(ec)) continue;
+    const auto time{it->last_write_time(ec)};
+    if (ec) continue;
+    std::string path{Normalize(it->path())};
+    const auto [entry, added]{times.try_emplace(path, time)};
+    if (!added && entry->second == time) continue;
+    entry->second = time;
+    if (report) MarkChanged(std::move(path));
+  }
+}
+
+void AssetWatcher::WatchLoop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopRequested.wait_for(lock, ASSET_WATCH_POLL_INTERVAL,
+                                 [this] { return quit; })) {
+    // MarkChanged takes the lock itself
+    lock.unlock();
+    Scan(true);
+    lock.lock();
+  }
+}
+
+#endif
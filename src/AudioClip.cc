@@ -1,137 +1,111 @@
 #include "AudioClip.hh"
 
 #include <gsl/assert>
-#include <iostream>
 #include <memory>
 
-AudioClip::AudioClip() {
+#include "Log.hh"
+
 #ifdef SFML_AUDIO_AVAILABLE
-  sound = nullptr;
-  buffer = nullptr;
+#include "SoundBufferCache.hh"
 #endif
-}
-
-AudioClip::AudioClip(const char* audioUrl) {
-  this->audioUrl = audioUrl;
 
-#ifdef SFML_AUDIO_AVAILABLE
-  sound = nullptr;
-  buffer = nullptr;
+AudioClip::AudioClip() {}
 
+AudioClip::AudioClip(const char* audioUrl) {
   if (!audioUrl) {
-    std::cerr << "AudioClip: audioUrl is null" << std::endl;
+    BEP_LOG_ERROR(LogCategory::Audio, "AudioClip: audioUrl is null");
     return;
   }
+  this->audioUrl = audioUrl;
 
-  try {
-    buffer = std::make_unique<sf::SoundBuffer>();
-    if (!buffer) {
-      std::cerr << "Failed to create SFML SoundBuffer object" << std::endl;
-      return;
-    }
-    if (!buffer->loadFromFile(audioUrl)) {
-      std::cerr << "Failed to load audio file: " << audioUrl << std::endl;
-      buffer.reset();
-      return;
-    }
-    sound = std::make_unique<sf::Sound>(*buffer);
-  } catch (const std::exception& e) {
-    std::cerr << "Exception creating AudioClip: " << e.what() << std::endl;
-    sound.reset();
-    buffer.reset();
-  }
+#ifdef SFML_AUDIO_AVAILABLE
+  buffer = SoundBufferCache::Acquire(this->audioUrl);
 #endif
 }
 
 void AudioClip::SetVolume(float volume) {
-#ifdef SFML_AUDIO_AVAILABLE
   Expects(volume >= 0.0f && volume <= 100.0f);
+  this->volume = volume;
+#ifdef SFML_AUDIO_AVAILABLE
   if (sound) {
     sound->setVolume(volume);
   }
 #endif
 }
 
-AudioClip::~AudioClip() {
+bool AudioClip::IsValid() const {
 #ifdef SFML_AUDIO_AVAILABLE
-  // Smart pointers automatically clean up
+  return buffer != nullptr;
+#else
+  return false;
 #endif
 }
 
-// Copy constructor
-AudioClip::AudioClip(const AudioClip& other) {
-  audioUrl = other.audioUrl;
+const std::string& AudioClip::GetPath() const { return audioUrl; }
+
+float AudioClip::GetVolume() const { return volume; }
+
 #ifdef SFML_AUDIO_AVAILABLE
-  sound = nullptr;
-  buffer = nullptr;
-  if (!other.audioUrl.empty()) {
-    try {
-      buffer = std::make_unique<sf::SoundBuffer>();
-      if (buffer && buffer->loadFromFile(audioUrl)) {
-        sound = std::make_unique<sf::Sound>(*buffer);
-      }
-    } catch (...) {
-      sound.reset();
-      buffer.reset();
-    }
-  }
+const std::shared_ptr<const sf::SoundBuffer>& AudioClip::GetBuffer() const {
+  return buffer;
+}
+#endif
+
+AudioClip::~AudioClip() {}
+
+// Copies share the decoded buffer; playback state is not copied
+AudioClip::AudioClip(const AudioClip& other)
+    : audioUrl(other.audioUrl), volume(other.volume) {
+#ifdef SFML_AUDIO_AVAILABLE
+  buffer = other.buffer;
 #endif
 }
 
-// Copy assignment
 AudioClip& AudioClip::operator=(const AudioClip& other) {
   if (this == &other) return *this;
   audioUrl = other.audioUrl;
+  volume = other.volume;
 #ifdef SFML_AUDIO_AVAILABLE
   sound.reset();
-  buffer.reset();
-  if (!other.audioUrl.empty()) {
-    try {
-      buffer = std::make_unique<sf::SoundBuffer>();
-      if (buffer && buffer->loadFromFile(audioUrl)) {
-        sound = std::make_unique<sf::Sound>(*buffer);
-      }
-    } catch (...) {
-      sound.reset();
-      buffer.reset();
-    }
-  }
+  buffer = other.buffer;
 #endif
   return *this;
 }
 
-// Move constructor
-AudioClip::AudioClip(AudioClip&& other) noexcept {
+AudioClip::AudioClip(AudioClip&& other) noexcept
+    : audioUrl(std::move(other.audioUrl)), volume(other.volume) {
 #ifdef SFML_AUDIO_AVAILABLE
-  sound = std::move(other.sound);
   buffer = std::move(other.buffer);
+  sound = std::move(other.sound);
 #endif
-  audioUrl = std::move(other.audioUrl);
 }
 
-// Move assignment
 AudioClip& AudioClip::operator=(AudioClip&& other) noexcept {
   if (this != &other) {
+    audioUrl = std::move(other.audioUrl);
+    volume = other.volume;
 #ifdef SFML_AUDIO_AVAILABLE
     sound = std::move(other.sound);
     buffer = std::move(other.buffer);
 #endif
-    audioUrl = std::move(other.audioUrl);
   }
   return *this;
 }
 
+void AudioClip::Play() {
 #ifdef SFML_AUDIO_AVAILABLE
-void AudioClip::Play(sf::SoundBuffer&) {
-  Expects(sound != nullptr);
-  if (!sound) {
-    std::cerr << "Sound object is null, cannot play audio" << std::endl;
+  if (!buffer) {
+    BEP_LOG_WARNING(LogCategory::Audio, "AudioClip '{}' has no buffer",
+                    audioUrl);
     return;
   }
   try {
+    if (!sound) sound = std::make_unique<sf::Sound>(*buffer);
+    sound->setVolume(volume);
     sound->play();
   } catch (const std::exception& e) {
-    std::cerr << "Exception playing audio: " << e.what() << std::endl;
+    BEP_LOG_ERROR(LogCategory::Audio, "Exception playing audio: {}",
+                  e.what());
   }
+#endif
 }
-#endif
\ No newline at end of file
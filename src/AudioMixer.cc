@@ -0,0 +1,443 @@
+#include "AudioMixer.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <gsl/assert>
+#include <gsl/narrow>
+#include <numbers>
+#include <thread>
+
+#include "Log.hh"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_MIXER_SSE2
+#endif
+
+namespace {
+
+constexpr float SAMPLE_TO_FLOAT{1.f / 32768.f};
+constexpr float MIN_PITCH{0.01f};
+constexpr float MAX_PITCH{8.f};
+
+// dst[i] += src[i] * gain
+void MixInto(float* dst, const float* src, float gain, std::size_t count) {
+  std::size_t i{};
+#ifdef AUDIO_MIXER_SSE2
+  const __m128 g{_mm_set1_ps(gain)};
+  for (const std::size_t blocks{count & ~std::size_t{3}}; i < blocks; i += 4) {
+    const __m128 mixed{_mm_add_ps(_mm_loadu_ps(dst + i),
+                                  _mm_mul_ps(_mm_loadu_ps(src + i), g))};
+    _mm_storeu_ps(dst + i, mixed);
+  }
+#endif
+  for (; i < count; ++i) dst[i] += src[i] * gain;
+}
+
+// Interleaves the planar mix into stereo 16-bit PCM, clipping to full scale
+void ToInterleavedPcm(const float* left, const float* right, std::int16_t* out,
+                      std::size_t frames) {
+  std::size_t i{};
+#ifdef AUDIO_MIXER_SSE2
+  const __m128 scale{_mm_set1_ps(32767.f)};
+  const __m128 lo{_mm_set1_ps(-1.f)};
+  const __m128 hi{_mm_set1_ps(1.f)};
+  for (const std::size_t blocks{frames & ~std::size_t{3}}; i < blocks; i += 4) {
+    const __m128 l{_mm_mul_ps(
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(left + i), lo), hi), scale)};
+    const __m128 r{_mm_mul_ps(
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(right + i), lo), hi), scale)};
+    const __m128i first{_mm_cvtps_epi32(_mm_unpacklo_ps(l, r))};
+    const __m128i second{_mm_cvtps_epi32(_mm_unpackhi_ps(l, r))};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2),
+                     _mm_packs_epi32(first, second));
+  }
+#endif
+  for (; i < frames; ++i) {
+    out[i * 2] = static_cast<std::int16_t>(
+        std::lrint(std::clamp(left[i], -1.f, 1.f) * 32767.f));
+    out[i * 2 + 1] = static_cast<std::int16_t>(
+        std::lrint(std::clamp(right[i], -1.f, 1.f) * 32767.f));
+  }
+}
+
+}  // namespace
+
+AudioMixer::AudioMixer(int voiceCount)
+    : mixLeft(CHUNK_FRAMES),
+      mixRight(CHUNK_FRAMES),
+      scratchLeft(CHUNK_FRAMES),
+      scratchRight(CHUNK_FRAMES),
+      output(CHUNK_FRAMES * 2) {
+  Expects(voiceCount > 0);
+  voices.resize(gsl::narrow_cast<std::size_t>(voiceCount));
+  for (auto& volume : busVolumes) volume.store(1.f);
+  initialize(2, SAMPLE_RATE,
+             {sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight});
+}
+
+// The stream thread calls back into this object, so it has to be stopped
+// before any member goes away
+AudioMixer::~AudioMixer() { Stop(); }
+
+void AudioMixer::Start() { play(); }
+
+void AudioMixer::Stop() { stop(); }
+
+bool AudioMixer::Post(Command&& command) {
+  const std::size_t tail{commandTail.load(std::memory_order_relaxed)};
+  if (tail - commandHead.load(std::memory_order_acquire) >= COMMAND_CAPACITY) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  commands[tail % COMMAND_CAPACITY] = std::move(command);
+  commandTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+VoiceHandle AudioMixer::Play(std::shared_ptr<const sf::SoundBuffer> buffer,
+                             const VoiceParams& params) {
+  if (!buffer) return INVALID_VOICE;
+  if (++nextHandle == INVALID_VOICE) ++nextHandle;
+  const VoiceHandle handle{nextHandle};
+  Command command;
+  command.type = CommandType::Play;
+  command.handle = handle;
+  command.buffer = std::move(buffer);
+  command.params = params;
+  return Post(std::move(command)) ? handle : INVALID_VOICE;
+}
+
+void AudioMixer::StopVoice(VoiceHandle voice) {
+  Command command;
+  command.type = CommandType::Stop;
+  command.handle = voice;
+  Post(std::move(command));
+}
+
+void AudioMixer::SetVoiceVolume(VoiceHandle voice, float volume) {
+  Command command;
+  command.type = CommandType::SetVolume;
+  command.handle = voice;
+  command.value = volume;
+  Post(std::move(command));
+}
+
+void AudioMixer::SetVoicePan(VoiceHandle voice, float pan) {
+  Command command;
+  command.type = CommandType::SetPan;
+  command.handle = voice;
+  command.value = pan;
+  Post(std::move(command));
+}
+
+void AudioMixer::SetVoicePitch(VoiceHandle voice, float pitch) {
+  Command command;
+  command.type = CommandType::SetPitch;
+  command.handle = voice;
+  command.value = pitch;
+  Post(std::move(command));
+}
+
+void AudioMixer::PostAndWait(Command&& command) {
+  // Stopped or paused, nothing mixes, so nothing else drains the ring
+  const auto waitForAudioThread = [this] {
+    if (getStatus() == Status::Playing) {
+      std::this_thread::yield();
+    } else {
+      DrainCommands();
+    }
+  };
+  const std::size_t tail{commandTail.load(std::memory_order_relaxed)};
+  while (tail - commandHead.load(std::memory_order_acquire) >=
+         COMMAND_CAPACITY) {
+    waitForAudioThread();
+  }
+  commands[tail % COMMAND_CAPACITY] = std::move(command);
+  commandTail.store(tail + 1, std::memory_order_release);
+  while (commandHead.load(std::memory_order_acquire) <= tail) {
+    waitForAudioThread();
+  }
+}
+
+void AudioMixer::AddSource(AudioMixerSource* source, AudioBus bus) {
+  Expects(source && bus < AudioBus::Count);
+  if (std::none_of(sources.begin(), sources.end(),
+                   [](const SourceSlot& slot) { return !slot.source; })) {
+    BEP_LOG_WARNING(LogCategory::Audio, "AudioMixer: no free source slot");
+    return;
+  }
+  Command command;
+  command.type = CommandType::AddSource;
+  command.source = source;
+  command.params.bus = bus;
+  PostAndWait(std::move(command));
+}
+
+void AudioMixer::RemoveSource(AudioMixerSource* source) {
+  if (std::none_of(sources.begin(), sources.end(),
+                   [source](const SourceSlot& slot) {
+                     return slot.source == source;
+                   })) {
+    return;
+  }
+  Command command;
+  command.type = CommandType::RemoveSource;
+  command.source = source;
+  PostAndWait(std::move(command));
+}
+
+void AudioMixer::SetBusVolume(AudioBus bus, float volume) {
+  Expects(bus < AudioBus::Count);
+  busVolumes[static_cast<std::size_t>(bus)].store(std::max(0.f, volume));
+}
+
+float AudioMixer::GetBusVolume(AudioBus bus) const {
+  Expects(bus < AudioBus::Count);
+  return busVolumes[static_cast<std::size_t>(bus)].load();
+}
+
+void AudioMixer::SetMasterVolume(float volume) {
+  masterVolume.store(std::max(0.f, volume));
+}
+
+float AudioMixer::GetMasterVolume() const { return masterVolume.load(); }
+
+AudioMixerStats AudioMixer::GetStats() const {
+  AudioMixerStats stats;
+  stats.activeVoices = activeVoices.load(std::memory_order_relaxed);
+  stats.voiceCount = gsl::narrow_cast<int>(voices.size());
+  stats.played = played.load(std::memory_order_relaxed);
+  stats.stolen = stolen.load(std::memory_order_relaxed);
+  stats.dropped = dropped.load(std::memory_order_relaxed);
+  stats.mixMicroseconds = mixMicroseconds.load(std::memory_order_relaxed);
+  return stats;
+}
+
+const char* AudioMixer::GetBusName(AudioBus bus) {
+  switch (bus) {
+    case AudioBus::Sfx:
+      return "sfx";
+    case AudioBus::Ui:
+      return "ui";
+    case AudioBus::Music:
+      return "music";
+    default:
+      return "unknown";
+  }
+}
+
+AudioMixer::Voice* AudioMixer::FindVoice(VoiceHandle handle) {
+  if (handle == INVALID_VOICE) return nullptr;
+  for (Voice& voice : voices) {
+    if (voice.handle == handle) return &voice;
+  }
+  return nullptr;
+}
+
+void AudioMixer::DrainCommands() {
+  std::size_t head{commandHead.load(std::memory_order_relaxed)};
+  const std::size_t tail{commandTail.load(std::memory_order_acquire)};
+  for (; head != tail; ++head) {
+    Command& command{commands[head % COMMAND_CAPACITY]};
+    if (command.type == CommandType::Play) {
+      StartVoice(command);
+    } else if (command.type == CommandType::AddSource) {
+      for (SourceSlot& slot : sources) {
+        if (!slot.source) {
+          slot = SourceSlot{command.source, command.params.bus};
+          break;
+        }
+      }
+    } else if (command.type == CommandType::RemoveSource) {
+      for (SourceSlot& slot : sources) {
+        if (slot.source == command.source) slot = SourceSlot{};
+      }
+    } else if (Voice* voice{FindVoice(command.handle)}) {
+      switch (command.type) {
+        case CommandType::Stop:
+          *voice = Voice{};
+          break;
+        case CommandType::SetVolume:
+          voice->params.volume = command.value;
+          break;
+        case CommandType::SetPan:
+          voice->params.pan = command.value;
+          break;
+        case CommandType::SetPitch:
+          voice->params.pitch = std::clamp(command.value, MIN_PITCH, MAX_PITCH);
+          voice->step = static_cast<double>(voice->buffer->getSampleRate()) /
+                        SAMPLE_RATE * voice->params.pitch;
+          break;
+        default:
+          break;
+      }
+    }
+    // Release the slot's buffer reference before the producer reuses it
+    command.buffer.reset();
+  }
+  commandHead.store(head, std::memory_order_release);
+}
+
+void AudioMixer::StartVoice(Command& command) {
+  const sf::SoundBuffer& buffer{*command.buffer};
+  const unsigned channels{buffer.getChannelCount()};
+  if (channels == 0 || buffer.getSampleCount() < channels) return;
+
+  Voice* target{};
+  for (Voice& voice : voices) {
+    if (voice.handle == INVALID_VOICE) {
+      target = &voice;
+      break;
+    }
+  }
+  if (!target) {
+    // Steal the lowest priority voice; among equals, the one closest to
+    // its end is the least audible loss
+    for (Voice& voice : voices) {
+      if (!target || voice.params.priority < target->params.priority ||
+          (voice.params.priority == target->params.priority &&
+           voice.position / voice.frameCount >
+               target->position / target->frameCount)) {
+        target = &voice;
+      }
+    }
+    if (target->params.priority > command.params.priority) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    stolen.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Voice& voice{*target};
+  voice.samples = buffer.getSamples();
+  voice.channels = channels;
+  voice.frameCount = buffer.getSampleCount() / channels;
+  voice.position = 0.0;
+  voice.params = command.params;
+  voice.params.pitch = std::clamp(voice.params.pitch, MIN_PITCH, MAX_PITCH);
+  voice.step = static_cast<double>(buffer.getSampleRate()) / SAMPLE_RATE *
+               voice.params.pitch;
+  voice.handle = command.handle;
+  voice.buffer = std::move(command.buffer);
+  played.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t AudioMixer::RenderVoice(Voice& voice, std::size_t frames) {
+  float* left{scratchLeft.data()};
+  float* right{scratchRight.data()};
+  const std::int16_t* samples{voice.samples};
+  const unsigned channels{voice.channels};
+  const std::uint64_t frameCount{voice.frameCount};
+  const bool stereo{channels > 1};
+  std::size_t written{};
+
+  if (voice.step == 1.0 && voice.position == std::floor(voice.position)) {
+    // Same rate and on a sample boundary: straight conversion, no filter
+    while (written < frames) {
+      auto index{static_cast<std::uint64_t>(voice.position)};
+      if (index >= frameCount) {
+        if (!voice.params.loop) break;
+        index = 0;
+      }
+      const std::size_t count{static_cast<std::size_t>(
+          std::min<std::uint64_t>(frames - written, frameCount - index))};
+      const std::int16_t* source{samples + index * channels};
+      for (std::size_t i{}; i < count; ++i) {
+        left[written + i] = source[i * channels] * SAMPLE_TO_FLOAT;
+      }
+      if (stereo) {
+        for (std::size_t i{}; i < count; ++i) {
+          right[written + i] = source[i * channels + 1] * SAMPLE_TO_FLOAT;
+        }
+      }
+      written += count;
+      voice.position = static_cast<double>(index + count);
+    }
+  } else {
+    // Linear interpolation between neighbouring source frames
+    const auto end{static_cast<double>(frameCount)};
+    for (; written < frames; ++written) {
+      if (voice.position >= end) {
+        if (!voice.params.loop) break;
+        voice.position = std::fmod(voice.position, end);
+      }
+      const auto index{static_cast<std::uint64_t>(voice.position)};
+      std::uint64_t next{index + 1};
+      if (next >= frameCount) next = voice.params.loop ? 0 : index;
+      const float t{static_cast<float>(voice.position - index)};
+      const std::int16_t* a{samples + index * channels};
+      const std::int16_t* b{samples + next * channels};
+      left[written] = (a[0] + (b[0] - a[0]) * t) * SAMPLE_TO_FLOAT;
+      if (stereo) right[written] = (a[1] + (b[1] - a[1]) * t) * SAMPLE_TO_FLOAT;
+      voice.position += voice.step;
+    }
+  }
+
+  if (written < frames) voice = Voice{};
+  return written;
+}
+
+bool AudioMixer::onGetData(Chunk& data) {
+  const auto start{std::chrono::steady_clock::now()};
+  DrainCommands();
+
+  std::fill(mixLeft.begin(), mixLeft.end(), 0.f);
+  std::fill(mixRight.begin(), mixRight.end(), 0.f);
+
+  const float master{masterVolume.load(std::memory_order_relaxed)};
+  float busGains[static_cast<std::size_t>(AudioBus::Count)];
+  for (std::size_t i{}; i < busVolumes.size(); ++i) {
+    busGains[i] = busVolumes[i].load(std::memory_order_relaxed) * master;
+  }
+
+  int active{};
+  for (Voice& voice : voices) {
+    if (voice.handle == INVALID_VOICE) continue;
+    const float gain{voice.params.volume *
+                     busGains[static_cast<std::size_t>(voice.params.bus)]};
+    const float pan{std::clamp(voice.params.pan, -1.f, 1.f)};
+    // Read before rendering: a voice that ends this chunk is reset
+    const bool stereo{voice.channels > 1};
+    const std::size_t frames{RenderVoice(voice, CHUNK_FRAMES)};
+
+    if (stereo) {
+      // Balance: attenuate the side being panned away from
+      MixInto(mixLeft.data(), scratchLeft.data(),
+              gain * std::min(1.f, 1.f - pan), frames);
+      MixInto(mixRight.data(), scratchRight.data(),
+              gain * std::min(1.f, 1.f + pan), frames);
+    } else {
+      // Constant-power pan
+      const float angle{(pan + 1.f) * std::numbers::pi_v<float> / 4.f};
+      MixInto(mixLeft.data(), scratchLeft.data(), gain * std::cos(angle),
+              frames);
+      MixInto(mixRight.data(), scratchLeft.data(), gain * std::sin(angle),
+              frames);
+    }
+    if (voice.handle != INVALID_VOICE) ++active;
+  }
+
+  for (const SourceSlot& slot : sources) {
+    if (!slot.source) continue;
+    slot.source->Mix(mixLeft.data(), mixRight.data(), CHUNK_FRAMES,
+                     busGains[static_cast<std::size_t>(slot.bus)]);
+  }
+
+  ToInterleavedPcm(mixLeft.data(), mixRight.data(), output.data(),
+                   CHUNK_FRAMES);
+  data.samples = output.data();
+  data.sampleCount = output.size();
+
+  activeVoices.store(active, std::memory_order_relaxed);
+  mixMicroseconds.store(
+      std::chrono::duration<float, std::micro>(
+          std::chrono::steady_clock::now() - start)
+          .count(),
+      std::memory_order_relaxed);
+  return true;  // the mixer streams silence while idle
+}
+
+void AudioMixer::onSeek(sf::Time) {}
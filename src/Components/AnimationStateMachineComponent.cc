@@ -0,0 +1,107 @@
+#include "Components/AnimationStateMachineComponent.hh"
+
+#include <gsl/assert>
+#include <gsl/narrow>
+
+#include "Components/EntityManager.hh"
+#include "Log.hh"
+
+AnimationStateMachineComponent::AnimationStateMachineComponent(
+    const char* definitionPath) {
+  this->definitionPath = definitionPath;
+}
+
+AnimationStateMachineComponent::AnimationStateMachineComponent(
+    std::shared_ptr<const AnimationStateMachine> machine)
+    : machine(std::move(machine)) {
+  Expects(this->machine != nullptr);
+}
+
+AnimationStateMachineComponent::~AnimationStateMachineComponent() {}
+
+void AnimationStateMachineComponent::Initialize() {
+  animator = owner->GetComponent<AnimatorComponent>();
+  Expects(animator != nullptr);
+
+  if (!machine) {
+    auto* transform = owner->GetComponent<TransformComponent>();
+    Expects(transform != nullptr);
+    const sf::Vector2i frameSize{
+        gsl::narrow_cast<int>(transform->GetWidth()),
+        gsl::narrow_cast<int>(transform->GetHeight())};
+    machine = AnimationStateMachine::Load(definitionPath, frameSize);
+  }
+  if (!machine) return;
+  parameters = machine->GetDefaultParameters();
+  EnterState(machine->GetInitialState());
+}
+
+void AnimationStateMachineComponent::EnterState(Index state) {
+  currentState = state;
+  lastFrame = -1;
+  const auto& data{machine->GetState(state)};
+  animator->Play(data.clip, data.loop);
+}
+
+void AnimationStateMachineComponent::DispatchFrameEvents() {
+  const auto& state{machine->GetState(currentState)};
+  const int frame{animator->GetFrameIndex()};
+  if (frame == lastFrame) return;
+
+  // Walk every frame entered since the last check, wrapping for loops
+  int entered{lastFrame};
+  for (int step{}; step < state.frameCount && entered != frame; ++step) {
+    entered = entered + 1 < state.frameCount ? entered + 1 : 0;
+    if (!eventListener) continue;
+    for (Index i{}; i < state.eventCount; ++i) {
+      const auto& event{machine->GetEvent(state.firstEvent + i)};
+      if (event.frame == entered) {
+        eventListener(machine->GetEventName(event.name));
+      }
+    }
+  }
+  lastFrame = frame;
+}
+
+void AnimationStateMachineComponent::Update(float& deltaTime) {
+  if (!machine) return;
+  DispatchFrameEvents();
+  const Index next{machine->Evaluate(currentState, parameters.data(),
+                                     animator->IsFinished())};
+  if (next != AnimationStateMachine::INVALID_INDEX) EnterState(next);
+}
+
+AnimationStateMachineComponent::Index
+AnimationStateMachineComponent::GetParameter(const std::string& name) const {
+  if (!machine) return AnimationStateMachine::INVALID_INDEX;
+  const Index parameter{machine->FindParameter(name)};
+  if (parameter == AnimationStateMachine::INVALID_INDEX) {
+    BEP_LOG_WARNING(LogCategory::Animation,
+                    "Animation parameter '{}' not found", name);
+  }
+  return parameter;
+}
+
+void AnimationStateMachineComponent::SetFloat(Index parameter, float value) {
+  if (parameter < parameters.size()) parameters[parameter] = value;
+}
+
+void AnimationStateMachineComponent::SetBool(Index parameter, bool value) {
+  SetFloat(parameter, value ? 1.f : 0.f);
+}
+
+float AnimationStateMachineComponent::GetFloat(Index parameter) const {
+  Expects(parameter < parameters.size());
+  return parameters[parameter];
+}
+
+const std::string& AnimationStateMachineComponent::GetCurrentStateName()
+    const {
+  static const std::string none;
+  return machine ? machine->GetStateName(currentState) : none;
+}
+
+void AnimationStateMachineComponent::SetEventListener(
+    std::function<void(const std::string& eventName)> listener) {
+  eventListener = std::move(listener);
+}
@@ -1,85 +1,89 @@
 #include "Components/AnimatorComponent.hh"
 
 #include <gsl/assert>
+#include <gsl/narrow>
 
+#include "AnimationLibrary.hh"
 #include "Components/EntityManager.hh"
+#include "Log.hh"
 
-AnimatorComponent::AnimatorComponent() {}
+AnimatorComponent::AnimatorComponent(AnimationSystem& animationSystem)
+    : animationSystem(animationSystem) {}
 
-AnimatorComponent::~AnimatorComponent() {}
+AnimatorComponent::~AnimatorComponent() {
+  if (animatorId != AnimationSystem::INVALID_ANIMATOR) {
+    animationSystem.Remove(animatorId);
+  }
+}
 
 void AnimatorComponent::Initialize() {
   sprite = owner->GetComponent<SpriteComponent>();
   transform = owner->GetComponent<TransformComponent>();
   Expects(sprite != nullptr);
   Expects(transform != nullptr);
+  animatorId = animationSystem.Add(sprite);
 }
 
-void AnimatorComponent::RefreshAnimationClip() {
-  animationIndex = currentAnimationClip.animationIndex;
-  startFrame = currentAnimationClip.startFrame;
-  endFrame = currentAnimationClip.endFrame;
-  animationDelay = currentAnimationClip.animationDelay;
-  currentAnimation = currentAnimationClip.currentAnimation;
-}
-
-void AnimatorComponent::Play(std::string animationName) {
-  auto it = animations.find(animationName);
-  if (it == animations.end()) {
-    std::cerr << "Animation '" << animationName << "' not found" << std::endl;
+void AnimatorComponent::Play(AnimationClipHandle clip, bool loop) {
+  if (clip == INVALID_ANIMATION_CLIP) {
+    BEP_LOG_WARNING(LogCategory::Animation,
+                    "Cannot play invalid animation clip");
     return;
   }
+  animationSystem.Play(animatorId, clip, loop);
+}
 
-  AnimationClip anim = it->second;
+AnimationClipHandle AnimatorComponent::AddAnimation(
+    const std::string& animationName, const char* clipPath) {
+  Expects(transform != nullptr);
+  const sf::Vector2i frameSize{gsl::narrow_cast<int>(transform->GetWidth()),
+                               gsl::narrow_cast<int>(transform->GetHeight())};
+  const AnimationClipHandle clip{AnimationLibrary::Load(clipPath, frameSize)};
+  AddAnimation(animationName, clip);
+  return clip;
+}
 
-  if (!anim.IsValid()) {
-    std::cerr << "Cannot play invalid animation '" << animationName << "'"
-              << std::endl;
+void AnimatorComponent::AddAnimation(const std::string& animationName,
+                                     AnimationClipHandle clip) {
+  // Check if animation clip is valid
+  if (clip == INVALID_ANIMATION_CLIP) {
+    BEP_LOG_WARNING(LogCategory::Animation, "Invalid animation clip for '{}'",
+                    animationName);
     return;
   }
 
-  if (animationName != currentAnimationName) {
-    currentAnimationName = animationName;
-    currentAnimationClip = anim;
+  if (GetCurrentClip() == INVALID_ANIMATION_CLIP) Play(clip);
+  animations.emplace_back(animationName, clip);
+}
 
-    RefreshAnimationClip();
+AnimationClipHandle AnimatorComponent::GetAnimation(
+    const std::string& animationName) const {
+  for (const auto& [name, clip] : animations) {
+    if (name == animationName) return clip;
   }
+  BEP_LOG_WARNING(LogCategory::Animation, "Animation '{}' not found",
+                  animationName);
+  return INVALID_ANIMATION_CLIP;
 }
 
-void AnimatorComponent::AddAnimation(std::string animationName,
-                                     AnimationClip animationClip) {
-  // Check if animation clip is valid
-  if (!animationClip.IsValid()) {
-    std::cerr << "Warning: Invalid animation clip for '" << animationName << "'"
-              << std::endl;
-    return;
-  }
+AnimationClipHandle AnimatorComponent::GetCurrentClip() const {
+  return animationSystem.GetClip(animatorId);
+}
 
-  if (currentAnimationName.empty()) {
-    currentAnimationName = animationName;
-    currentAnimationClip = animationClip;
+int AnimatorComponent::GetFrameIndex() const {
+  return animationSystem.GetFrameIndex(animatorId);
+}
 
-    RefreshAnimationClip();
-  }
-  animations.insert({animationName, animationClip});
+bool AnimatorComponent::IsFinished() const {
+  return animationSystem.IsFinished(animatorId);
 }
 
-void AnimatorComponent::Update(float& deltaTime) {
-  if (sprite != nullptr && transform != nullptr) {
-    if (animations.size() > 0 && !currentAnimationName.empty()) {
-      currentTime += deltaTime;
-      sprite->RebindRectTexture(animationIndex * transform->GetWidth(),
-                                currentAnimation * transform->GetHeight(),
-                                transform->GetWidth(), transform->GetHeight());
-
-      if (currentTime > animationDelay) {
-        if (animationIndex == endFrame) {
-          animationIndex = startFrame;
-        } else {
-          animationIndex++;
-        }
-        currentTime = 0.f;
-      }
-    }
-  }
-}
\ No newline at end of file
+void AnimatorComponent::SetPaused(bool paused) {
+  animationSystem.SetPaused(animatorId, paused);
+}
+
+void AnimatorComponent::SetThrottled(bool throttled) {
+  animationSystem.SetThrottled(animatorId, throttled);
+}
+
+void AnimatorComponent::MarkDue() { animationSystem.MarkDue(animatorId); }
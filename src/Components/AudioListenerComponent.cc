@@ -1,14 +1,15 @@
 #include "Components/AudioListenerComponent.hh"
 
 #include <gsl/assert>
-#include <iostream>
 
-AudioListenerComponent::AudioListenerComponent() {
+#include "Log.hh"
+
 #ifdef SFML_AUDIO_AVAILABLE
-  this->soundBuffer = sf::SoundBuffer();
-  audioClip = nullptr;
+#include "AudioMixer.hh"
 #endif
-}
+
+AudioListenerComponent::AudioListenerComponent(AudioMixer& mixer)
+    : mixer(mixer) {}
 
 AudioListenerComponent::~AudioListenerComponent() {}
 
@@ -19,34 +20,27 @@ void AudioListenerComponent::Initialize() {
 
 AudioClip* AudioListenerComponent::GetAudioClip() const { return audioClip; }
 
+AudioMixer& AudioListenerComponent::GetMixer() const { return mixer; }
+
 void AudioListenerComponent::Play() {
-#ifdef SFML_AUDIO_AVAILABLE
-  if (audioClip) {
-    audioClip->SetVolume(1.f);
-    audioClip->Play(soundBuffer);
-  }
-#endif
+  if (audioClip) PlayOneShot(*audioClip);
 }
 
-void AudioListenerComponent::PlayOneShot(AudioClip& audioClip,
+void AudioListenerComponent::PlayOneShot(const AudioClip& audioClip,
                                          float audioVolume) {
+  Expects(audioVolume >= 0.0f && audioVolume <= 100.0f);
 #ifdef SFML_AUDIO_AVAILABLE
-  try {
-    audioClip.SetVolume(audioVolume);
-    audioClip.Play(soundBuffer);
-  } catch (const std::exception& e) {
-    std::cerr << "Exception in PlayOneShot: " << e.what() << std::endl;
+  if (!audioClip.IsValid()) {
+    BEP_LOG_WARNING(LogCategory::Audio, "PlayOneShot: clip '{}' has no buffer",
+                    audioClip.GetPath());
+    return;
   }
+  VoiceParams params;
+  params.volume = audioVolume / 100.f;
+  mixer.Play(audioClip.GetBuffer(), params);
 #endif
 }
 
-void AudioListenerComponent::PlayOneShot(AudioClip& audioClip) {
-#ifdef SFML_AUDIO_AVAILABLE
-  try {
-    audioClip.SetVolume(1.f);
-    audioClip.Play(soundBuffer);
-  } catch (const std::exception& e) {
-    std::cerr << "Exception in PlayOneShot: " << e.what() << std::endl;
-  }
-#endif
-}
\ No newline at end of file
+void AudioListenerComponent::PlayOneShot(const AudioClip& audioClip) {
+  PlayOneShot(audioClip, DEFAULT_VOLUME);
+}
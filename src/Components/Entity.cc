@@ -1,6 +1,9 @@
 #include "Components/Entity.hh"
 
+#include "Components/AnimatorComponent.hh"
 #include "Components/Component.hh"
+#include "Components/RigidBodyComponent.hh"
+#include "PrefabSpawner.hh"
 
 Entity::Entity(EntityManager& entityManager) : entityManager(entityManager) {
   this->isActive = true;
@@ -11,8 +14,12 @@ Entity::Entity(EntityManager& entityManager, std::string name)
 }
 
 Entity::~Entity() {
-  for (auto& component : components) {
-    delete component;
+  for (std::size_t i{}; i < components.size(); ++i) {
+    if (i < storedComponentCount) {
+      components[i]->~Component();
+    } else {
+      delete gsl::owner<Component*>{components[i]};
+    }
   }
 }
 
@@ -22,7 +29,57 @@ void Entity::Update(float& deltaTime) {
   }
 }
 
-void Entity::Destroy() { this->isActive = false; }
+void Entity::SkipUpdate(float deltaTime) {
+  if (simulationTier != SimulationTier::Dormant) {
+    pendingDeltaTime += deltaTime;
+    return;
+  }
+  // A contact or impulse from a Full entity can still wake the body; keep
+  // the transform and sprite on it while it moves
+  auto* rigidBody = GetComponent<RigidBodyComponent>();
+  const b2Body* body{rigidBody ? rigidBody->GetBody() : nullptr};
+  if (!body || !body->IsAwake()) return;
+  float noTime{};
+  rigidBody->Update(noTime);
+  if (auto* sprite = GetComponent<SpriteComponent>()) sprite->Update(noTime);
+}
+
+void Entity::CatchUpUpdate(float deltaTime) {
+  float elapsed{pendingDeltaTime + deltaTime};
+  pendingDeltaTime = 0.f;
+  Update(elapsed);
+  if (simulationTier == SimulationTier::Reduced) {
+    if (auto* animator = GetComponent<AnimatorComponent>()) animator->MarkDue();
+  }
+}
+
+SimulationTier Entity::GetSimulationTier() const { return simulationTier; }
+
+void Entity::SetSimulationTier(SimulationTier tier) {
+  if (tier == simulationTier) return;
+  const bool wasDormant{simulationTier == SimulationTier::Dormant};
+  const bool isDormant{tier == SimulationTier::Dormant};
+  simulationTier = tier;
+
+  if (isDormant) pendingDeltaTime = 0.f;
+  if (wasDormant != isDormant) {
+    if (auto* rigidBody = GetComponent<RigidBodyComponent>()) {
+      if (b2Body* body = rigidBody->GetBody()) body->SetAwake(!isDormant);
+    }
+  }
+  // Animations advance in the AnimationSystem batch, not in Update, so it
+  // is told which animators to hold back
+  if (auto* animator = GetComponent<AnimatorComponent>()) {
+    if (wasDormant != isDormant) animator->SetPaused(isDormant);
+    animator->SetThrottled(tier == SimulationTier::Reduced);
+  }
+}
+
+void Entity::Destroy() {
+  // The pool would otherwise hand it out again after it is freed
+  if (spawnPool) spawnPool->Forget(*this);
+  this->isActive = false;
+}
 
 void Entity::Render(sf::RenderWindow& window) {
   for (auto& component : components) {
@@ -30,4 +87,25 @@ void Entity::Render(sf::RenderWindow& window) {
   }
 }
 
-bool Entity::IsActive() const { return this->isActive; }
\ No newline at end of file
+bool Entity::IsActive() const { return this->isActive; }
+
+void Entity::SetEnabled(bool enabled) {
+  if (enabled == isEnabled) return;
+  isEnabled = enabled;
+  pendingDeltaTime = 0.f;
+  if (auto* rigidBody = GetComponent<RigidBodyComponent>()) {
+    rigidBody->SetEnabled(enabled);
+  }
+  if (auto* animator = GetComponent<AnimatorComponent>()) {
+    animator->SetPaused(!enabled ||
+                        simulationTier == SimulationTier::Dormant);
+  }
+}
+
+bool Entity::IsEnabled() const { return isEnabled; }
+
+const Prefab* Entity::GetPrefab() const { return prefab; }
+
+void Entity::SetPrefab(const Prefab* prefab) { this->prefab = prefab; }
+
+void Entity::SetSpawnPool(PrefabSpawner* spawner) { spawnPool = spawner; }
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include "Components/EntityManager.hh"
 
+#include <bit>
 #include <gsl/assert>
 #include <gsl/narrow>
 
+#include "Components/RigidBodyComponent.hh"
+#include "Components/TransformComponent.hh"
+#include "FrameArena.hh"
+
 EntityManager::EntityManager() {}
 
 EntityManager::~EntityManager() {}
@@ -12,6 +17,7 @@ void EntityManager::ClearData() {
     entity->Destroy();
   }
   entities.clear();
+  simulationFocus = nullptr;
 }
 
 bool EntityManager::HasNoEntities() { return entities.empty(); }
@@ -21,45 +27,119 @@ void EntityManager::Update(float& deltaTime) {
   activeEntities.reserve(entities.size());
   inactiveEntities.clear();
 
+  if (simulationFocus) {
+    if (auto* transform = simulationFocus->GetComponent<TransformComponent>()) {
+      simulationLOD.SetFocus(transform->GetPosition());
+    }
+  } else {
+    simulationLOD.ClearFocus();
+  }
+  simulationLOD.BeginFrame();
+
+  std::uint32_t slot{};
   for (auto& entity : entities) {
     if (entity->IsActive()) {
-      entity->Update(deltaTime);
+      // Disabled (pooled) entities are kept but not simulated
+      if (entity->IsEnabled()) {
+        const SimulationTier tier{ClassifyEntity(*entity)};
+        entity->SetSimulationTier(tier);
+        simulationLOD.Count(tier);
+        if (tier == SimulationTier::Full ||
+            (tier == SimulationTier::Reduced &&
+             simulationLOD.IsReducedUpdateDue(slot))) {
+          entity->CatchUpUpdate(deltaTime);
+        } else {
+          entity->SkipUpdate(deltaTime);
+        }
+        ++slot;
+      }
       activeEntities.push_back(std::move(entity));
     } else {
+      if (entity.get() == simulationFocus) simulationFocus = nullptr;
       inactiveEntities.push_back(std::move(entity));
     }
   }
 
-  entities = std::move(activeEntities);
-  // inactiveEntities will be destroyed automatically
+  // Swap rather than move so both buffers keep their capacity and the
+  // reserve above stops allocating once the entity count settles
+  entities.swap(activeEntities);
+  // inactiveEntities will be destroyed at the start of the next update
 }
 
 void EntityManager::Render(sf::RenderWindow& window) {
   for (auto& entity : entities) {
-    if (entity->IsActive()) {
+    if (entity->IsActive() && entity->IsEnabled()) {
       entity->Render(window);
     }
   }
 }
 
+SimulationTier EntityManager::ClassifyEntity(Entity& entity) const {
+  // Entities without a transform (UI) and the focus itself never throttle
+  if (&entity == simulationFocus) return SimulationTier::Full;
+  auto* transform = entity.GetComponent<TransformComponent>();
+  if (!transform) return SimulationTier::Full;
+  return simulationLOD.Classify(transform->GetPosition());
+}
+
 Entity& EntityManager::AddEntity(std::string entityName) {
   Entity* entity{new Entity(*this, entityName)};
   entities.emplace_back(entity);
   return *entity;
 }
 
+void EntityManager::Reserve(std::size_t additional) {
+  entities.reserve(entities.size() + additional);
+}
+
 gsl::span<Entity*> EntityManager::GetEntities() const {
-  thread_local std::vector<Entity*> result;
-  result.clear();
-  result.reserve(entities.size());
-  for (const auto& e : entities) {
-    result.push_back(e.get());
+  Entity** result{
+      FrameArena::ForThread().AllocateArray<Entity*>(entities.size())};
+  for (std::size_t i{}; i < entities.size(); ++i) {
+    result[i] = entities[i].get();
   }
-  Ensures(result.size() <= entities.size());
-  return gsl::span<Entity*>(result.data(), result.size());
+  return gsl::span<Entity*>(result, entities.size());
 }
 
 unsigned int EntityManager::GetentityCount() const {
   // entities.size() is size_t; API expects unsigned int
   return gsl::narrow_cast<unsigned int>(entities.size());
+}
+
+std::uint64_t EntityManager::ComputeChecksum() const {
+  // FNV-1a over the exact float bits: any rounding difference shows up
+  std::uint64_t hash{14695981039346656037ull};
+  auto mix = [&hash](float value) {
+    const auto bits{std::bit_cast<std::uint32_t>(value)};
+    for (int i{}; i < 4; ++i) {
+      hash ^= (bits >> (i * 8)) & 0xFF;
+      hash *= 1099511628211ull;
+    }
+  };
+  for (const auto& entity : entities) {
+    if (!entity->IsActive() || !entity->IsEnabled()) continue;
+    if (auto* transform = entity->GetComponent<TransformComponent>()) {
+      mix(transform->GetPosition().x);
+      mix(transform->GetPosition().y);
+    }
+    auto* rigidbody = entity->GetComponent<RigidBodyComponent>();
+    if (const b2Body* body{rigidbody ? rigidbody->GetBody() : nullptr}) {
+      mix(body->GetPosition().x);
+      mix(body->GetPosition().y);
+      mix(body->GetAngle());
+      mix(body->GetLinearVelocity().x);
+      mix(body->GetLinearVelocity().y);
+    }
+  }
+  return hash;
+}
+
+void EntityManager::SetSimulationFocus(Entity* focus) {
+  simulationFocus = focus;
+}
+
+SimulationLOD& EntityManager::GetSimulationLOD() { return simulationLOD; }
+
+const SimulationLOD& EntityManager::GetSimulationLOD() const {
+  return simulationLOD;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <gsl/assert>
 
 #include "Components/EntityManager.hh"
+#include "PhysicsUnits.hh"
 
 RigidBodyComponent::RigidBodyComponent(gsl::not_null<b2World*> world,
                                        b2BodyType bodyType, float density,
@@ -10,11 +11,21 @@ RigidBodyComponent::RigidBodyComponent(gsl::not_null<b2World*> world,
                                        float angle, bool frezeRotation,
                                        void* userData)
     : world(world) {
-  bodyDef = new b2BodyDef();
-  bodyDef->type = bodyType;
-  polygonShape = new b2PolygonShape();
-  fixtureDef = new b2FixtureDef();
+  this->bodyType = bodyType;
+  this->density = density;
+  this->friction = friction;
+  this->restitution = restitution;
+  this->angle = angle;
+  this->frezeRotation = frezeRotation;
+  this->userData = userData;
+}
 
+RigidBodyComponent::RigidBodyComponent(
+    gsl::not_null<PartitionedPhysicsWorld*> partitionedWorld,
+    b2BodyType bodyType, float density, float friction, float restitution,
+    float angle, bool frezeRotation, void* userData)
+    : partitionedWorld(partitionedWorld) {
+  this->bodyType = bodyType;
   this->density = density;
   this->friction = friction;
   this->restitution = restitution;
@@ -34,58 +45,93 @@ void RigidBodyComponent::Initialize() {
   sf::Vector2f size{transform->GetWidth() * transform->GetScale(),
                     transform->GetHeight() * transform->GetScale()};
 
-  // init body
-  bodyDef->position = b2Vec2(spritePos.x, spritePos.y);
-  body = world->CreateBody(bodyDef);
+  // init body (Box2D works in meters, transforms in pixels). Definitions are
+  // only read during creation, Box2D copies the shape into its own allocator.
+  b2BodyDef bodyDef;
+  bodyDef.type = bodyType;
+  bodyDef.position = PhysicsUnits::ToMeters(spritePos);
+  bodyDef.fixedRotation = frezeRotation;
+  bodyDef.userData.pointer = reinterpret_cast<uintptr_t>(userData);
 
   // define polygon shape
-  polygonShape->SetAsBox(size.x * 0.5f - b2_polygonRadius,
-                         size.y * 0.5f - b2_polygonRadius);
+  const b2Vec2 halfExtents{PhysicsUnits::ToMeters(size * 0.5f)};
+  b2PolygonShape polygonShape;
+  polygonShape.SetAsBox(halfExtents.x - b2_polygonRadius,
+                        halfExtents.y - b2_polygonRadius);
 
   // init fixture
-  fixtureDef->shape = polygonShape;
-  fixtureDef->density = density;
-  fixtureDef->friction = friction;
-  fixtureDef->restitution = restitution;
-  fixture = body->CreateFixture(fixtureDef);
-  body->SetFixedRotation(frezeRotation);
-
-  body->GetUserData().pointer = reinterpret_cast<uintptr_t>(userData);
+  b2FixtureDef fixtureDef;
+  fixtureDef.shape = &polygonShape;
+  fixtureDef.density = density;
+  fixtureDef.friction = friction;
+  fixtureDef.restitution = restitution;
+
+  if (partitionedWorld) {
+    bodyId = partitionedWorld->CreateBody(bodyDef, fixtureDef);
+  } else {
+    body = world->CreateBody(&bodyDef);
+    body->CreateFixture(&fixtureDef);
+  }
 }
 
 RigidBodyComponent::~RigidBodyComponent() {
+  if (partitionedWorld && bodyId != PartitionedPhysicsWorld::INVALID_BODY) {
+    partitionedWorld->DestroyBody(bodyId);
+    bodyId = PartitionedPhysicsWorld::INVALID_BODY;
+  }
   if (world && body) {
     world->DestroyBody(body);
     body = nullptr;
   }
-  delete bodyDef;
-  delete polygonShape;
-  delete fixtureDef;
-  bodyDef = nullptr;
-  polygonShape = nullptr;
-  fixtureDef = nullptr;
 }
 
-b2Body* RigidBodyComponent::GetBody() const { return body; }
+b2Body* RigidBodyComponent::GetBody() const {
+  return partitionedWorld ? partitionedWorld->GetBody(bodyId) : body;
+}
 
 void RigidBodyComponent::FreezeRotation(bool freeze) {
-  body->SetFixedRotation(freeze);
+  GetBody()->SetFixedRotation(freeze);
 }
 
-b2Vec2 RigidBodyComponent::GetPosition() const { return body->GetPosition(); }
+b2Vec2 RigidBodyComponent::GetPosition() const {
+  return GetBody()->GetPosition();
+}
 
 sf::Vector2f RigidBodyComponent::GetPositionSFML() const {
-  return sf::Vector2f(body->GetPosition().x, body->GetPosition().y);
+  return PhysicsUnits::ToPixels(GetBody()->GetPosition());
 }
 
 void RigidBodyComponent::AddVelocity(b2Vec2 velocity) {
-  body->SetLinearVelocity(velocity);
+  GetBody()->SetLinearVelocity(velocity);
+}
+
+void RigidBodyComponent::SetEnabled(bool enabled) {
+  if (partitionedWorld) {
+    partitionedWorld->SetEnabled(bodyId, enabled);
+  } else if (body) {
+    body->SetEnabled(enabled);
+  }
+}
+
+void RigidBodyComponent::Teleport(sf::Vector2f position) {
+  Expects(transform != nullptr);
+  transform->SetPosition(position);
+  const b2Vec2 meters{PhysicsUnits::ToMeters(position)};
+  if (partitionedWorld) {
+    partitionedWorld->SetTransform(bodyId, meters, 0.f);
+  } else if (body) {
+    body->SetTransform(meters, 0.f);
+  }
+  if (b2Body* current = GetBody()) {
+    current->SetLinearVelocity(b2Vec2(0.f, 0.f));
+    current->SetAngularVelocity(0.f);
+  }
 }
 
 void RigidBodyComponent::Update(float& deltaTime) {
   if (spriteComponent != nullptr && transform != nullptr) {
-    bodyPos = body->GetPosition();
-    trsPos = sf::Vector2f(bodyPos.x, bodyPos.y);
+    bodyPos = GetBody()->GetPosition();
+    trsPos = PhysicsUnits::ToPixels(bodyPos);
     transform->SetPosition(trsPos);
   }
 }
\ No newline at end of file
@@ -2,19 +2,20 @@
 
 #include <gsl/assert>
 #include <gsl/narrow>
-#include <iostream>
 
 #include "Components/EntityManager.hh"
+#include "TextureCache.hh"
 
 SpriteComponent::SpriteComponent(const char* textureUrl, unsigned int col,
-                                 unsigned int row) {
-  this->textureUrl = textureUrl;
+                                 unsigned int row)
+    : SpriteComponent(TextureCache::Acquire(textureUrl), col, row) {}
+
+SpriteComponent::SpriteComponent(std::shared_ptr<const sf::Texture> texture,
+                                 unsigned int col, unsigned int row)
+    : texture(std::move(texture)) {
+  Expects(this->texture != nullptr);
   this->col = col;
   this->row = row;
-
-  if (!texture.loadFromFile(textureUrl)) {
-    std::cerr << "Failed to load texture: " << textureUrl << std::endl;
-  }
 }
 
 void SpriteComponent::Initialize() {
@@ -31,7 +32,7 @@ void SpriteComponent::Initialize() {
 
   // Create sprite once transform is available
   sprite =
-      std::make_unique<sf::Sprite>(texture, sf::IntRect({left, top}, {w, h}));
+      std::make_unique<sf::Sprite>(*texture, sf::IntRect({left, top}, {w, h}));
 
   sprite->setPosition(transform->GetPosition());
   sprite->setScale(sf::Vector2f(transform->GetScale(), transform->GetScale()));
@@ -75,3 +76,7 @@ void SpriteComponent::RebindRectTexture(int col, int row, float width,
         {col, row},
         {gsl::narrow_cast<int>(width), gsl::narrow_cast<int>(height)}));
 }
+
+void SpriteComponent::SetTextureRect(const sf::IntRect& rect) {
+  if (sprite) sprite->setTextureRect(rect);
+}
@@ -1,32 +1,61 @@
 #include "ContactEventManager.hh"
 
-#include <iostream>
-
 #include "AudioClip.hh"
 #include "Components/AudioListenerComponent.hh"
 #include "Components/Component.hh"
 #include "Components/Entity.hh"
 #include "Components/EntityManager.hh"
 #include "Components/RigidBodyComponent.hh"
+#include "Log.hh"
 
 ContactEventManager::ContactEventManager() {}
 
 ContactEventManager::~ContactEventManager() {}
 
-void ContactEventManager::BeginContact(b2Contact* contact) {
-  if (!contact) return;
+namespace {
+bool GetActors(b2Contact* contact, Entity*& actorA, Entity*& actorB) {
+  if (!contact) return false;
   auto* fA = contact->GetFixtureA();
   auto* fB = contact->GetFixtureB();
-  if (!fA || !fB) return;
+  if (!fA || !fB) return false;
   auto* bA = fA->GetBody();
   auto* bB = fB->GetBody();
-  if (!bA || !bB) return;
-  Entity* actorA{reinterpret_cast<Entity*>(bA->GetUserData().pointer)};
-  Entity* actorB{reinterpret_cast<Entity*>(bB->GetUserData().pointer)};
+  if (!bA || !bB) return false;
+  actorA = reinterpret_cast<Entity*>(bA->GetUserData().pointer);
+  actorB = reinterpret_cast<Entity*>(bB->GetUserData().pointer);
+  return true;
+}
+}  // namespace
+
+void ContactEventManager::BeginContact(b2Contact* contact) {
+  Entity* actorA{};
+  Entity* actorB{};
+  if (GetActors(contact, actorA, actorB)) HandleBeginContact(actorA, actorB);
+}
+
+void ContactEventManager::EndContact(b2Contact* contact) {
+  Entity* actorA{};
+  Entity* actorB{};
+  if (GetActors(contact, actorA, actorB)) HandleEndContact(actorA, actorB);
+}
+
+void ContactEventManager::Dispatch(
+    const std::vector<PhysicsContactEvent>& events) {
+  for (const auto& event : events) {
+    auto* actorA{reinterpret_cast<Entity*>(event.userDataA)};
+    auto* actorB{reinterpret_cast<Entity*>(event.userDataB)};
+    if (event.type == PhysicsContactEvent::Type::Begin) {
+      HandleBeginContact(actorA, actorB);
+    } else {
+      HandleEndContact(actorA, actorB);
+    }
+  }
+}
 
+void ContactEventManager::HandleBeginContact(Entity* actorA, Entity* actorB) {
   if (actorA && actorB) {
-    std::cout << "Collision: " << actorA->name << ", " << actorB->name
-              << std::endl;
+    BEP_LOG_DEBUG(LogCategory::Physics, "Collision: {}, {}", actorA->name,
+                  actorB->name);
     if (actorB->name.compare("chest") == 0) {
       // Play chest hit sound effect using hero's audio listener
       if (actorA->name.compare("hero") == 0) {
@@ -41,4 +70,4 @@ void ContactEventManager::BeginContact(b2Contact* contact) {
     }
   }
 }
-void ContactEventManager::EndContact(b2Contact* contact) {}
\ No newline at end of file
+void ContactEventManager::HandleEndContact(Entity* actorA, Entity* actorB) {}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "CookedAssets.hh"
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+
+#include "AssetFiles.hh"
+#include "Log.hh"
+
+namespace {
+
+constexpr const char* KIND_NAMES[]{"texture", "map", "clip"};
+static_assert(std::size(KIND_NAMES) ==
+                  static_cast<std::size_t>(CookedKind::Count),
+              "KIND_NAMES must list every CookedKind");
+
+constexpr std::size_t REQUIRED_FIELDS{7};
+
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view text) const {
+    return std::hash<std::string_view>{}(text);
+  }
+};
+
+struct CookedState {
+  std::unordered_map<std::string, ManifestRecord, StringHash,
+                     std::equal_to<>>
+      records;
+};
+
+CookedState& State() {
+  static CookedState state;
+  return state;
+}
+
+template <typename T>
+bool ParseNumber(std::string_view text, T& value, int base = 10) {
+  const char* end{text.data() + text.size()};
+  const auto [ptr, ec]{std::from_chars(text.data(), end, value, base)};
+  return ec == std::errc{} && ptr == end;
+}
+
+template <typename T>
+void AppendNumber(std::string& out, T value, int base = 10) {
+  char buffer[24];
+  const auto [ptr, ec]{
+      std::to_chars(buffer, buffer + sizeof(buffer), value, base)};
+  out.append(buffer, ptr);
+}
+
+// Whether the loose source still matches what was cooked
+bool IsCurrent(const ManifestRecord& record) {
+#ifdef NDEBUG
+  return true;
+#else
+  namespace fs = std::filesystem;
+  const fs::path source{record.source};
+  std::error_code ec;
+  const auto size{fs::file_size(source, ec)};
+  if (ec) return true;  // packed, or gone: trust the manifest
+  const auto time{fs::last_write_time(source, ec)};
+  return ec || (static_cast<std::int64_t>(size) == record.sourceSize &&
+                time.time_since_epoch().count() == record.sourceTime);
+#endif
+}
+
+// The RGBA8 pixels of a cooked texture, or null if 'data' isn't one
+const std::uint8_t* GetCookedPixels(const AssetData& data,
+                                    sf::Vector2u& size) {
+  CookedTextureHeader header{};
+  if (data.GetSize() < sizeof(header)) return nullptr;
+  std::memcpy(&header, data.GetData(), sizeof(header));
+  if (std::memcmp(header.magic, COOKED_TEXTURE_MAGIC,
+                  sizeof(COOKED_TEXTURE_MAGIC)) != 0 ||
+      header.version != COOKED_VERSION ||
+      data.GetSize() - sizeof(header) !=
+          std::uint64_t{header.width} * header.height * 4) {
+    return nullptr;
+  }
+  size = sf::Vector2u(header.width, header.height);
+  return reinterpret_cast<const std::uint8_t*>(data.GetData()) +
+         sizeof(header);
+}
+
+}  // namespace
+
+namespace CookedManifest {
+
+bool Parse(std::string_view line, ManifestRecord& record) {
+  if (line.empty() || line.front() == '#') return false;
+  std::vector<std::string_view> fields;
+  while (true) {
+    const std::size_t tab{line.find('\t')};
+    fields.push_back(line.substr(0, tab));
+    if (tab == std::string_view::npos) break;
+    line.remove_prefix(tab + 1);
+  }
+  if (fields.size() < REQUIRED_FIELDS) return false;
+
+  const auto kind{std::find(std::begin(KIND_NAMES), std::end(KIND_NAMES),
+                            fields[0])};
+  if (kind == std::end(KIND_NAMES) ||
+      !ParseNumber(fields[1], record.key, 16) ||
+      !ParseNumber(fields[2], record.sourceHash, 16) ||
+      !ParseNumber(fields[3], record.sourceSize) ||
+      !ParseNumber(fields[4], record.sourceTime) || fields[5].empty()) {
+    return false;
+  }
+  record.kind = static_cast<CookedKind>(kind - std::begin(KIND_NAMES));
+  record.source = fields[5];
+  record.cooked = fields[6];
+  record.dependencies.assign(fields.begin() + REQUIRED_FIELDS, fields.end());
+  return true;
+}
+
+std::string Format(const ManifestRecord& record) {
+  std::string line{GetKindName(record.kind)};
+  line += '\t';
+  AppendNumber(line, record.key, 16);
+  line += '\t';
+  AppendNumber(line, record.sourceHash, 16);
+  line += '\t';
+  AppendNumber(line, record.sourceSize);
+  line += '\t';
+  AppendNumber(line, record.sourceTime);
+  line += '\t';
+  line += record.source;
+  line += '\t';
+  line += record.cooked;
+  for (const std::string& dependency : record.dependencies) {
+    line += '\t';
+    line += dependency;
+  }
+  return line;
+}
+
+const char* GetKindName(CookedKind kind) {
+  const auto index{static_cast<std::size_t>(kind)};
+  return index < std::size(KIND_NAMES) ? KIND_NAMES[index] : "unknown";
+}
+
+std::uint64_t Hash(const void* data, std::size_t size, std::uint64_t seed) {
+  const auto* bytes{static_cast<const unsigned char*>(data)};
+  std::uint64_t hash{seed};
+  for (std::size_t i{}; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+}  // namespace CookedManifest
+
+bool CookedAssets::Load(const std::string& manifestPath) {
+  CookedState& state{State()};
+  state.records.clear();
+  const AssetData data{AssetFiles::Read(manifestPath)};
+  if (!data) {
+    BEP_LOG_INFO(LogCategory::Assets, "No {}; loading source assets",
+                 manifestPath);
+    return false;
+  }
+
+  std::string_view text{data.GetText()};
+  while (!text.empty()) {
+    const std::size_t newline{text.find('\n')};
+    const std::string_view line{text.substr(0, newline)};
+    text.remove_prefix(newline == std::string_view::npos ? text.size()
+                                                         : newline + 1);
+    ManifestRecord record;
+    if (!CookedManifest::Parse(line, record) || record.cooked.empty()) {
+      continue;
+    }
+    std::string source{record.source};
+    state.records.insert_or_assign(std::move(source), std::move(record));
+  }
+  BEP_LOG_INFO(LogCategory::Assets, "Loaded {}: {} cooked assets",
+               manifestPath, state.records.size());
+  return true;
+}
+
+void CookedAssets::Clear() { State().records.clear(); }
+
+int CookedAssets::GetEntryCount() {
+  return static_cast<int>(State().records.size());
+}
+
+const std::string* CookedAssets::Find(std::string_view source,
+                                      CookedKind kind) {
+  const CookedState& state{State()};
+  const auto it{state.records.find(source)};
+  if (it == state.records.end() || it->second.kind != kind ||
+      !IsCurrent(it->second)) {
+    return nullptr;
+  }
+  return &it->second.cooked;
+}
+
+void CookedAssets::Forget(std::string_view source) {
+  CookedState& state{State()};
+  if (const auto it{state.records.find(source)}; it != state.records.end()) {
+    state.records.erase(it);
+  }
+}
+
+bool CookedAssets::LoadTexture(sf::Texture& texture, const std::string& path) {
+  if (const std::string* cooked{Find(path, CookedKind::Texture)}) {
+    const AssetData data{AssetFiles::Read(*cooked)};
+    sf::Vector2u size;
+    // No decode: the pixels go straight to the upload
+    if (const std::uint8_t* pixels{GetCookedPixels(data, size)};
+        pixels && texture.resize(size)) {
+      texture.update(pixels);
+      return true;
+    }
+    BEP_LOG_WARNING(LogCategory::Assets,
+                    "Ignoring invalid cooked texture {} for {}", *cooked,
+                    path);
+  }
+  const AssetData data{AssetFiles::Read(path)};
+  return data && texture.loadFromMemory(data.GetData(), data.GetSize());
+}
+
+bool CookedAssets::LoadImage(sf::Image& image, const std::string& path) {
+  if (const std::string* cooked{Find(path, CookedKind::Texture)}) {
+    const AssetData data{AssetFiles::Read(*cooked)};
+    sf::Vector2u size;
+    if (const std::uint8_t* pixels{GetCookedPixels(data, size)}) {
+      image = sf::Image(size, pixels);
+      return true;
+    }
+    BEP_LOG_WARNING(LogCategory::Assets,
+                    "Ignoring invalid cooked texture {} for {}", *cooked,
+                    path);
+  }
+  const AssetData data{AssetFiles::Read(path)};
+  return data && image.loadFromMemory(data.GetData(), data.GetSize());
+}
@@ -2,45 +2,43 @@
 
 #include <cmath>
 
-DrawPhysics::DrawPhysics(sf::RenderWindow* window) {
-  Expects(window != nullptr);
-  this->window = window;
-}
+DrawPhysics::DrawPhysics(sf::RenderTarget* target) : target(target) {}
 
 DrawPhysics::~DrawPhysics() {}
 
-/// Draw a closed polygon provided in CCW order.
-void DrawPhysics::DrawPolygon(const b2Vec2* vertices, int32 vertexCount,
-                              const b2Color& color) {
-  sf::ConvexShape convexShape{sf::ConvexShape(vertexCount)};
+sf::ConvexShape& DrawPhysics::BuildPolygon(const b2Vec2* vertices,
+                                           int32 vertexCount) {
+  polygon.setPointCount(static_cast<std::size_t>(vertexCount));
   for (int i{}; i < vertexCount; i++) {
     sf::Vector2f transformedVector{DrawPhysics::B2VecToSFVec(vertices[i])};
-    convexShape.setPoint(i, sf::Vector2f(std::floor(transformedVector.x),
-                                         std::floor(transformedVector.y)));
+    polygon.setPoint(i, sf::Vector2f(std::floor(transformedVector.x),
+                                     std::floor(transformedVector.y)));
   }
+  return polygon;
+}
+
+/// Draw a closed polygon provided in CCW order.
+void DrawPhysics::DrawPolygon(const b2Vec2* vertices, int32 vertexCount,
+                              const b2Color& color) {
+  sf::ConvexShape& convexShape{BuildPolygon(vertices, vertexCount)};
 
   // draw polygon
   convexShape.setOutlineColor(DrawPhysics::GLColorToSFML(color));
   convexShape.setFillColor(sf::Color::Transparent);
   convexShape.setOutlineThickness(-2.f);
-  if (window) window->draw(convexShape);
+  if (target) target->draw(convexShape);
 }
 
 /// Draw a solid closed polygon provided in CCW order.
 void DrawPhysics::DrawSolidPolygon(const b2Vec2* vertices, int32 vertexCount,
                                    const b2Color& color) {
-  sf::ConvexShape convexShape{sf::ConvexShape(vertexCount)};
-  for (int i{}; i < vertexCount; i++) {
-    sf::Vector2f transformedVector{DrawPhysics::B2VecToSFVec(vertices[i])};
-    convexShape.setPoint(i, sf::Vector2f(std::floor(transformedVector.x),
-                                         std::floor(transformedVector.y)));
-  }
+  sf::ConvexShape& convexShape{BuildPolygon(vertices, vertexCount)};
 
   // draw polygon
   convexShape.setOutlineColor(DrawPhysics::GLColorToSFML(color));
   convexShape.setFillColor(DrawPhysics::GLColorToSFML(color, 60.f));
   convexShape.setOutlineThickness(-2.f);
-  if (window) window->draw(convexShape);
+  if (target) target->draw(convexShape);
 }
 
 /// Draw a circle.
@@ -0,0 +1,83 @@
+#include "EngineAllocator.hh"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+struct TagCounters {
+  std::atomic<std::int64_t> currentBytes{};
+  std::atomic<std::int64_t> peakBytes{};
+  std::atomic<std::int64_t> allocations{};
+  std::atomic<std::int64_t> frees{};
+};
+
+TagCounters counters[static_cast<std::size_t>(MemoryTag::Count)];
+
+// Keeps the user pointer aligned like malloc's result
+struct alignas(alignof(std::max_align_t)) BlockHeader {
+  std::size_t size;
+  MemoryTag tag;
+};
+
+TagCounters& CountersFor(MemoryTag tag) {
+  return counters[static_cast<std::size_t>(tag)];
+}
+
+}  // namespace
+
+void* EngineAllocator::Allocate(std::size_t size, MemoryTag tag) {
+  auto* header =
+      static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+  if (!header) return nullptr;
+  header->size = size;
+  header->tag = tag;
+
+  TagCounters& c{CountersFor(tag)};
+  const std::int64_t bytes{static_cast<std::int64_t>(size)};
+  const std::int64_t current{
+      c.currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes};
+  c.allocations.fetch_add(1, std::memory_order_relaxed);
+  std::int64_t peak{c.peakBytes.load(std::memory_order_relaxed)};
+  while (current > peak && !c.peakBytes.compare_exchange_weak(
+                               peak, current, std::memory_order_relaxed)) {
+  }
+  return header + 1;
+}
+
+void EngineAllocator::Free(void* memory) {
+  if (!memory) return;
+  BlockHeader* header{static_cast<BlockHeader*>(memory) - 1};
+  TagCounters& c{CountersFor(header->tag)};
+  c.currentBytes.fetch_sub(static_cast<std::int64_t>(header->size),
+                           std::memory_order_relaxed);
+  c.frees.fetch_add(1, std::memory_order_relaxed);
+  std::free(header);
+}
+
+MemorySnapshot EngineAllocator::GetSnapshot(MemoryTag tag) {
+  const TagCounters& c{CountersFor(tag)};
+  return MemorySnapshot{c.currentBytes.load(std::memory_order_relaxed),
+                        c.peakBytes.load(std::memory_order_relaxed),
+                        c.allocations.load(std::memory_order_relaxed),
+                        c.frees.load(std::memory_order_relaxed)};
+}
+
+const char* EngineAllocator::GetTagName(MemoryTag tag) {
+  switch (tag) {
+    case MemoryTag::General:
+      return "General";
+    case MemoryTag::Physics:
+      return "Physics";
+    case MemoryTag::Audio:
+      return "Audio";
+    case MemoryTag::Animation:
+      return "Animation";
+    case MemoryTag::Assets:
+      return "Assets";
+    case MemoryTag::Scratch:
+      return "Scratch";
+    default:
+      return "Unknown";
+  }
+}
@@ -3,9 +3,8 @@
 #include <gsl/assert>
 
 #include "Components/EntityManager.hh"
-#include "InputSystem.hh"
 
-FlipSprite::FlipSprite() {}
+FlipSprite::FlipSprite(const InputSystem& input) : input(input) {}
 
 FlipSprite::~FlipSprite() {}
 
@@ -14,13 +13,12 @@ void FlipSprite::Initialize() {
   spriteComponent = owner->GetComponent<SpriteComponent>();
   Expects(transform != nullptr);
   Expects(spriteComponent != nullptr);
+  moveX = input.FindAxis("moveX");
 }
 
 void FlipSprite::Update(float& deltaTime) {
   Expects(spriteComponent != nullptr);
-  sf::Vector2f axis = InputSystem::Axis();
-  spriteComponent->SetFlipTexture(axis.x < 0 ? true
-                                  : axis.x > 0
-                                      ? false
-                                      : spriteComponent->GetFlipTexture());
+  const float axisX{input.GetSnapshot().GetAxis(moveX)};
+  // Keep facing the last direction while idle
+  if (axisX != 0.f) spriteComponent->SetFlipTexture(axisX < 0.f);
 }
@@ -0,0 +1,119 @@
+#include "FrameArena.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <gsl/assert>
+#include <new>
+
+#include "EngineAllocator.hh"
+
+namespace {
+
+// Bumped by FrameArena::EndFrame; arenas compare it with their own epoch
+std::atomic<std::uint64_t> frameEpoch{};
+
+constexpr std::size_t ChunkHeaderSize() {
+  // Keeps chunk data aligned like EngineAllocator's blocks
+  constexpr std::size_t align{alignof(std::max_align_t)};
+  return (sizeof(void*) + sizeof(std::size_t) + align - 1) / align * align;
+}
+
+}  // namespace
+
+FrameArena::FrameArena(std::size_t capacity)
+    : initialCapacity(std::max(capacity, ChunkHeaderSize() * 2)) {}
+
+FrameArena::~FrameArena() { FreeChunks(); }
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  Expects(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  const auto align = [alignment](std::byte* at) {
+    const auto address{reinterpret_cast<std::uintptr_t>(at)};
+    return reinterpret_cast<std::byte*>((address + alignment - 1) &
+                                        ~(alignment - 1));
+  };
+  std::byte* result{head ? align(cursor) : nullptr};
+  if (!result || result > end ||
+      static_cast<std::size_t>(end - result) < bytes) {
+    Grow(bytes + alignment);
+    result = align(cursor);
+  }
+  cursor = result + bytes;
+  return result;
+}
+
+bool FrameArena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+void FrameArena::Grow(std::size_t minBytes) {
+  if (head) {
+    retiredBytes += static_cast<std::size_t>(
+        cursor - reinterpret_cast<std::byte*>(head) - ChunkHeaderSize());
+    ++overflows;
+  }
+  // Double on overflow so a frame needs few extra chunks
+  const std::size_t size{std::max(head ? head->size * 2 : initialCapacity,
+                                  minBytes + ChunkHeaderSize())};
+  void* memory{EngineAllocator::Allocate(size, MemoryTag::Scratch)};
+  if (!memory) throw std::bad_alloc();
+  head = new (memory) Chunk{head, size};
+  cursor = static_cast<std::byte*>(memory) + ChunkHeaderSize();
+  end = static_cast<std::byte*>(memory) + size;
+  capacity += size;
+}
+
+void FrameArena::FreeChunks() {
+  while (head) {
+    Chunk* previous{head->previous};
+    EngineAllocator::Free(head);
+    head = previous;
+  }
+  cursor = nullptr;
+  end = nullptr;
+  capacity = 0;
+}
+
+void FrameArena::Reset() {
+  highWaterBytes = std::max(highWaterBytes, GetUsedBytes());
+  retiredBytes = 0;
+  if (!head) return;
+  if (head->previous) {
+    // Overflowed: replace the chain with one chunk that holds all of it
+    const std::size_t merged{capacity};
+    FreeChunks();
+    Grow(merged - ChunkHeaderSize());
+    return;
+  }
+  cursor = reinterpret_cast<std::byte*>(head) + ChunkHeaderSize();
+}
+
+std::size_t FrameArena::GetUsedBytes() const {
+  if (!head) return 0;
+  return retiredBytes +
+         static_cast<std::size_t>(cursor - reinterpret_cast<std::byte*>(head) -
+                                  ChunkHeaderSize());
+}
+
+std::size_t FrameArena::GetCapacity() const { return capacity; }
+
+std::size_t FrameArena::GetHighWaterBytes() const {
+  return std::max(highWaterBytes, GetUsedBytes());
+}
+
+std::int64_t FrameArena::GetOverflowCount() const { return overflows; }
+
+FrameArena& FrameArena::ForThread() {
+  thread_local FrameArena arena;
+  const std::uint64_t epoch{frameEpoch.load(std::memory_order_acquire)};
+  if (arena.epoch != epoch) {
+    arena.Reset();
+    arena.epoch = epoch;
+  }
+  return arena;
+}
+
+void FrameArena::EndFrame() {
+  frameEpoch.fetch_add(1, std::memory_order_release);
+}
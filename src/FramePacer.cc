@@ -0,0 +1,127 @@
+#include "FramePacer.hh"
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cmath>
+#include <gsl/assert>
+#include <thread>
+
+namespace {
+
+// Bounds for the spin margin: enough for a tickless Linux kernel at the low
+// end, a missed 1 ms Windows timer period plus scheduling at the high end
+constexpr double MIN_SPIN_MS{0.2};
+constexpr double MAX_SPIN_MS{4.0};
+// Initial guess, before any sleep has been measured
+constexpr double INITIAL_OVERSHOOT_MS{1.0};
+// Per-sleep decay of the remembered worst overshoot
+constexpr double OVERSHOOT_DECAY{0.98};
+// Weight of the newest frame in the running mean (~50 frame window)
+constexpr double MEAN_WEIGHT{0.02};
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+}  // namespace
+
+FramePacer::FramePacer(const FramePacerSettings& settings)
+    : sleepOvershootMs(INITIAL_OVERSHOOT_MS) {
+  SetSettings(settings);
+}
+
+void FramePacer::SetSettings(const FramePacerSettings& newSettings) {
+  Expects(newSettings.targetRate >= 0.f);
+  Expects(newSettings.backgroundRate >= 0.f);
+  settings = newSettings;
+}
+
+const FramePacerSettings& FramePacer::GetSettings() const { return settings; }
+
+void FramePacer::SetBackground(bool isBackground) {
+  background = isBackground;
+}
+
+double FramePacer::CurrentPeriodMs() const {
+  float rate{settings.vsync ? 0.f : settings.targetRate};
+  if (background && settings.backgroundRate > 0.f &&
+      (rate <= 0.f || settings.backgroundRate < rate)) {
+    rate = settings.backgroundRate;
+  }
+  return rate > 0.f ? 1000.0 / rate : 0.0;
+}
+
+double FramePacer::SpinMarginMs() const {
+  return std::clamp(sleepOvershootMs * 1.25 + 0.1, MIN_SPIN_MS, MAX_SPIN_MS);
+}
+
+void FramePacer::EndFrame() {
+  const double periodMs{CurrentPeriodMs()};
+  Clock::time_point now{Clock::now()};
+  if (!started) {
+    started = true;
+    lastFrame = now;
+    deadline = now;
+    return;
+  }
+
+  if (periodMs > 0.0) {
+    deadline += std::chrono::duration_cast<Clock::duration>(
+        Milliseconds(periodMs));
+    if (now > deadline) {
+      ++stats.missedDeadlines;
+      deadline = now;
+    } else {
+      WaitUntil(deadline);
+      now = Clock::now();
+    }
+  } else {
+    deadline = now;
+  }
+
+  const double frameMs{Milliseconds(now - lastFrame).count()};
+  lastFrame = now;
+  Record(frameMs, periodMs);
+}
+
+void FramePacer::WaitUntil(Clock::time_point target) {
+  const auto sleepUntil{target - std::chrono::duration_cast<Clock::duration>(
+                                     Milliseconds(SpinMarginMs()))};
+  const Clock::time_point before{Clock::now()};
+  if (sleepUntil > before) {
+    const double requestedMs{Milliseconds(sleepUntil - before).count()};
+    // sf::sleep raises the Windows timer resolution to 1 ms for the call
+    sf::sleep(sf::microseconds(
+        static_cast<std::int64_t>(requestedMs * 1000.0)));
+    const double overshootMs{Milliseconds(Clock::now() - before).count() -
+                             requestedMs};
+    sleepOvershootMs =
+        std::max(overshootMs, sleepOvershootMs * OVERSHOOT_DECAY);
+  }
+  while (Clock::now() < target) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::Record(double frameMs, double periodMs) {
+  ++stats.frames;
+  stats.lastFrameMs = static_cast<float>(frameMs);
+  stats.meanFrameMs =
+      stats.frames == 1
+          ? static_cast<float>(frameMs)
+          : static_cast<float>(stats.meanFrameMs +
+                               (frameMs - stats.meanFrameMs) * MEAN_WEIGHT);
+
+  const double reference{periodMs > 0.0 ? periodMs : stats.meanFrameMs};
+  const auto deviation{static_cast<float>(std::abs(frameMs - reference))};
+  const auto& edges{FramePacerStats::JITTER_BUCKET_EDGES_MS};
+  const auto bucket{static_cast<std::size_t>(
+      std::upper_bound(edges.begin(), edges.end(), deviation) -
+      edges.begin())};
+  ++stats.jitterHistogram[bucket];
+
+  stats.spinMarginMs = static_cast<float>(SpinMarginMs());
+  stats.background = background;
+}
+
+const FramePacerStats& FramePacer::GetStats() const { return stats; }
+
+void FramePacer::ResetStats() { stats = FramePacerStats{}; }
@@ -0,0 +1,91 @@
+#include "FrameProfiler.hh"
+
+#include <algorithm>
+#include <gsl/assert>
+
+void FrameProfiler::AddSample(FramePhase phase, double ms) {
+  const auto index{static_cast<std::size_t>(phase)};
+  Expects(index < PHASE_COUNT);
+  currentMs[index] += ms;
+  ranThisFrame[index] = true;
+}
+
+void FrameProfiler::EndFrame() {
+  for (std::size_t i{}; i < PHASE_COUNT; ++i) {
+    FramePhaseStats& phase{phases[i]};
+    phase.lastMs = static_cast<float>(currentMs[i]);
+    if (ranThisFrame[i]) {
+      phase.totalMs += currentMs[i];
+      phase.maxMs = std::max(phase.maxMs, phase.lastMs);
+      ++phase.frames;
+    }
+    currentMs[i] = 0.0;
+    ranThisFrame[i] = false;
+  }
+
+  const Clock::time_point now{Clock::now()};
+  // The first frame has no start to measure from
+  if (frames > 0) {
+    frameHistory[historyNext] = static_cast<float>(
+        std::chrono::duration<double, std::milli>(now - lastFrameEnd).count());
+    historyNext = (historyNext + 1) % HISTORY_FRAMES;
+  }
+  lastFrameEnd = now;
+  ++frames;
+}
+
+const FramePhaseStats& FrameProfiler::GetPhase(FramePhase phase) const {
+  const auto index{static_cast<std::size_t>(phase)};
+  Expects(index < PHASE_COUNT);
+  return phases[index];
+}
+
+const char* FrameProfiler::GetPhaseName(FramePhase phase) {
+  switch (phase) {
+    case FramePhase::Input:
+      return "input";
+    case FramePhase::Physics:
+      return "physics";
+    case FramePhase::Entities:
+      return "entities";
+    case FramePhase::Animation:
+      return "animation";
+    case FramePhase::Render:
+      return "render";
+    case FramePhase::Ui:
+      return "ui";
+    case FramePhase::Overlay:
+      return "overlay";
+    case FramePhase::Checksum:
+      return "checksum";
+    case FramePhase::Count:
+      break;
+  }
+  return "?";
+}
+
+const std::array<float, FrameProfiler::HISTORY_FRAMES>&
+FrameProfiler::GetFrameHistory() const {
+  return frameHistory;
+}
+
+std::size_t FrameProfiler::GetHistoryOffset() const { return historyNext; }
+
+float FrameProfiler::GetLastFrameMs() const {
+  if (frames < 2) return 0.f;
+  return frameHistory[(historyNext + HISTORY_FRAMES - 1) % HISTORY_FRAMES];
+}
+
+float FrameProfiler::GetAverageFrameMs() const {
+  const auto filled{static_cast<std::size_t>(std::min<std::int64_t>(
+      std::max<std::int64_t>(frames - 1, 0), HISTORY_FRAMES))};
+  if (filled == 0) return 0.f;
+  double sum{};
+  for (std::size_t i{}; i < filled; ++i) {
+    sum += frameHistory[(historyNext + HISTORY_FRAMES - 1 - i) %
+                        HISTORY_FRAMES];
+  }
+  return static_cast<float>(sum / static_cast<double>(filled));
+}
+
+std::int64_t FrameProfiler::GetFrameCount() const { return frames; }
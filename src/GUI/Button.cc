@@ -1,11 +1,12 @@
 #include "GUI/Button.hh"
 
-#include <iostream>
+#include "GraphicsContext.hh"
+#include "TextureCache.hh"
 
-Button::Button(TransformComponent& transform, float borderSize,
-               sf::Color fillColor, sf::Color borderColor,
+Button::Button(TransformComponent& transform, const InputSystem& input,
+               float borderSize, sf::Color fillColor, sf::Color borderColor,
                std::function<void()> onClickAction)
-    : transform(transform) {
+    : transform(transform), input(input) {
   Expects(borderSize >= 0.0f);
   this->borderSize = borderSize;
   this->fillColor = fillColor;
@@ -16,11 +17,10 @@ Button::Button(TransformComponent& transform, float borderSize,
 Button::~Button() {}
 
 void Button::SetTexture(std::string texturePath) {
-  texture = sf::Texture();
-  if (texture.loadFromFile(texturePath)) {
-    rectangleShape.setTexture(&texture);
-  } else {
-    std::cerr << "Failed to load button texture: " << texturePath << std::endl;
+  texture = TextureCache::Acquire(texturePath);
+  // A failed load keeps the plain fill (TextureCache logged it)
+  if (GraphicsContext::IsAvailable() && texture->getSize().x > 0) {
+    rectangleShape.setTexture(texture.get());
   }
 }
 
@@ -39,6 +39,7 @@ void Button::Initialize() {
   rectangleShape.setFillColor(fillColor);
   rectangleShape.setOutlineColor(borderColor);
   rectangleShape.setOutlineThickness(borderSize);
+  clickAction = input.FindAction("click");
 }
 
 void Button::OnClick() {
@@ -53,8 +54,10 @@ void Button::Update(float& deltaTime) {}
 
 void Button::Render(sf::RenderWindow& window) {
   window.draw(rectangleShape);
-  sf::Vector2i mousePos = sf::Mouse::getPosition(
-      window);  // captura si estamos en el area de la venta de nuestor juego
+  const InputSnapshot& frameInput{input.GetSnapshot()};
+  sf::Vector2i mousePos =
+      frameInput.mousePosition;  // captura si estamos en el area de la venta
+                                 // de nuestor juego
   sf::Vector2f mouseTranslate =
       window.mapPixelToCoords(mousePos);  // este captura cuanto se ha movido el
                                           // mouse dentro de la ventana
@@ -62,7 +65,7 @@ void Button::Render(sf::RenderWindow& window) {
           mouseTranslate))  // si esa traslación fue sobre la forma de nuestro
                             // rectangulo
   {
-    if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
+    if (frameInput.IsActionDown(clickAction)) {
       if (onClickAction) {
         OnClick();
       }
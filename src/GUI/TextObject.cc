@@ -1,6 +1,6 @@
 #include "GUI/TextObject.hh"
 
-#include <iostream>
+#include "Log.hh"
 
 TextObject::TextObject(std::string fontUrl, int size, sf::Color color,
                        std::uint32_t style) {
@@ -9,9 +9,7 @@ TextObject::TextObject(std::string fontUrl, int size, sf::Color color,
   this->color = color;
   Expects(this->size >= 0);
 
-  if (!font.openFromFile(this->fontUrl)) {
-    std::cerr << "Failed to load font: " << this->fontUrl << std::endl;
-  }
+  LoadFont();
   text = std::make_unique<sf::Text>(font);
   text->setCharacterSize(size);
   text->setFillColor(color);
@@ -27,9 +25,7 @@ TextObject::TextObject(std::string fontUrl, int size, sf::Color color,
   this->textStr = std::move(textStr);
   Expects(this->size >= 0);
 
-  if (!font.openFromFile(this->fontUrl)) {
-    std::cerr << "Failed to load font: " << this->fontUrl << std::endl;
-  }
+  LoadFont();
   text = std::make_unique<sf::Text>(font);
   text->setCharacterSize(size);
   text->setFillColor(color);
@@ -40,6 +36,15 @@ TextObject::TextObject(std::string fontUrl, int size, sf::Color color,
 
 TextObject::~TextObject() {}
 
+void TextObject::LoadFont() {
+  // sf::Font reads glyphs from the buffer lazily, so it has to outlive it
+  fontData = AssetFiles::Read(fontUrl);
+  if (!fontData || !font.openFromMemory(fontData.GetData(),
+                                        fontData.GetSize())) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Failed to load font: {}", fontUrl);
+  }
+}
+
 void TextObject::SetTextStr(std::string textStr) {
   this->textStr = std::move(textStr);
   if (text) text->setString(this->textStr);
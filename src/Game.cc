@@ -1,203 +1,257 @@
 // Standard and external includes
 #include <box2d/box2d.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
 #include <memory>
-#include <optional>
-
-#ifdef _WIN32
-#include <windows.h>
-#elif defined(__APPLE__)
-#include <mach-o/dyld.h>
-#endif
+#include <string>
 
 // Project includes
-#include "Components/AnimatorComponent.hh"
-#include "Components/AudioListenerComponent.hh"
+#include "AllocationTracker.hh"
+#include "AnimationLibrary.hh"
+#include "AssetFiles.hh"
+#include "AudioMixer.hh"
 #include "Components/Entity.hh"
 #include "Components/EntityManager.hh"
-#include "Components/RigidBodyComponent.hh"
 #include "Components/SpriteComponent.hh"
 #include "Components/TransformComponent.hh"
 #include "Constants.hh"
-#include "FlipSprite.hh"
+#include "CookedAssets.hh"
+#include "EngineAllocator.hh"
+#include "FrameArena.hh"
+#include "FramePacer.hh"
+#include "FrameProfiler.hh"
 #include "GUI/Button.hh"
 #include "GUI/TextObject.hh"
 #include "Game.hh"
-#include "Movement.hh"
+#include "GraphicsContext.hh"
+#include "HotReload.hh"
+#include "InputRecording.hh"
+#include "JobSystem.hh"
+#include "Log.hh"
+#include "Metrics.hh"
+#include "MusicPlayer.hh"
+#include "PhysicsUnits.hh"
+#include "ProjectPaths.hh"
+#include "SimulationInstance.hh"
+#include "Telemetry.hh"
+#include "TextureCache.hh"
 #include "TileGroup.hh"
+#ifdef SFML_AUDIO_AVAILABLE
+#include "SoundBufferCache.hh"
+#endif
 
 // All state is managed inside Game class members (see Game.hh)
 
-// Function to find the project root directory
-std::string findProjectRoot() {
-  std::filesystem::path exeDir;
-
-#ifdef _WIN32
-  wchar_t wpath[MAX_PATH];
-  DWORD len = GetModuleFileNameW(nullptr, wpath, MAX_PATH);
-  if (len > 0) {
-    exeDir = std::filesystem::path(wpath).parent_path();
-  } else {
-    exeDir = std::filesystem::current_path();
-  }
-#elif defined(__APPLE__)
-  char path[1024];
-  uint32_t size = sizeof(path);
-  if (_NSGetExecutablePath(path, &size) == 0) {
-    exeDir = std::filesystem::path(path).parent_path();
-  } else {
-    exeDir = std::filesystem::current_path();
-  }
-#else
-  exeDir = std::filesystem::current_path();
-#endif
-
-  // Walk up to 5 levels to find a folder containing "assets"
-  auto current = exeDir;
-  for (int i = 0; i <= 5; ++i) {
-    if (std::filesystem::exists(current / "assets")) {
-      return current.string();
+namespace {
+
+// Levels and running totals sampled once per metrics log line
+struct GameMetrics {
+  MetricGauge& entities{Metrics::RegisterGauge("world.entities")};
+  MetricGauge& bodies{Metrics::RegisterGauge("world.bodies")};
+  MetricGauge& contacts{Metrics::RegisterGauge("world.contacts")};
+  MetricGauge& animationClips{Metrics::RegisterGauge("assets.clips")};
+  MetricGauge& soundBuffers{Metrics::RegisterGauge("assets.sound_buffers")};
+  MetricGauge& soundBytes{Metrics::RegisterGauge("assets.sound_bytes")};
+  MetricCounter& soundDecodes{
+      Metrics::RegisterCounter("assets.sound_decodes")};
+  MetricCounter& soundHits{
+      Metrics::RegisterCounter("assets.sound_cache_hits")};
+  MetricGauge& voices{Metrics::RegisterGauge("audio.voices_active")};
+  MetricGauge& mixMicroseconds{Metrics::RegisterGauge("audio.mix_us")};
+  MetricCounter& voicesStolen{
+      Metrics::RegisterCounter("audio.voices_stolen")};
+  MetricCounter& playsDropped{
+      Metrics::RegisterCounter("audio.plays_dropped")};
+  std::array<MetricGauge*, static_cast<std::size_t>(MemoryTag::Count)>
+      memoryBytes{};
+
+  GameMetrics() {
+    for (std::size_t i{}; i < memoryBytes.size(); ++i) {
+      memoryBytes[i] = &Metrics::RegisterGauge(
+          std::string("memory.") +
+          EngineAllocator::GetTagName(static_cast<MemoryTag>(i)) + "_bytes");
     }
-    if (!current.has_parent_path()) break;
-    current = current.parent_path();
   }
+};
 
-  // Fallback to current working directory
-  return std::filesystem::current_path().string();
+GameMetrics& GetGameMetrics() {
+  static GameMetrics metrics;
+  return metrics;
 }
 
-Game::Game() {
-  std::string projectRoot = findProjectRoot();
-  std::filesystem::current_path(projectRoot);
+// Brings a counter fed only from here up to a total kept elsewhere
+void AddUpTo(MetricCounter& counter, std::int64_t total) {
+  counter.Add(total - counter.Get());
+}
 
-  window = std::make_unique<sf::RenderWindow>(
-      sf::VideoMode(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), GAME_NAME);
-  gravity = std::make_unique<b2Vec2>(0.f, 0.f);
-  world = std::make_unique<b2World>(*gravity);
-  drawPhysics = std::make_unique<DrawPhysics>(window.get());
-  entityManager = std::make_unique<EntityManager>();
-  // Resolve default map path with fallbacks: prefer layered JSON (assets
-  // constants, then latest in assets/maps)
-  auto exists = [](const std::string& p) {
-    return std::filesystem::exists(std::filesystem::path(p));
-  };
-  auto findLatestJsonIn =
-      [&](const std::filesystem::path& dir) -> std::optional<std::string> {
-    namespace fs = std::filesystem;
-    std::error_code ec;
-    if (!fs::exists(dir, ec) || !fs::is_directory(dir, ec)) return std::nullopt;
-    std::string best;
-    std::filesystem::file_time_type bestTime{};
-    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::end(it);
-         it.increment(ec)) {
-      if (ec) break;
-      const auto& entry = *it;
-      if (!entry.is_regular_file(ec)) continue;
-      auto path = entry.path();
-      if (path.extension() == ".json") {
-        auto t = entry.last_write_time(ec);
-        if (!ec && (best.empty() || t > bestTime)) {
-          best = path.string();
-          bestTime = t;
-        }
-      }
+}  // namespace
+
+Game::Game(const GameOptions& options) {
+  // Before anything that logs, and before the switch to the project root so
+  // a relative --log path resolves against the caller's working directory
+  LogSettings logSettings;
+  logSettings.path = options.logPath;
+  logSettings.level = options.logLevel;
+  Log::Start(logSettings);
+
+  // Open recordings before switching to the project root so relative paths
+  // resolve against the caller's working directory
+  if (!options.replayPath.empty()) {
+    inputReplayer = std::make_unique<InputReplayer>();
+    if (!inputReplayer->Open(options.replayPath)) {
+      inputReplayer.reset();
+      startFailed = true;
+    } else {
+      fixedTimeStep = inputReplayer->GetFixedStep();
+      checksumInterval = inputReplayer->GetChecksumInterval();
+    }
+  } else if (!options.recordPath.empty()) {
+    inputRecorder = std::make_unique<InputRecorder>();
+    if (!inputRecorder->Open(options.recordPath,
+                             GameConstants::FIXED_TIME_STEP,
+                             GameConstants::REPLAY_CHECKSUM_INTERVAL)) {
+      inputRecorder.reset();
+      startFailed = true;
+    } else {
+      fixedTimeStep = GameConstants::FIXED_TIME_STEP;
+      checksumInterval = GameConstants::REPLAY_CHECKSUM_INTERVAL;
     }
-    if (!best.empty())
-      return best;
-    else
-      return std::nullopt;
-  };
-
-  std::string mapPath;
-  // 1) Prefer explicit assets JSON constants (developer override)
-  if (exists(ASSETS_MAPS_JSON_THREE))
-    mapPath = ASSETS_MAPS_JSON_THREE;
-  else if (exists(ASSETS_MAPS_JSON_TWO))
-    mapPath = ASSETS_MAPS_JSON_TWO;
-  else if (exists(ASSETS_MAPS_JSON))
-    mapPath = ASSETS_MAPS_JSON;
-
-  // 2) If not set by constants, pick latest JSON from assets/maps
-  if (mapPath.empty()) {
-    auto assetsLatest =
-        findLatestJsonIn(std::filesystem::path("assets") / "maps");
-    if (assetsLatest) mapPath = *assetsLatest;
   }
-  // 3) If still empty, keep mapPath blank; engine requires JSON maps now
-
-  std::cout << "Game: loading map -> " << mapPath << std::endl;
-  tileGroup = std::make_unique<TileGroup>(
-      window.get(), GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT,
-      mapPath.c_str(), GameConstants::TILE_SCALE, GameConstants::TILE_SIZE,
+  if (!options.metricsPath.empty()) {
+    metricsLog = std::make_unique<MetricsLog>();
+    if (!metricsLog->Open(options.metricsPath)) {
+      metricsLog.reset();
+      startFailed = true;
+    } else {
+      GetGameMetrics();
+    }
+  }
+  // Running on live input, without recording or without metrics would let a
+  // CI job pass without producing what it asked for; Open has logged why
+  if (startFailed) return;
+  if (options.telemetry) {
+    telemetry = std::make_unique<TelemetryWriter>();
+    if (!telemetry->Open(TELEMETRY_SEGMENT)) telemetry.reset();
+  }
+  if (options.allocBudget) {
+    AllocationBudget budget;
+    budget.warmupFrames = GameConstants::ALLOC_BUDGET_WARMUP_FRAMES;
+    AllocationTracker::Enable(budget);
+  }
+  tickLimit = options.ticks;
+  if (options.headless) {
+    // Wall-clock deltas are meaningless without frames to pace them
+    if (fixedTimeStep <= 0.f) fixedTimeStep = GameConstants::FIXED_TIME_STEP;
+    if (tickLimit == 0 && !inputReplayer) {
+      tickLimit = GameConstants::HEADLESS_TICKS;
+    }
+    GraphicsContext::SetAvailable(false);
+  }
+  deltaTime = fixedTimeStep;
+
+  std::filesystem::current_path(ProjectPaths::FindProjectRoot());
+  AssetFiles::Mount(ASSETS_PACK);
+  CookedAssets::Load(ASSETS_COOKED_MANIFEST);
+
+  if (!options.headless) {
+    window = std::make_unique<sf::RenderWindow>(
+        sf::VideoMode(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), GAME_NAME);
+    window->setVerticalSyncEnabled(options.vsync);
+    if (!inputReplayer) {
+      FramePacerSettings pacing;
+      pacing.targetRate = options.frameRate > 0.f
+                              ? options.frameRate
+                              : GameConstants::FRAME_RATE_TARGET;
+      pacing.vsync = options.vsync;
+      pacing.backgroundRate = GameConstants::FRAME_RATE_BACKGROUND;
+      framePacer = std::make_unique<FramePacer>(pacing);
+    }
+  }
+  frameProfiler = std::make_unique<FrameProfiler>();
+  PhysicsUnits::SetPixelsPerMeter(GameConstants::PIXELS_PER_METER);
+  if (GameConstants::PHYSICS_PARTITIONED) {
+    jobSystem = std::make_unique<JobSystem>();
+  }
+  drawPhysics = std::make_unique<DrawPhysics>(window.get());
+  audioMixer = std::make_unique<AudioMixer>(GameConstants::AUDIO_VOICE_COUNT);
+  // Headless runs never open an audio device; plays just queue and drop
+  if (window) audioMixer->Start();
+  musicPlayer = std::make_unique<MusicPlayer>(*audioMixer);
+  const std::string mapPath{ProjectPaths::FindDefaultMap()};
+  BEP_LOG_INFO(LogCategory::Assets, "Game: loading map -> {}", mapPath);
+  tileGroup = std::make_shared<TileGroup>(
+      GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT, mapPath.c_str(),
+      GameConstants::TILE_SCALE, GameConstants::TILE_SIZE,
       GameConstants::TILE_SIZE, ASSETS_TILES);
+  if (window && AssetFiles::Exists(ASSETS_MUSIC)) {
+    musicPlayer->Play(ASSETS_MUSIC, GameConstants::MUSIC_CROSSFADE_SECONDS);
+  }
 
-  auto& hero{entityManager->AddEntity("hero")};
-  auto& candle1{entityManager->AddEntity("candle")};
-  auto& chest1{entityManager->AddEntity("chest")};
-  auto& chest2{entityManager->AddEntity("chest")};
-  auto& chest3{entityManager->AddEntity("chest")};
-
-  Entity& buttonDebugPhysics{entityManager->AddEntity("button")};
-
-  hero.AddComponent<TransformComponent>(500.f, 300.f, 16.f, 16.f, 4.f);
-  hero.AddComponent<SpriteComponent>(ASSETS_SPRITES, 0, 5);
-  hero.AddComponent<RigidBodyComponent>(world.get(), b2BodyType::b2_dynamicBody,
-                                        1, 0, 0, 0.f, true, (void*)&hero);
-  hero.AddComponent<AnimatorComponent>();
-  hero.AddComponent<AudioListenerComponent>();
-  hero.AddComponent<Movement>(GameConstants::PLAYER_SPEED,
-                              GameConstants::PLAYER_FRICTION,
-                              AudioClip("assets/audio/steps.ogg"));
-  hero.AddComponent<FlipSprite>();
-
-  candle1.AddComponent<TransformComponent>(500.f, 500.f, 16.f, 16.f, 3.f);
-  candle1.AddComponent<SpriteComponent>(ASSETS_SPRITES, 0, 5);
-  candle1.AddComponent<RigidBodyComponent>(world.get(),
-                                           b2BodyType::b2_staticBody, 1, 0, 0,
-                                           0.f, true, (void*)&candle1);
-  auto& candle1Animator = candle1.AddComponent<AnimatorComponent>();
-  candle1Animator.AddAnimation(
-      "idle", AnimationClip("assets/animations/candle/idle.json"));
-
-  chest1.AddComponent<TransformComponent>(300.f, 500.f, 16.f, 16.f, 4.f);
-  chest1.AddComponent<SpriteComponent>(ASSETS_SPRITES, 6, 1);
-  chest1.AddComponent<RigidBodyComponent>(world.get(),
-                                          b2BodyType::b2_staticBody, 1, 0, 0,
-                                          0.f, true, (void*)&chest1);
-
-  chest2.AddComponent<TransformComponent>(300.f, 400.f, 16.f, 16.f, 4.f);
-  chest2.AddComponent<SpriteComponent>(ASSETS_SPRITES, 6, 1);
-  chest2.AddComponent<RigidBodyComponent>(world.get(),
-                                          b2BodyType::b2_staticBody, 1, 0, 0,
-                                          0.f, true, (void*)&chest2);
-
-  chest3.AddComponent<TransformComponent>(300.f, 300.f, 16.f, 16.f, 4.f);
-  chest3.AddComponent<SpriteComponent>(ASSETS_SPRITES, 6, 1);
-  chest3.AddComponent<RigidBodyComponent>(world.get(),
-                                          b2BodyType::b2_staticBody, 1, 0, 0,
-                                          0.f, true, (void*)&chest3);
+  SimulationOptions simulationOptions;
+  simulationOptions.fixedStep = fixedTimeStep;
+  simulationOptions.audioMixer = audioMixer.get();
+  simulationOptions.physicsJobs = jobSystem.get();
+  simulation =
+      std::make_unique<SimulationInstance>(tileGroup, simulationOptions);
+  sceneComplete = simulation->IsSceneComplete();
+  if (options.hotReload) {
+    // Reloaded clips would change what a recording captured
+    if (!window || inputRecorder || inputReplayer) {
+      BEP_LOG_WARNING(LogCategory::Assets,
+                      "--hot-reload needs a window and no --record/--replay");
+    } else {
+      hotReload = std::make_unique<HotReload>(ASSETS_DIRECTORY, *tileGroup,
+                                              *simulation);
+    }
+  }
 
+  EntityManager& entityManager{simulation->GetEntityManager()};
+  Entity& buttonDebugPhysics{entityManager.AddEntity("button")};
   auto& btnPhysicsDebugTrs{buttonDebugPhysics.AddComponent<TransformComponent>(
       100.f, 100.f, 200.f, 100.f, 1.f)};
   auto& buttonPhysicsComp = buttonDebugPhysics.AddComponent<Button>(
-      btnPhysicsDebugTrs, 0.f, sf::Color::White, sf::Color::Transparent,
-      [this]() { debugPhysics = !debugPhysics; });
+      btnPhysicsDebugTrs, simulation->GetInput(), 0.f, sf::Color::White,
+      sf::Color::Transparent, [this]() { debugPhysics = !debugPhysics; });
   buttonPhysicsComp.SetTexture("assets/GUI/button.png");
 
-  contactEventManager = std::make_unique<ContactEventManager>();
   imguiManager = std::make_unique<ImGuiManager>();
+  imguiManager->SetSimulationLOD(&entityManager.GetSimulationLOD());
+  imguiManager->SetAudioMixer(audioMixer.get());
+  imguiManager->SetMusicPlayer(musicPlayer.get());
+  imguiManager->SetFramePacer(framePacer.get());
+  imguiManager->SetFrameProfiler(frameProfiler.get());
+  imguiManager->SetSimulation(simulation.get());
 }
 
 Game::~Game() = default;
 
 void Game::Initialize() {
+  if (startFailed) {
+    Log::Stop();
+    return;
+  }
   unsigned int flags = 0;
   flags += b2Draw::e_shapeBit;
-  world->SetDebugDraw(drawPhysics.get());
   drawPhysics->SetFlags(flags);
-  world->SetContactListener(contactEventManager.get());
+  simulation->SetDebugDraw(drawPhysics.get());
+
+  if (!window) {
+    // A timing or replay run over a partial scene would only mislead
+    if (!sceneComplete) {
+      BEP_LOG_ERROR(LogCategory::Assets,
+                    "Headless run aborted: the scene's prefabs did not load");
+      Destroy();
+      return;
+    }
+    HeadlessLoop();
+    return;
+  }
 
   imguiManager->Initialize(*window);
 
@@ -213,79 +267,311 @@ void Game::Initialize() {
   MainLoop();
 }
 
-void Game::UpdatePhysics() {
-  world->ClearForces();
-  world->Step(deltaTime, GameConstants::PHYSICS_VELOCITY_ITERATIONS,
-              GameConstants::PHYSICS_POSITION_ITERATIONS);
-}
+void Game::UpdatePhysics() { simulation->StepPhysics(deltaTime); }
 
 void Game::Update() {
-  if (gameClock) {
+  if (fixedTimeStep > 0.f) {
+    deltaTime = fixedTimeStep;
+  } else if (gameClock) {
     deltaTime = gameClock->getElapsedTime().asSeconds();
     gameClock->restart();
   }
-  if (entityManager) entityManager->Update(deltaTime);
-  imguiManager->Update(*window, sf::seconds(deltaTime));
+  frameProfiler->Time(FramePhase::Entities,
+                      [this] { simulation->UpdateEntities(deltaTime); });
+  frameProfiler->Time(FramePhase::Animation,
+                      [this] { simulation->UpdateAnimation(deltaTime); });
+  frameProfiler->Time(FramePhase::Ui, [this] {
+    imguiManager->Update(*window, sf::seconds(deltaTime));
+  });
 }
 
 void Game::MainLoop() {
-  while (window->isOpen()) {
-    while (true) {
-      auto evt = window->pollEvent();
-      if (!evt.has_value()) break;
-      imguiManager->ProcessEvent(evt.value());
-      if (evt->is<sf::Event::Closed>()) {
-        window->close();
+  InputSystem& input{simulation->GetInput()};
+  const sf::Clock runClock;
+  while (window->isOpen() && (tickLimit == 0 || tick < tickLimit)) {
+    // Between frames, so nothing is drawn half old, half new
+    if (hotReload) hotReload->Update();
+    bool replayOver{};
+    frameProfiler->Time(FramePhase::Input, [&] {
+      input.BeginFrame();
+      while (true) {
+        auto evt = window->pollEvent();
+        if (!evt.has_value()) break;
+        imguiManager->ProcessEvent(evt.value());
+        // A replay ignores live devices
+        if (!inputReplayer) input.ProcessEvent(evt.value());
+        if (evt->is<sf::Event::Closed>()) {
+          window->close();
+        }
+        if (framePacer) UpdateBackground(evt.value());
       }
+      if (inputReplayer && !ReplayInput()) {
+        replayOver = true;
+        return;
+      }
+      input.EndFrame();
+      if (inputRecorder) inputRecorder->WriteFrame(tick, input.GetSnapshot());
+    });
+    if (replayOver) {
+      std::cout << "Replay finished: " << tick << " ticks in "
+                << runClock.getElapsedTime().asMilliseconds() << " ms, "
+                << checksumMismatches << " checksum mismatches" << std::endl;
+      window->close();
+      break;
     }
 
-    UpdatePhysics();
+    frameProfiler->Time(FramePhase::Physics, [this] { UpdatePhysics(); });
     Update();
     Render();
+    frameProfiler->Time(FramePhase::Checksum, [this] { CheckWorldState(); });
+    if (metricsLog) WriteMetrics();
+    ++tick;
+    if (framePacer) framePacer->EndFrame();
+    frameProfiler->EndFrame();
+    if (AllocationTracker::IsEnabled()) AllocationTracker::EndFrame();
+    FrameArena::EndFrame();
+    if (telemetry) PublishTelemetry();
+  }
+  Destroy();
+}
+
+void Game::HeadlessLoop() {
+  InputSystem& input{simulation->GetInput()};
+  std::size_t drawCommands{};
+  bool replayOver{};
+
+  const auto runStart{std::chrono::steady_clock::now()};
+  while (tickLimit == 0 || tick < tickLimit) {
+    frameProfiler->Time(FramePhase::Input, [&] {
+      input.BeginFrame();
+      if (inputReplayer && !ReplayInput()) {
+        replayOver = true;
+        return;
+      }
+      input.EndFrame();
+      if (inputRecorder) inputRecorder->WriteFrame(tick, input.GetSnapshot());
+    });
+    if (replayOver) break;
+    frameProfiler->Time(FramePhase::Physics, [this] { UpdatePhysics(); });
+    frameProfiler->Time(FramePhase::Entities,
+                        [this] { simulation->UpdateEntities(deltaTime); });
+    frameProfiler->Time(FramePhase::Animation,
+                        [this] { simulation->UpdateAnimation(deltaTime); });
+    // Nothing is submitted; the phase records what a frame would draw
+    frameProfiler->Time(FramePhase::Render,
+                        [&] { drawCommands += CountDrawCommands(); });
+    frameProfiler->Time(FramePhase::Checksum, [this] { CheckWorldState(); });
+    if (metricsLog) WriteMetrics();
+    frameProfiler->EndFrame();
+    if (AllocationTracker::IsEnabled()) AllocationTracker::EndFrame();
+    FrameArena::EndFrame();
+    if (telemetry) PublishTelemetry();
+    ++tick;
+  }
+  const double runMs{std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - runStart)
+                         .count()};
+
+  const double ticks{std::max(1.0, static_cast<double>(tick))};
+  const std::ios_base::fmtflags coutFlags{std::cout.flags()};
+  const std::streamsize coutPrecision{std::cout.precision()};
+  std::cout << "Headless run: " << tick << " ticks (" << std::fixed
+            << std::setprecision(2) << tick * fixedTimeStep
+            << " s simulated) in " << runMs << " ms, "
+            << runMs * 1000.0 / ticks << " us/tick" << std::endl;
+  std::cout << std::left << std::setw(12) << "phase" << std::right
+            << std::setw(12) << "total ms" << std::setw(12) << "avg us"
+            << std::setw(12) << "max us" << std::endl;
+  for (int i{}; i < static_cast<int>(FramePhase::Count); ++i) {
+    const auto phase{static_cast<FramePhase>(i)};
+    const FramePhaseStats& stats{frameProfiler->GetPhase(phase)};
+    if (stats.frames == 0) continue;
+    std::cout << std::left << std::setw(12)
+              << FrameProfiler::GetPhaseName(phase) << std::right
+              << std::setw(12) << stats.totalMs << std::setw(12)
+              << stats.totalMs * 1000.0 / ticks << std::setw(12)
+              << stats.maxMs * 1000.0 << std::endl;
   }
+  std::cout << "Draw commands: " << drawCommands << " total, "
+            << static_cast<double>(drawCommands) / ticks << " per tick"
+            << std::endl;
+  if (inputReplayer) {
+    std::cout << "Replay: " << checksumMismatches << " checksum mismatches"
+              << std::endl;
+  }
+  std::cout.flags(coutFlags);
+  std::cout.precision(coutPrecision);
   Destroy();
 }
 
+std::size_t Game::CountDrawCommands() {
+  std::size_t count{tileGroup ? tileGroup->GetTileCount() : 0};
+  for (Entity* entity : simulation->GetEntityManager().GetEntities()) {
+    if (!entity->IsActive()) continue;
+    if (entity->GetComponent<SpriteComponent>()) ++count;
+    if (entity->GetComponent<Button>()) ++count;
+  }
+  return count;
+}
+
+void Game::UpdateBackground(const sf::Event& event) {
+  if (event.is<sf::Event::FocusLost>()) {
+    framePacer->SetBackground(true);
+  } else if (event.is<sf::Event::FocusGained>()) {
+    framePacer->SetBackground(false);
+  } else if (const auto* resized = event.getIf<sf::Event::Resized>()) {
+    // Minimizing reports a zero-sized window on some platforms
+    framePacer->SetBackground(resized->size.x == 0 || resized->size.y == 0);
+  }
+}
+
+bool Game::ReplayInput() {
+  InputSnapshot recorded;
+  if (!inputReplayer->ReadFrame(tick, recorded)) return false;
+  simulation->GetInput().OverrideDeviceState(recorded);
+  return true;
+}
+
+void Game::CheckWorldState() {
+  if (checksumInterval == 0 || (tick + 1) % checksumInterval != 0) return;
+  if (!inputRecorder && !inputReplayer) return;
+  const std::uint64_t checksum{simulation->ComputeChecksum()};
+  if (inputRecorder) inputRecorder->WriteChecksum(tick, checksum);
+  if (inputReplayer) {
+    const auto expected{inputReplayer->GetExpectedChecksum()};
+    if (expected && *expected != checksum) {
+      if (checksumMismatches == 0) {
+        std::cerr << "Replay diverged at tick " << tick << ": world checksum "
+                  << std::hex << checksum << ", recorded " << *expected
+                  << std::dec << std::endl;
+      }
+      ++checksumMismatches;
+    }
+  }
+}
+
+void Game::WriteMetrics() {
+  if ((tick + 1) % GameConstants::METRICS_LOG_INTERVAL != 0) return;
+  GameMetrics& metrics{GetGameMetrics()};
+  const SimulationStats world{simulation->GetStats()};
+  metrics.entities.Set(static_cast<double>(world.entities));
+  metrics.bodies.Set(static_cast<double>(world.bodies));
+  metrics.contacts.Set(static_cast<double>(world.contacts));
+  metrics.animationClips.Set(AnimationLibrary::GetClipCount());
+#ifdef SFML_AUDIO_AVAILABLE
+  const SoundBufferStats sounds{SoundBufferCache::GetStats()};
+  metrics.soundBuffers.Set(sounds.buffers);
+  metrics.soundBytes.Set(static_cast<double>(sounds.bytes));
+  AddUpTo(metrics.soundDecodes, sounds.decodes);
+  AddUpTo(metrics.soundHits, sounds.cacheHits);
+#endif
+  const AudioMixerStats mixer{audioMixer->GetStats()};
+  metrics.voices.Set(mixer.activeVoices);
+  metrics.mixMicroseconds.Set(mixer.mixMicroseconds);
+  AddUpTo(metrics.voicesStolen, mixer.stolen);
+  AddUpTo(metrics.playsDropped, mixer.dropped);
+  for (std::size_t i{}; i < metrics.memoryBytes.size(); ++i) {
+    metrics.memoryBytes[i]->Set(static_cast<double>(
+        EngineAllocator::GetSnapshot(static_cast<MemoryTag>(i)).currentBytes));
+  }
+  metricsLog->Write(tick + 1);
+}
+
+void Game::PublishTelemetry() {
+  TelemetryFrame frame;
+  frame.frame = frameProfiler->GetFrameCount();
+  frame.frameMs = frameProfiler->GetLastFrameMs();
+  for (std::size_t i{}; i < TelemetryFrame::PHASES; ++i) {
+    frame.phaseMs[i] =
+        frameProfiler->GetPhase(static_cast<FramePhase>(i)).lastMs;
+  }
+  const SimulationStats world{simulation->GetStats()};
+  frame.entities = static_cast<std::uint32_t>(world.entities);
+  frame.bodies = static_cast<std::uint32_t>(world.bodies);
+  frame.contacts = static_cast<std::uint32_t>(world.contacts);
+  for (int i{}; i < static_cast<int>(MemoryTag::Count); ++i) {
+    const MemorySnapshot mem{
+        EngineAllocator::GetSnapshot(static_cast<MemoryTag>(i))};
+    frame.allocatedBytes += mem.currentBytes;
+    frame.allocations += mem.allocations;
+  }
+  telemetry->Publish(frame);
+}
+
 void Game::Render() {
+  frameProfiler->Time(FramePhase::Render, [this] { RenderWorld(); });
+  // Render ImGui on top
+  frameProfiler->Time(FramePhase::Ui,
+                      [this] { imguiManager->Render(*window); });
+  window->display();
+}
+
+void Game::RenderWorld() {
   window->clear(sf::Color::Black);
 
   if (tileGroup) {
-    tileGroup->Draw();
-  }
-  if (entityManager) entityManager->Render(*window);
-  if (debugPhysics) {
-    world->DebugDraw();
+    tileGroup->Draw(*window);
   }
+  simulation->GetEntityManager().Render(*window);
+  if (debugPhysics) simulation->DebugDraw();
 
   // Draw UI text above world/debug
   if (textObj1) {
     window->draw(*textObj1->GetText());
   }
+}
 
-  // Render ImGui on top
-  imguiManager->Render(*window);
+void Game::ReportAllocations() const {
+  if (!AllocationTracker::IsEnabled()) return;
+  const std::int64_t checked{AllocationTracker::GetCheckedFrames()};
+  const std::int64_t violations{AllocationTracker::GetViolations()};
+  if (checked == 0) {
+    std::cout << "Allocation budget: run too short, no frames past the "
+              << GameConstants::ALLOC_BUDGET_WARMUP_FRAMES << "-frame warm-up"
+              << std::endl;
+  } else if (violations == 0) {
+    std::cout << "Allocation budget: " << checked
+              << " steady-state frames, none allocated" << std::endl;
+  } else {
+    std::cerr << "Allocation budget FAILED: " << violations << " of "
+              << checked << " steady-state frames allocated" << std::endl;
+  }
+}
 
-  window->display();
+int Game::GetExitCode() const {
+  if (startFailed || checksumMismatches > 0) return EXIT_FAILURE;
+  if (!window && !sceneComplete) return EXIT_FAILURE;
+  return AllocationTracker::GetViolations() > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 void Game::Destroy() {
-  // Shutdown ImGui
+  ReportAllocations();
+  // Shutdown ImGui (a no-op if it was never initialized)
   imguiManager->Shutdown();
   // Smart pointers automatically clean up
-  // Detach Box2D hooks before destroying their owners
-  if (world) {
-    world->SetDebugDraw(nullptr);
-    world->SetContactListener(nullptr);
-  }
-  // Explicitly reset components in safe order: entities (with Box2D bodies)
-  // before Box2D world
-  entityManager.reset();
+  // Explicitly reset in safe order: the simulation (entities, Box2D bodies
+  // and world) before the mixer and job pool it references
+  hotReload.reset();
+  simulation.reset();
+  musicPlayer.reset();
+  audioMixer.reset();
   tileGroup.reset();
   drawPhysics.reset();
-  contactEventManager.reset();
+  framePacer.reset();
+  frameProfiler.reset();
+  metricsLog.reset();
+  telemetry.reset();
+  inputRecorder.reset();
+  inputReplayer.reset();
   imguiManager.reset();
-  world.reset();
-  gravity.reset();
+  jobSystem.reset();
   textObj1.reset();
   gameClock.reset();
-}
\ No newline at end of file
+  // Nothing draws anymore; free the textures while the GL context is alive
+  TextureCache::Trim();
+  CookedAssets::Clear();
+  // After the fonts and music decks that stream out of the mapping
+  AssetFiles::Unmount();
+  // Last: flushes whatever the shutdown above logged
+  Log::Stop();
+}
@@ -0,0 +1,180 @@
+#include "HotReload.hh"
+
+#include <chrono>
+#include <filesystem>
+
+#include "AssetFiles.hh"
+#include "Constants.hh"
+#include "CookedAssets.hh"
+#include "Log.hh"
+#include "SimulationInstance.hh"
+#include "TextureCache.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+std::string Normalize(std::string_view path) {
+  return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+}  // namespace
+
+HotReload::HotReload(const std::string& directory, TileGroup& map,
+                     SimulationInstance& simulation)
+    : map(map), simulation(simulation) {
+  if (!watcher.Start(directory)) return;
+  loader = std::thread(&HotReload::LoaderLoop, this);
+}
+
+HotReload::~HotReload() {
+  watcher.Stop();
+  {
+    std::lock_guard lock{mutex};
+    quit = true;
+  }
+  requestReady.notify_one();
+  if (loader.joinable()) loader.join();
+}
+
+bool HotReload::IsWatching() const { return watcher.IsRunning(); }
+
+const HotReloadStats& HotReload::GetStats() const { return stats; }
+
+void HotReload::Update() {
+  if (!inFlight) {
+    Batch batch;
+    if (!Collect(batch)) return;
+    {
+      std::lock_guard lock{mutex};
+      request = std::move(batch);
+    }
+    requestReady.notify_one();
+    inFlight = true;
+    return;
+  }
+
+  std::optional<Batch> loaded;
+  {
+    std::lock_guard lock{mutex};
+    if (!result) return;
+    loaded = std::move(result);
+    result.reset();
+  }
+  inFlight = false;
+  Apply(*loaded);
+}
+
+bool HotReload::Collect(Batch& batch) {
+  changed.clear();
+  watcher.Poll(changed);
+  if (changed.empty()) return false;
+
+  const std::string mapPath{Normalize(map.GetPath())};
+  const std::string cookedPrefix{
+      Normalize(std::string(ASSETS_DIRECTORY) + '/' + COOKED_DIRECTORY) + '/'};
+  for (const std::string& path : changed) {
+    // The cooker's own output; the sources it came from are what get edited
+    if (path.starts_with(cookedPrefix)) continue;
+    if (path == mapPath) {
+      batch.map = true;
+    } else if (path.ends_with(".png") && TextureCache::Contains(path)) {
+      batch.texturePaths.push_back(path);
+    } else if (path.ends_with(".json") && AnimationLibrary::IsLoaded(path)) {
+      batch.clipPaths.push_back(path);
+    } else {
+      BEP_LOG_DEBUG(LogCategory::Assets, "Hot reload: ignoring {}", path);
+      continue;
+    }
+    // The loader is idle, so nothing reads these while they change
+    AssetFiles::PreferLoose(path);
+    CookedAssets::Forget(path);
+  }
+  return batch.map || !batch.texturePaths.empty() || !batch.clipPaths.empty();
+}
+
+void HotReload::LoaderLoop() {
+  while (true) {
+    Batch batch;
+    {
+      std::unique_lock lock{mutex};
+      requestReady.wait(lock, [this] { return quit || request.has_value(); });
+      if (quit) return;
+      batch = std::move(*request);
+      request.reset();
+    }
+    Load(batch);
+    std::lock_guard lock{mutex};
+    result = std::move(batch);
+  }
+}
+
+void HotReload::Load(Batch& batch) const {
+  const Clock::time_point start{Clock::now()};
+  for (const std::string& path : batch.texturePaths) {
+    LoadedTexture& texture{batch.textures.emplace_back()};
+    texture.path = path;
+    if (!CookedAssets::LoadImage(texture.image, path)) {
+      BEP_LOG_ERROR(LogCategory::Assets, "Hot reload: can't decode {}", path);
+      batch.textures.pop_back();
+      ++batch.failures;
+    }
+  }
+  if (batch.map) {
+    MapData data;
+    if (TileGroup::ReadMap(map.GetPath(), data)) {
+      batch.mapData = std::move(data);
+    } else {
+      ++batch.failures;
+    }
+  }
+  for (const std::string& path : batch.clipPaths) {
+    AnimationClipSource source;
+    bool read{};
+    try {
+      read = AnimationLibrary::ReadSource(path, source);
+    } catch (const std::exception& e) {
+      BEP_LOG_ERROR(LogCategory::Assets, "Hot reload: bad clip {}: {}", path,
+                    e.what());
+    }
+    if (read) {
+      batch.clips.push_back(LoadedClip{path, source});
+    } else {
+      ++batch.failures;
+    }
+  }
+  batch.loadMs = MillisecondsSince(start);
+}
+
+void HotReload::Apply(Batch& batch) {
+  const Clock::time_point start{Clock::now()};
+  int textures{};
+  for (const LoadedTexture& texture : batch.textures) {
+    if (TextureCache::Replace(texture.path, texture.image)) ++textures;
+  }
+  std::size_t tiles{};
+  if (batch.mapData) tiles = map.Reload(*batch.mapData);
+  int clips{};
+  for (const LoadedClip& clip : batch.clips) {
+    clips += AnimationLibrary::Reload(clip.path, clip.source);
+  }
+  if (clips > 0) simulation.RefreshAnimationClips();
+
+  ++stats.batches;
+  stats.textures += textures;
+  stats.tiles += static_cast<std::int64_t>(tiles);
+  stats.clips += clips;
+  stats.failures += batch.failures;
+  stats.lastLoadMs = batch.loadMs;
+  stats.lastApplyMs = MillisecondsSince(start);
+  BEP_LOG_INFO(LogCategory::Assets,
+               "Hot reload: {} textures, {} map tiles, {} clips, {} failed "
+               "({} ms loading, {} ms in frame)",
+               textures, tiles, clips, batch.failures, stats.lastLoadMs,
+               stats.lastApplyMs);
+}
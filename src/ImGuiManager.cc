@@ -1,6 +1,85 @@
 #include "ImGuiManager.hh"
 
-#include <iostream>
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+#include "AllocationTracker.hh"
+#include "EngineAllocator.hh"
+#include "FramePacer.hh"
+#include "FrameProfiler.hh"
+#include "Log.hh"
+#include "SimulationInstance.hh"
+#include "SimulationLOD.hh"
+#ifdef SFML_AUDIO_AVAILABLE
+#include "AudioMixer.hh"
+#include "MusicPlayer.hh"
+#include "SoundBufferCache.hh"
+#endif
+
+namespace {
+
+// Keys ImGui needs for navigation and text editing; others are ignored
+ImGuiKey ToImGuiKey(sf::Keyboard::Key key) {
+  switch (key) {
+    case sf::Keyboard::Key::Tab:
+      return ImGuiKey_Tab;
+    case sf::Keyboard::Key::Left:
+      return ImGuiKey_LeftArrow;
+    case sf::Keyboard::Key::Right:
+      return ImGuiKey_RightArrow;
+    case sf::Keyboard::Key::Up:
+      return ImGuiKey_UpArrow;
+    case sf::Keyboard::Key::Down:
+      return ImGuiKey_DownArrow;
+    case sf::Keyboard::Key::PageUp:
+      return ImGuiKey_PageUp;
+    case sf::Keyboard::Key::PageDown:
+      return ImGuiKey_PageDown;
+    case sf::Keyboard::Key::Home:
+      return ImGuiKey_Home;
+    case sf::Keyboard::Key::End:
+      return ImGuiKey_End;
+    case sf::Keyboard::Key::Insert:
+      return ImGuiKey_Insert;
+    case sf::Keyboard::Key::Delete:
+      return ImGuiKey_Delete;
+    case sf::Keyboard::Key::Backspace:
+      return ImGuiKey_Backspace;
+    case sf::Keyboard::Key::Space:
+      return ImGuiKey_Space;
+    case sf::Keyboard::Key::Enter:
+      return ImGuiKey_Enter;
+    case sf::Keyboard::Key::Escape:
+      return ImGuiKey_Escape;
+    case sf::Keyboard::Key::A:
+      return ImGuiKey_A;
+    case sf::Keyboard::Key::C:
+      return ImGuiKey_C;
+    case sf::Keyboard::Key::V:
+      return ImGuiKey_V;
+    case sf::Keyboard::Key::X:
+      return ImGuiKey_X;
+    case sf::Keyboard::Key::Y:
+      return ImGuiKey_Y;
+    case sf::Keyboard::Key::Z:
+      return ImGuiKey_Z;
+    default:
+      return ImGuiKey_None;
+  }
+}
+
+template <typename KeyEvent>
+void ForwardKey(ImGuiIO& io, const KeyEvent& e, bool down) {
+  io.AddKeyEvent(ImGuiMod_Ctrl, e.control);
+  io.AddKeyEvent(ImGuiMod_Shift, e.shift);
+  io.AddKeyEvent(ImGuiMod_Alt, e.alt);
+  io.AddKeyEvent(ImGuiMod_Super, e.system);
+  const ImGuiKey key{ToImGuiKey(e.code)};
+  if (key != ImGuiKey_None) io.AddKeyEvent(key, down);
+}
+
+}  // namespace
 
 ImGuiManager::ImGuiManager() {
   // Constructor
@@ -22,8 +101,14 @@ void ImGuiManager::Initialize(sf::RenderWindow& window) {
   // Set up style
   ImGui::StyleColorsDark();
 
+  if (!m_renderer.CreateFontTexture()) {
+    ImGui::DestroyContext();
+    BEP_LOG_ERROR(LogCategory::General, "ImGui disabled: no font texture");
+    return;
+  }
+
   m_initialized = true;
-  std::cout << "ImGui initialized successfully" << std::endl;
+  BEP_LOG_INFO(LogCategory::General, "ImGui initialized successfully");
 }
 
 void ImGuiManager::ProcessEvent(const sf::Event& event) {
@@ -62,18 +147,32 @@ void ImGuiManager::ProcessEvent(const sf::Event& event) {
   }
   if (event.is<sf::Event::KeyPressed>()) {
     if (const auto* e = event.getIf<sf::Event::KeyPressed>()) {
+      ForwardKey(io, *e, true);
+      if (e->code == sf::Keyboard::Key::F1) {
+        m_showDebugInfo = !m_showDebugInfo;
+      }
+      if (e->code == sf::Keyboard::Key::F2) {
+        m_showDemoWindow = !m_showDemoWindow;
+      }
+      if (e->code == sf::Keyboard::Key::F4) {
+        m_showPerformanceOverlay = !m_showPerformanceOverlay;
+      }
       if (e->code == sf::Keyboard::Key::F3) {
         m_showTestWindow = !m_showTestWindow;
-        std::cout << "ImGui Test Window: " << (m_showTestWindow ? "ON" : "OFF")
-                  << std::endl;
+        BEP_LOG_INFO(LogCategory::General, "ImGui Test Window: {}",
+                     m_showTestWindow ? "ON" : "OFF");
       }
       if (e->code == sf::Keyboard::Key::Escape) {
         m_showTestWindow = false;
-        std::cout << "ImGui Test Window: OFF" << std::endl;
+        BEP_LOG_INFO(LogCategory::General, "ImGui Test Window: OFF");
       }
     }
     return;
   }
+  if (const auto* e = event.getIf<sf::Event::KeyReleased>()) {
+    ForwardKey(io, *e, false);
+    return;
+  }
   if (event.is<sf::Event::TextEntered>()) {
     if (const auto* e = event.getIf<sf::Event::TextEntered>()) {
       if (e->unicode > 0 && e->unicode < 0x10000)
@@ -86,12 +185,9 @@ void ImGuiManager::ProcessEvent(const sf::Event& event) {
 void ImGuiManager::Update(sf::RenderWindow& window, sf::Time deltaTime) {
   if (!m_initialized) return;
 
-  // For now, we'll skip ImGui frame updates to avoid rendering issues
-  // In a full implementation, you would need to set up proper ImGui rendering
-
-  /*
   ImGuiIO& io = ImGui::GetIO();
-  io.DeltaTime = deltaTime.asSeconds();
+  // ImGui asserts on a zero delta, which the first frame can report
+  io.DeltaTime = std::max(deltaTime.asSeconds(), 1e-4f);
 
   // Update display size
   sf::Vector2u size = window.getSize();
@@ -99,51 +195,78 @@ void ImGuiManager::Update(sf::RenderWindow& window, sf::Time deltaTime) {
   io.DisplaySize.y = static_cast<float>(size.y);
 
   ImGui::NewFrame();
+  m_frameStarted = true;
 
   // Show main menu bar
   ShowMainMenuBar();
 
   // Show windows based on state
   if (m_showDemoWindow) {
-      ShowDemoWindow();
+    ShowDemoWindow();
   }
 
   if (m_showDebugInfo) {
-      ShowDebugInfo();
+    ShowDebugInfo();
   }
 
   if (m_showEntityInfo) {
-      ShowEntityInfo();
+    ShowEntityInfo();
   }
 
   if (m_showTestWindow) {
-      ShowTestWindow();
+    ShowTestWindow();
+  }
+
+  if (m_showPerformanceOverlay) {
+    if (m_frameProfiler) {
+      m_frameProfiler->Time(FramePhase::Overlay,
+                            [this] { ShowPerformanceOverlay(); });
+    } else {
+      ShowPerformanceOverlay();
+    }
   }
-  */
 }
 
 void ImGuiManager::Render(sf::RenderWindow& window) {
-  if (!m_initialized) return;
-
-  // For now, we'll skip ImGui rendering to avoid crashes
-  // In a full implementation, you would need to set up OpenGL rendering
-  // or use a proper ImGui backend like ImGui-SFML
-
-  // ImGui::Render();
+  if (!m_initialized || !m_frameStarted) return;
 
-  // Render a simple test indicator when test window is enabled
-  if (m_showTestWindow) {
-    RenderTestIndicator(window);
-  }
+  ImGui::Render();
+  m_frameStarted = false;
+  m_renderer.RenderDrawData(window, *ImGui::GetDrawData());
 }
 
 void ImGuiManager::Shutdown() {
   if (m_initialized) {
     ImGui::DestroyContext();
     m_initialized = false;
+    m_frameStarted = false;
   }
 }
 
+void ImGuiManager::SetSimulationLOD(const SimulationLOD* simulationLOD) {
+  m_simulationLOD = simulationLOD;
+}
+
+void ImGuiManager::SetAudioMixer(const AudioMixer* audioMixer) {
+  m_audioMixer = audioMixer;
+}
+
+void ImGuiManager::SetMusicPlayer(const MusicPlayer* musicPlayer) {
+  m_musicPlayer = musicPlayer;
+}
+
+void ImGuiManager::SetFramePacer(const FramePacer* framePacer) {
+  m_framePacer = framePacer;
+}
+
+void ImGuiManager::SetFrameProfiler(FrameProfiler* frameProfiler) {
+  m_frameProfiler = frameProfiler;
+}
+
+void ImGuiManager::SetSimulation(const SimulationInstance* simulation) {
+  m_simulation = simulation;
+}
+
 void ImGuiManager::ShowMainMenuBar() {
   if (ImGui::BeginMainMenuBar()) {
     if (ImGui::BeginMenu("Debug")) {
@@ -151,6 +274,7 @@ void ImGuiManager::ShowMainMenuBar() {
       ImGui::MenuItem("Debug Info", nullptr, &m_showDebugInfo);
       ImGui::MenuItem("Entity Info", nullptr, &m_showEntityInfo);
       ImGui::MenuItem("Test Window", nullptr, &m_showTestWindow);
+      ImGui::MenuItem("Performance Overlay", "F4", &m_showPerformanceOverlay);
       ImGui::EndMenu();
     }
 
@@ -177,6 +301,62 @@ void ImGuiManager::ShowDebugInfo() {
 
   ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
   ImGui::Text("Frame Time: %.3f ms", 1000.0f / ImGui::GetIO().Framerate);
+  if (m_framePacer) {
+    const FramePacerStats& pacing{m_framePacer->GetStats()};
+    const FramePacerSettings& settings{m_framePacer->GetSettings()};
+    if (settings.vsync) {
+      ImGui::BulletText("Pacing: vsync%s", pacing.background ? " (bg)" : "");
+    } else {
+      ImGui::BulletText("Pacing: %.0f Hz%s", settings.targetRate,
+                        pacing.background ? " (bg)" : "");
+    }
+    ImGui::BulletText("Mean %.2f ms, %lld/%lld missed, spin %.2f ms",
+                      pacing.meanFrameMs,
+                      static_cast<long long>(pacing.missedDeadlines),
+                      static_cast<long long>(pacing.frames),
+                      pacing.spinMarginMs);
+    float buckets[FramePacerStats::JITTER_BUCKETS]{};
+    for (std::size_t i{}; i < FramePacerStats::JITTER_BUCKETS; ++i) {
+      buckets[i] = static_cast<float>(pacing.jitterHistogram[i]);
+    }
+    ImGui::PlotHistogram("Jitter", buckets,
+                         static_cast<int>(FramePacerStats::JITTER_BUCKETS), 0,
+                         "<0.1 .. >8 ms", 0.f, FLT_MAX, ImVec2(0, 60));
+  }
+
+  ImGui::Separator();
+  ImGui::Text("Memory:");
+  for (int i{}; i < static_cast<int>(MemoryTag::Count); ++i) {
+    const auto tag{static_cast<MemoryTag>(i)};
+    const MemorySnapshot mem{EngineAllocator::GetSnapshot(tag)};
+    ImGui::BulletText("%s: %.1f KB (peak %.1f KB, %lld allocs)",
+                      EngineAllocator::GetTagName(tag),
+                      mem.currentBytes / 1024.0, mem.peakBytes / 1024.0,
+                      static_cast<long long>(mem.allocations));
+  }
+#ifdef SFML_AUDIO_AVAILABLE
+  const SoundBufferStats audio{SoundBufferCache::GetStats()};
+  ImGui::BulletText("Sound buffers: %d, %.1f KB (%lld decodes, %lld hits)",
+                    audio.buffers, audio.bytes / 1024.0,
+                    static_cast<long long>(audio.decodes),
+                    static_cast<long long>(audio.cacheHits));
+  if (m_audioMixer) {
+    const AudioMixerStats mixer{m_audioMixer->GetStats()};
+    ImGui::BulletText("Mixer: %d/%d voices, %.1f us/chunk (%lld stolen, %lld "
+                      "dropped)",
+                      mixer.activeVoices, mixer.voiceCount,
+                      mixer.mixMicroseconds,
+                      static_cast<long long>(mixer.stolen),
+                      static_cast<long long>(mixer.dropped));
+  }
+  if (m_musicPlayer) {
+    const MusicStats music{m_musicPlayer->GetStats()};
+    ImGui::BulletText("Music: %s, %.2f s buffered, %.1f KB (%lld underruns)",
+                      music.track.empty() ? "-" : music.track.c_str(),
+                      music.bufferedSeconds, music.residentBytes / 1024.0,
+                      static_cast<long long>(music.underruns));
+  }
+#endif
 
   ImGui::Separator();
   ImGui::Text("Controls:");
@@ -184,54 +364,34 @@ void ImGuiManager::ShowDebugInfo() {
   ImGui::BulletText("Space - Jump");
   ImGui::BulletText("F1 - Toggle debug info");
   ImGui::BulletText("F2 - Toggle demo window");
+  ImGui::BulletText("F4 - Toggle performance overlay");
 
   ImGui::End();
 }
 
-void ImGuiManager::RenderTestIndicator(sf::RenderWindow& window) {
-  // Create a simple test indicator using SFML
-  sf::RectangleShape testRect(sf::Vector2f(400, 300));
-  testRect.setPosition(sf::Vector2f(50, 50));
-  testRect.setFillColor(sf::Color(0, 100, 200, 200));  // Semi-transparent blue
-  testRect.setOutlineColor(sf::Color::Yellow);
-  testRect.setOutlineThickness(3);
-
-  window.draw(testRect);
-
-  // Add some text to show it's working
-  static sf::Font font;
-  static bool fontLoaded = false;
-
-  if (!fontLoaded) {
-    if (font.openFromFile("assets/fonts/ARCADECLASSIC.TTF")) {
-      fontLoaded = true;
-    }
-  }
-
-  if (fontLoaded) {
-    sf::Text text(font);
-    text.setString(
-        "ImGui Test Window Active!\n\nPress F3 to toggle\nPress ESC to "
-        "close\n\nThis is a test UI indicator\nshowing ImGui integration is "
-        "working!");
-    text.setCharacterSize(18);
-    text.setFillColor(sf::Color::White);
-    text.setPosition(sf::Vector2f(70, 70));
-
-    window.draw(text);
-  }
-}
-
 void ImGuiManager::ShowEntityInfo() {
   ImGui::Begin("Entity Information", &m_showEntityInfo);
 
   ImGui::Text("Entity System Information");
   ImGui::Separator();
 
-  // This could be expanded to show actual entity data
-  ImGui::Text("Entities: %d", 0);           // Placeholder
+  if (m_simulation) {
+    const SimulationStats world{m_simulation->GetStats()};
+    ImGui::Text("Entities: %zu", world.entities);
+    ImGui::Text("Bodies: %zu", world.bodies);
+  }
   ImGui::Text("Active Components: %d", 0);  // Placeholder
 
+  if (m_simulationLOD) {
+    ImGui::Separator();
+    ImGui::Text("Simulation Tiers:");
+    for (int i{}; i < static_cast<int>(SimulationTier::Count); ++i) {
+      const auto tier{static_cast<SimulationTier>(i)};
+      ImGui::BulletText("%s: %d", SimulationLOD::GetTierName(tier),
+                        m_simulationLOD->GetTierCount(tier));
+    }
+  }
+
   ImGui::Separator();
   ImGui::Text("Component Types:");
   ImGui::BulletText("TransformComponent");
@@ -290,3 +450,75 @@ void ImGuiManager::ShowTestWindow() {
 
   ImGui::End();
 }
+
+void ImGuiManager::ShowPerformanceOverlay() {
+  constexpr float MARGIN{10.f};
+  const ImGuiViewport* viewport{ImGui::GetMainViewport()};
+  ImGui::SetNextWindowPos(
+      ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - MARGIN,
+             viewport->WorkPos.y + MARGIN),
+      ImGuiCond_Always, ImVec2(1.f, 0.f));
+  ImGui::SetNextWindowBgAlpha(0.6f);
+  constexpr ImGuiWindowFlags FLAGS{
+      ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+      ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+      ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove};
+  if (!ImGui::Begin("Performance", &m_showPerformanceOverlay, FLAGS)) {
+    ImGui::End();
+    return;
+  }
+
+  if (m_frameProfiler) {
+    const float averageMs{m_frameProfiler->GetAverageFrameMs()};
+    ImGui::Text("%.1f FPS  %.2f ms (last %.2f ms)",
+                averageMs > 0.f ? 1000.f / averageMs : 0.f, averageMs,
+                m_frameProfiler->GetLastFrameMs());
+    const auto& history{m_frameProfiler->GetFrameHistory()};
+    float worstMs{};
+    for (float ms : history) worstMs = std::max(worstMs, ms);
+    char overlay[32];
+    std::snprintf(overlay, sizeof(overlay), "max %.2f ms", worstMs);
+    // Fixed floor so a steady 60 Hz doesn't fill the graph with noise
+    ImGui::PlotLines("##frames", history.data(),
+                     static_cast<int>(history.size()),
+                     static_cast<int>(m_frameProfiler->GetHistoryOffset()),
+                     overlay, 0.f, std::max(worstMs, 33.4f), ImVec2(240, 50));
+
+    ImGui::Separator();
+    for (int i{}; i < static_cast<int>(FramePhase::Count); ++i) {
+      const auto phase{static_cast<FramePhase>(i)};
+      const FramePhaseStats& stats{m_frameProfiler->GetPhase(phase)};
+      if (stats.frames == 0) continue;
+      ImGui::Text("%-10s %7.3f ms  max %7.3f",
+                  FrameProfiler::GetPhaseName(phase), stats.lastMs,
+                  stats.maxMs);
+    }
+  }
+
+  ImGui::Separator();
+  if (m_simulation) {
+    const SimulationStats world{m_simulation->GetStats()};
+    ImGui::Text("Entities %zu  Bodies %zu  Tiles %zu", world.entities,
+                world.bodies, world.tiles);
+  }
+  std::int64_t currentBytes{};
+  std::int64_t peakBytes{};
+  for (int i{}; i < static_cast<int>(MemoryTag::Count); ++i) {
+    const MemorySnapshot mem{
+        EngineAllocator::GetSnapshot(static_cast<MemoryTag>(i))};
+    currentBytes += mem.currentBytes;
+    peakBytes += mem.peakBytes;
+  }
+  ImGui::Text("Engine memory %.1f KB (peak %.1f KB)", currentBytes / 1024.0,
+              peakBytes / 1024.0);
+  if (AllocationTracker::IsEnabled()) {
+    const AllocationFrameStats& heap{AllocationTracker::GetLastFrame()};
+    ImGui::Text("Heap: %lld allocs, %lld B last frame (%lld over budget)",
+                static_cast<long long>(heap.totalAllocations),
+                static_cast<long long>(heap.totalBytes),
+                static_cast<long long>(AllocationTracker::GetViolations()));
+  }
+  ImGui::TextDisabled("UI: %zu draw calls", m_renderer.GetDrawCallCount());
+
+  ImGui::End();
+}
@@ -0,0 +1,111 @@
+#include "ImGuiSfmlRenderer.hh"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Log.hh"
+
+namespace {
+
+// ImTextureID is void* or a 64-bit integer depending on the ImGui version;
+// the C-style casts convert a pointer to and from either
+ImTextureID ToTextureId(const sf::Texture* texture) {
+  return (ImTextureID)(std::intptr_t)texture;
+}
+
+const sf::Texture* ToTexture(ImTextureID textureId) {
+  return (const sf::Texture*)(std::intptr_t)textureId;
+}
+
+// ImU32 colors are packed as 0xAABBGGRR
+sf::Vertex ToVertex(const ImDrawVert& vertex) {
+  return sf::Vertex{
+      sf::Vector2f(vertex.pos.x, vertex.pos.y),
+      sf::Color(static_cast<std::uint8_t>(vertex.col),
+                static_cast<std::uint8_t>(vertex.col >> 8),
+                static_cast<std::uint8_t>(vertex.col >> 16),
+                static_cast<std::uint8_t>(vertex.col >> 24)),
+      sf::Vector2f(vertex.uv.x, vertex.uv.y)};
+}
+
+}  // namespace
+
+bool ImGuiSfmlRenderer::CreateFontTexture() {
+  ImGuiIO& io = ImGui::GetIO();
+  unsigned char* pixels{};
+  int width{};
+  int height{};
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+  if (!fontTexture.resize(sf::Vector2u(static_cast<unsigned>(width),
+                                       static_cast<unsigned>(height)))) {
+    BEP_LOG_ERROR(LogCategory::General,
+                  "ImGuiSfmlRenderer: could not create a {}x{} font texture",
+                  width, height);
+    return false;
+  }
+  fontTexture.update(pixels);
+  fontTexture.setSmooth(true);
+  io.Fonts->SetTexID(ToTextureId(&fontTexture));
+  // Draw commands carry vertex offsets, so lists may exceed 64K vertices
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+  io.BackendRendererName = "BlackEngine SFML";
+  return true;
+}
+
+void ImGuiSfmlRenderer::RenderDrawData(sf::RenderTarget& target,
+                                       const ImDrawData& drawData) {
+  drawCalls = 0;
+  const ImVec2 origin{drawData.DisplayPos};
+  const ImVec2 size{drawData.DisplaySize};
+  if (size.x <= 0.f || size.y <= 0.f) return;
+
+  const sf::View previousView{target.getView()};
+  sf::View view(sf::FloatRect({origin.x, origin.y}, {size.x, size.y}));
+  sf::RenderStates states;
+  states.blendMode = sf::BlendAlpha;
+  // ImGui UVs are 0..1 over the texture
+  states.coordinateType = sf::CoordinateType::Normalized;
+
+  for (int n{}; n < drawData.CmdListsCount; ++n) {
+    const ImDrawList* list{drawData.CmdLists[n]};
+    const auto indexCount{static_cast<std::size_t>(list->IdxBuffer.Size)};
+    if (vertices.size() < indexCount) vertices.resize(indexCount);
+
+    for (const ImDrawCmd& cmd : list->CmdBuffer) {
+      if (cmd.UserCallback) {
+        // Nothing is cached between commands, so a reset is a no-op
+        if (cmd.UserCallback != ImDrawCallback_ResetRenderState) {
+          cmd.UserCallback(list, &cmd);
+        }
+        continue;
+      }
+
+      const float left{std::max(cmd.ClipRect.x - origin.x, 0.f)};
+      const float top{std::max(cmd.ClipRect.y - origin.y, 0.f)};
+      const float right{std::min(cmd.ClipRect.z - origin.x, size.x)};
+      const float bottom{std::min(cmd.ClipRect.w - origin.y, size.y)};
+      if (right <= left || bottom <= top || cmd.ElemCount == 0) continue;
+
+      for (unsigned i{}; i < cmd.ElemCount; ++i) {
+        const unsigned index{cmd.IdxOffset + i};
+        vertices[index] =
+            ToVertex(list->VtxBuffer[static_cast<int>(
+                cmd.VtxOffset + list->IdxBuffer[static_cast<int>(index)])]);
+      }
+
+      // The scissor is in fractions of the viewport
+      view.setScissor(sf::FloatRect({left / size.x, top / size.y},
+                                    {(right - left) / size.x,
+                                     (bottom - top) / size.y}));
+      target.setView(view);
+      states.texture = ToTexture(cmd.GetTexID());
+      target.draw(&vertices[cmd.IdxOffset], cmd.ElemCount,
+                  sf::PrimitiveType::Triangles, states);
+      ++drawCalls;
+    }
+  }
+
+  target.setView(previousView);
+}
+
+std::size_t ImGuiSfmlRenderer::GetDrawCallCount() const { return drawCalls; }
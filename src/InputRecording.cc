@@ -0,0 +1,224 @@
+#include "InputRecording.hh"
+
+#include <bit>
+#include <cstring>
+#include <gsl/assert>
+
+#include "Log.hh"
+
+namespace {
+
+constexpr char MAGIC[4]{'B', 'E', 'I', 'R'};
+constexpr std::uint16_t VERSION{1};
+
+enum RecordType : std::uint8_t {
+  RECORD_INPUT = 1,
+  RECORD_CHECKSUM = 2,
+  RECORD_END = 3
+};
+
+template <typename T>
+void WriteLE(std::ostream& out, T value) {
+  using U = std::make_unsigned_t<T>;
+  const U bits{static_cast<U>(value)};
+  for (std::size_t i{}; i < sizeof(T); ++i) {
+    out.put(static_cast<char>((bits >> (i * 8)) & 0xFF));
+  }
+}
+
+template <typename T>
+bool ReadLE(std::istream& in, T& value) {
+  using U = std::make_unsigned_t<T>;
+  U bits{};
+  for (std::size_t i{}; i < sizeof(T); ++i) {
+    const int byte{in.get()};
+    if (byte == std::char_traits<char>::eof()) return false;
+    bits |= static_cast<U>(static_cast<U>(byte) << (i * 8));
+  }
+  value = static_cast<T>(bits);
+  return true;
+}
+
+template <std::size_t N>
+void WriteBits(std::ostream& out, const std::bitset<N>& bits) {
+  for (std::size_t byte{}; byte < (N + 7) / 8; ++byte) {
+    std::uint8_t packed{};
+    for (std::size_t bit{}; bit < 8 && byte * 8 + bit < N; ++bit) {
+      packed |= static_cast<std::uint8_t>(bits[byte * 8 + bit] << bit);
+    }
+    WriteLE(out, packed);
+  }
+}
+
+template <std::size_t N>
+bool ReadBits(std::istream& in, std::bitset<N>& bits) {
+  for (std::size_t byte{}; byte < (N + 7) / 8; ++byte) {
+    std::uint8_t packed{};
+    if (!ReadLE(in, packed)) return false;
+    for (std::size_t bit{}; bit < 8 && byte * 8 + bit < N; ++bit) {
+      bits[byte * 8 + bit] = (packed >> bit) & 1;
+    }
+  }
+  return true;
+}
+
+bool SameDeviceState(const InputSnapshot& a, const InputSnapshot& b) {
+  return a.keysDown == b.keysDown && a.keysPressed == b.keysPressed &&
+         a.keysReleased == b.keysReleased && a.mouseDown == b.mouseDown &&
+         a.mousePressed == b.mousePressed &&
+         a.mouseReleased == b.mouseReleased &&
+         a.mousePosition == b.mousePosition;
+}
+
+}  // namespace
+
+InputRecorder::~InputRecorder() { Close(); }
+
+bool InputRecorder::Open(const std::string& path, float fixedStep,
+                         std::uint32_t checksumInterval) {
+  Expects(fixedStep > 0.f);
+  out.open(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    BEP_LOG_ERROR(LogCategory::Input,
+                  "Failed to open input recording for writing: {}", path);
+    return false;
+  }
+  out.write(MAGIC, sizeof(MAGIC));
+  WriteLE(out, VERSION);
+  WriteLE(out, std::bit_cast<std::uint32_t>(fixedStep));
+  WriteLE(out, checksumInterval);
+  hasPrevious = false;
+  tickCount = 0;
+  return true;
+}
+
+void InputRecorder::WriteFrame(std::uint32_t tick,
+                               const InputSnapshot& snapshot) {
+  if (!out.is_open()) return;
+  tickCount = tick + 1;
+  if (hasPrevious && SameDeviceState(previous, snapshot)) return;
+  previous = snapshot;
+  hasPrevious = true;
+
+  WriteLE(out, RECORD_INPUT);
+  WriteLE(out, tick);
+  WriteBits(out, snapshot.keysDown);
+  WriteBits(out, snapshot.keysPressed);
+  WriteBits(out, snapshot.keysReleased);
+  WriteBits(out, snapshot.mouseDown);
+  WriteBits(out, snapshot.mousePressed);
+  WriteBits(out, snapshot.mouseReleased);
+  WriteLE(out, snapshot.mousePosition.x);
+  WriteLE(out, snapshot.mousePosition.y);
+}
+
+void InputRecorder::WriteChecksum(std::uint32_t tick, std::uint64_t checksum) {
+  if (!out.is_open()) return;
+  WriteLE(out, RECORD_CHECKSUM);
+  WriteLE(out, tick);
+  WriteLE(out, checksum);
+}
+
+void InputRecorder::Close() {
+  if (!out.is_open()) return;
+  WriteLE(out, RECORD_END);
+  WriteLE(out, tickCount);
+  out.close();
+}
+
+bool InputReplayer::Open(const std::string& path) {
+  in.open(path, std::ios::binary);
+  if (!in.is_open()) {
+    BEP_LOG_ERROR(LogCategory::Input, "Failed to open input recording: {}",
+                  path);
+    return false;
+  }
+  char magic[sizeof(MAGIC)]{};
+  std::uint16_t version{};
+  std::uint32_t stepBits{};
+  in.read(magic, sizeof(magic));
+  if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !ReadLE(in, version) || version != VERSION || !ReadLE(in, stepBits) ||
+      !ReadLE(in, checksumInterval)) {
+    BEP_LOG_ERROR(LogCategory::Input, "Not a supported input recording: {}",
+                  path);
+    return false;
+  }
+  fixedStep = std::bit_cast<float>(stepBits);
+  if (!(fixedStep > 0.f)) {
+    BEP_LOG_ERROR(LogCategory::Input, "Input recording has no fixed step: {}",
+                  path);
+    return false;
+  }
+  state = InputSnapshot{};
+  if (!ReadRecordHeader()) {
+    BEP_LOG_ERROR(LogCategory::Input, "Input recording has no records: {}",
+                  path);
+    return false;
+  }
+  return true;
+}
+
+bool InputReplayer::ReadRecordHeader() {
+  return ReadLE(in, nextType) && ReadLE(in, nextTick);
+}
+
+bool InputReplayer::ReadFrame(std::uint32_t tick, InputSnapshot& frameState) {
+  // Edges only last for the tick they were recorded on
+  state.keysPressed.reset();
+  state.keysReleased.reset();
+  state.mousePressed.reset();
+  state.mouseReleased.reset();
+  expectedChecksum.reset();
+
+  while (nextTick <= tick) {
+    switch (nextType) {
+      case RECORD_INPUT: {
+        const bool complete{
+            ReadBits(in, state.keysDown) && ReadBits(in, state.keysPressed) &&
+            ReadBits(in, state.keysReleased) && ReadBits(in, state.mouseDown) &&
+            ReadBits(in, state.mousePressed) &&
+            ReadBits(in, state.mouseReleased) &&
+            ReadLE(in, state.mousePosition.x) &&
+            ReadLE(in, state.mousePosition.y)};
+        if (!complete) {
+          BEP_LOG_ERROR(LogCategory::Input,
+                        "Input recording truncated at tick {}", nextTick);
+          return false;
+        }
+        break;
+      }
+      case RECORD_CHECKSUM: {
+        std::uint64_t checksum{};
+        if (!ReadLE(in, checksum)) return false;
+        if (nextTick == tick) expectedChecksum = checksum;
+        break;
+      }
+      case RECORD_END:
+        return false;
+      default:
+        BEP_LOG_ERROR(LogCategory::Input,
+                      "Corrupt input recording: record type {}",
+                      static_cast<int>(nextType));
+        return false;
+    }
+    if (!ReadRecordHeader()) {
+      BEP_LOG_ERROR(LogCategory::Input,
+                    "Input recording ends without an End record");
+      return false;
+    }
+  }
+
+  frameState = state;
+  return true;
+}
+
+std::optional<std::uint64_t> InputReplayer::GetExpectedChecksum() const {
+  return expectedChecksum;
+}
+
+float InputReplayer::GetFixedStep() const { return fixedStep; }
+
+std::uint32_t InputReplayer::GetChecksumInterval() const {
+  return checksumInterval;
+}
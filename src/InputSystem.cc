@@ -0,0 +1,301 @@
+#include "InputSystem.hh"
+
+#include <algorithm>
+#include <gsl/assert>
+#include <gsl/narrow>
+
+#include "AssetFiles.hh"
+#include "Log.hh"
+#include "json/json.h"
+
+namespace {
+
+// sf::Keyboard::Key enumerator names, in enum order
+constexpr const char* KEY_NAMES[]{
+    "A",         "B",         "C",         "D",        "E",
+    "F",         "G",         "H",         "I",        "J",
+    "K",         "L",         "M",         "N",        "O",
+    "P",         "Q",         "R",         "S",        "T",
+    "U",         "V",         "W",         "X",        "Y",
+    "Z",         "Num0",      "Num1",      "Num2",     "Num3",
+    "Num4",      "Num5",      "Num6",      "Num7",     "Num8",
+    "Num9",      "Escape",    "LControl",  "LShift",   "LAlt",
+    "LSystem",   "RControl",  "RShift",    "RAlt",     "RSystem",
+    "Menu",      "LBracket",  "RBracket",  "Semicolon", "Comma",
+    "Period",    "Apostrophe", "Slash",    "Backslash", "Grave",
+    "Equal",     "Hyphen",    "Space",     "Enter",    "Backspace",
+    "Tab",       "PageUp",    "PageDown",  "End",      "Home",
+    "Insert",    "Delete",    "Add",       "Subtract", "Multiply",
+    "Divide",    "Left",      "Right",     "Up",       "Down",
+    "Numpad0",   "Numpad1",   "Numpad2",   "Numpad3",  "Numpad4",
+    "Numpad5",   "Numpad6",   "Numpad7",   "Numpad8",  "Numpad9",
+    "F1",        "F2",        "F3",        "F4",       "F5",
+    "F6",        "F7",        "F8",        "F9",       "F10",
+    "F11",       "F12",       "F13",       "F14",      "F15",
+    "Pause"};
+static_assert(std::size(KEY_NAMES) == sf::Keyboard::KeyCount,
+              "KEY_NAMES must list every sf::Keyboard::Key");
+
+constexpr const char* MOUSE_NAMES[]{"MouseLeft", "MouseRight", "MouseMiddle",
+                                    "MouseExtra1", "MouseExtra2"};
+static_assert(std::size(MOUSE_NAMES) == sf::Mouse::ButtonCount,
+              "MOUSE_NAMES must list every sf::Mouse::Button");
+
+template <std::size_t N>
+int IndexOf(const char* const (&names)[N], const std::string& name) {
+  for (std::size_t i{}; i < N; ++i) {
+    if (name == names[i]) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+template <typename Binding>
+bool ParseBindings(const Json::Value& names, const std::string& owner,
+                   const std::string& path, std::vector<Binding>& bindings) {
+  for (const Json::Value& value : names) {
+    const std::string name{value.asString()};
+    if (const int key{IndexOf(KEY_NAMES, name)}; key >= 0) {
+      bindings.push_back(Binding{false, key});
+    } else if (const int button{IndexOf(MOUSE_NAMES, name)}; button >= 0) {
+      bindings.push_back(Binding{true, button});
+    } else {
+      BEP_LOG_ERROR(LogCategory::Input,
+                    "Unknown input '{}' bound to '{}' in {}", name, owner,
+                    path);
+      return false;
+    }
+  }
+  return true;
+}
+
+template <std::size_t N>
+bool TestBit(const std::bitset<N>& bits, int index) {
+  return index >= 0 && static_cast<std::size_t>(index) < N && bits[index];
+}
+
+}  // namespace
+
+bool InputSnapshot::IsKeyDown(sf::Keyboard::Key key) const {
+  return TestBit(keysDown, static_cast<int>(key));
+}
+
+bool InputSnapshot::WasKeyPressed(sf::Keyboard::Key key) const {
+  return TestBit(keysPressed, static_cast<int>(key));
+}
+
+bool InputSnapshot::WasKeyReleased(sf::Keyboard::Key key) const {
+  return TestBit(keysReleased, static_cast<int>(key));
+}
+
+bool InputSnapshot::IsMouseDown(sf::Mouse::Button button) const {
+  return TestBit(mouseDown, static_cast<int>(button));
+}
+
+bool InputSnapshot::WasMousePressed(sf::Mouse::Button button) const {
+  return TestBit(mousePressed, static_cast<int>(button));
+}
+
+bool InputSnapshot::WasMouseReleased(sf::Mouse::Button button) const {
+  return TestBit(mouseReleased, static_cast<int>(button));
+}
+
+bool InputSnapshot::IsActionDown(InputActionId action) const {
+  return TestBit(actionsDown, action);
+}
+
+bool InputSnapshot::WasActionPressed(InputActionId action) const {
+  return TestBit(actionsPressed, action);
+}
+
+bool InputSnapshot::WasActionReleased(InputActionId action) const {
+  return TestBit(actionsReleased, action);
+}
+
+float InputSnapshot::GetAxis(InputAxisId axis) const {
+  return axis < axes.size() ? axes[axis] : 0.f;
+}
+
+bool InputSystem::LoadBindings(const std::string& path) {
+  const AssetData data{AssetFiles::Read(path)};
+  if (!data) {
+    BEP_LOG_ERROR(LogCategory::Input, "Failed to open input bindings: {}",
+                  path);
+    return false;
+  }
+
+  Json::Value root;
+  std::string errors;
+  if (!AssetFiles::ParseJson(data, root, errors)) {
+    BEP_LOG_ERROR(LogCategory::Input,
+                  "JSON parsing error in input bindings {}: {}", path,
+                  errors);
+    return false;
+  }
+  if (!root.isObject()) {
+    BEP_LOG_ERROR(LogCategory::Input,
+                  "Input bindings must be a JSON object: {}", path);
+    return false;
+  }
+
+  std::vector<std::string> newActionNames;
+  std::vector<std::vector<Binding>> newActions;
+  const Json::Value& actionsJson{root["actions"]};
+  if (actionsJson.isObject()) {
+    for (const auto& name : actionsJson.getMemberNames()) {
+      std::vector<Binding> bindings;
+      if (!ParseBindings(actionsJson[name], name, path, bindings)) {
+        return false;
+      }
+      newActionNames.push_back(name);
+      newActions.push_back(std::move(bindings));
+    }
+  }
+
+  std::vector<std::string> newAxisNames;
+  std::vector<Axis> newAxes;
+  const Json::Value& axesJson{root["axes"]};
+  if (axesJson.isObject()) {
+    for (const auto& name : axesJson.getMemberNames()) {
+      Axis axis;
+      if (!ParseBindings(axesJson[name]["positive"], name, path,
+                         axis.positive) ||
+          !ParseBindings(axesJson[name]["negative"], name, path,
+                         axis.negative)) {
+        return false;
+      }
+      newAxisNames.push_back(name);
+      newAxes.push_back(std::move(axis));
+    }
+  }
+
+  if (newActions.size() > InputSnapshot::MAX_ACTIONS ||
+      newAxes.size() > InputSnapshot::MAX_AXES) {
+    BEP_LOG_ERROR(LogCategory::Input,
+                  "Too many actions or axes in {} (max {} / {})", path,
+                  InputSnapshot::MAX_ACTIONS, InputSnapshot::MAX_AXES);
+    return false;
+  }
+
+  actionNames = std::move(newActionNames);
+  actions = std::move(newActions);
+  axisNames = std::move(newAxisNames);
+  axes = std::move(newAxes);
+  return true;
+}
+
+void InputSystem::BeginFrame() {
+  pending.keysPressed.reset();
+  pending.keysReleased.reset();
+  pending.mousePressed.reset();
+  pending.mouseReleased.reset();
+}
+
+void InputSystem::ProcessEvent(const sf::Event& event) {
+  if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+    const int code{static_cast<int>(key->code)};
+    // Ignores key repeat: only the up -> down transition is an edge
+    if (code >= 0 && code < static_cast<int>(sf::Keyboard::KeyCount) &&
+        !pending.keysDown[code]) {
+      pending.keysDown.set(code);
+      pending.keysPressed.set(code);
+    }
+  } else if (const auto* key = event.getIf<sf::Event::KeyReleased>()) {
+    const int code{static_cast<int>(key->code)};
+    if (code >= 0 && code < static_cast<int>(sf::Keyboard::KeyCount) &&
+        pending.keysDown[code]) {
+      pending.keysDown.reset(code);
+      pending.keysReleased.set(code);
+    }
+  } else if (const auto* mouse =
+                 event.getIf<sf::Event::MouseButtonPressed>()) {
+    const auto button{static_cast<std::size_t>(mouse->button)};
+    if (button < sf::Mouse::ButtonCount && !pending.mouseDown[button]) {
+      pending.mouseDown.set(button);
+      pending.mousePressed.set(button);
+    }
+    pending.mousePosition = mouse->position;
+  } else if (const auto* mouse =
+                 event.getIf<sf::Event::MouseButtonReleased>()) {
+    const auto button{static_cast<std::size_t>(mouse->button)};
+    if (button < sf::Mouse::ButtonCount && pending.mouseDown[button]) {
+      pending.mouseDown.reset(button);
+      pending.mouseReleased.set(button);
+    }
+    pending.mousePosition = mouse->position;
+  } else if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+    pending.mousePosition = moved->position;
+  } else if (event.is<sf::Event::FocusLost>()) {
+    // Release events for keys held while unfocused never arrive
+    ReleaseAll();
+  }
+}
+
+void InputSystem::OverrideDeviceState(const InputSnapshot& state) {
+  pending.keysDown = state.keysDown;
+  pending.keysPressed = state.keysPressed;
+  pending.keysReleased = state.keysReleased;
+  pending.mouseDown = state.mouseDown;
+  pending.mousePressed = state.mousePressed;
+  pending.mouseReleased = state.mouseReleased;
+  pending.mousePosition = state.mousePosition;
+}
+
+void InputSystem::ReleaseAll() {
+  pending.keysReleased |= pending.keysDown;
+  pending.keysDown.reset();
+  pending.mouseReleased |= pending.mouseDown;
+  pending.mouseDown.reset();
+}
+
+bool InputSystem::IsDown(const Binding& binding) const {
+  return binding.mouse ? pending.mouseDown[binding.code]
+                       : pending.keysDown[binding.code];
+}
+
+bool InputSystem::WasPressed(const Binding& binding) const {
+  return binding.mouse ? pending.mousePressed[binding.code]
+                       : pending.keysPressed[binding.code];
+}
+
+bool InputSystem::WasReleased(const Binding& binding) const {
+  return binding.mouse ? pending.mouseReleased[binding.code]
+                       : pending.keysReleased[binding.code];
+}
+
+void InputSystem::EndFrame() {
+  pending.actionsDown.reset();
+  pending.actionsPressed.reset();
+  pending.actionsReleased.reset();
+  for (std::size_t i{}; i < actions.size(); ++i) {
+    for (const Binding& binding : actions[i]) {
+      if (IsDown(binding)) pending.actionsDown.set(i);
+      if (WasPressed(binding)) pending.actionsPressed.set(i);
+      if (WasReleased(binding)) pending.actionsReleased.set(i);
+    }
+  }
+
+  pending.axes.fill(0.f);
+  for (std::size_t i{}; i < axes.size(); ++i) {
+    float value{};
+    for (const Binding& binding : axes[i].positive) value += IsDown(binding);
+    for (const Binding& binding : axes[i].negative) value -= IsDown(binding);
+    pending.axes[i] = std::clamp(value, -1.f, 1.f);
+  }
+
+  ++pending.frame;
+  snapshot = pending;
+}
+
+const InputSnapshot& InputSystem::GetSnapshot() const { return snapshot; }
+
+InputActionId InputSystem::FindAction(const std::string& name) const {
+  auto it = std::find(actionNames.begin(), actionNames.end(), name);
+  if (it == actionNames.end()) return INVALID_INPUT_ID;
+  return gsl::narrow_cast<InputActionId>(it - actionNames.begin());
+}
+
+InputAxisId InputSystem::FindAxis(const std::string& name) const {
+  auto it = std::find(axisNames.begin(), axisNames.end(), name);
+  if (it == axisNames.end()) return INVALID_INPUT_ID;
+  return gsl::narrow_cast<InputAxisId>(it - axisNames.begin());
+}
@@ -0,0 +1,96 @@
+#include "JobSystem.hh"
+
+#include <gsl/assert>
+
+#include "AllocationTracker.hh"
+
+namespace {
+thread_local bool insideJob{false};
+}
+
+JobSystem::JobSystem(unsigned workerCount) {
+  workers.reserve(workerCount);
+  for (unsigned i{}; i < workerCount; ++i) {
+    workers.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeWorkers.notify_all();
+  for (auto& worker : workers) {
+    if (worker.joinable()) worker.join();
+  }
+}
+
+unsigned JobSystem::DefaultWorkerCount() {
+  const unsigned cores{std::thread::hardware_concurrency()};
+  return cores > 1 ? cores - 1 : 0;
+}
+
+unsigned JobSystem::GetWorkerCount() const {
+  return static_cast<unsigned>(workers.size());
+}
+
+void JobSystem::RunIndices() {
+  const bool wasInsideJob{insideJob};
+  insideJob = true;
+  for (std::size_t i{nextIndex.fetch_add(1, std::memory_order_relaxed)};
+       i < jobCount; i = nextIndex.fetch_add(1, std::memory_order_relaxed)) {
+    (*job)(i);
+  }
+  insideJob = wasInsideJob;
+}
+
+void JobSystem::WorkerLoop() {
+  // Workers run frame work (physics cells), so they count toward its budget
+  AllocationTracker::MarkFrameThread();
+  std::uint64_t seenGeneration{};
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wakeWorkers.wait(lock, [&]() {
+        return stopping || generation != seenGeneration;
+      });
+      if (stopping) return;
+      seenGeneration = generation;
+    }
+
+    RunIndices();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--busyWorkers == 0) batchDone.notify_one();
+    }
+  }
+}
+
+void JobSystem::ParallelFor(std::size_t count,
+                            const std::function<void(std::size_t)>& fn) {
+  if (count == 0) return;
+  if (workers.empty() || count == 1 || insideJob) {
+    for (std::size_t i{}; i < count; ++i) fn(i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    Expects(busyWorkers == 0);
+    job = &fn;
+    jobCount = count;
+    nextIndex.store(0, std::memory_order_relaxed);
+    busyWorkers = workers.size();
+    ++generation;
+  }
+  wakeWorkers.notify_all();
+
+  RunIndices();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  batchDone.wait(lock, [&]() { return busyWorkers == 0; });
+  job = nullptr;
+  jobCount = 0;
+}
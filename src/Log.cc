@@ -0,0 +1,281 @@
+#include "Log.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "MpscQueue.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How long the sink sleeps when the queue is empty
+constexpr auto SINK_IDLE{std::chrono::milliseconds(2)};
+constexpr std::size_t CATEGORY_COUNT{
+    static_cast<std::size_t>(LogCategory::Count)};
+
+struct LogState;
+void StopSink(LogState& state);
+
+struct LogState {
+  const Clock::time_point epoch{Clock::now()};
+  std::array<std::atomic<LogLevel>, CATEGORY_COUNT> levels;
+  std::atomic<bool> running{};
+  std::atomic<std::uint64_t> dropped{};
+
+  // Start, Stop and the synchronous path
+  std::mutex mutex;
+  // Created by the first Start and kept: a producer that saw 'running' may
+  // still push after Stop
+  std::unique_ptr<MpscQueue<LogRecord>> queue;
+  std::thread sink;
+  std::ofstream file;
+
+  LogState() {
+    for (auto& level : levels) level.store(LogLevel::Info);
+  }
+  ~LogState() { StopSink(*this); }
+};
+
+LogState& State() {
+  static LogState state;
+  return state;
+}
+
+template <typename Number>
+void AppendNumber(std::string& out, Number value) {
+  char buffer[32];
+  const auto result{std::to_chars(std::begin(buffer), std::end(buffer), value)};
+  out.append(buffer, result.ptr);
+}
+
+void AppendArg(std::string& out, const LogRecord& record, std::size_t index) {
+  const LogRecord::ArgValue& value{record.values[index]};
+  switch (record.types[index]) {
+    case LogRecord::ArgType::Int:
+      AppendNumber(out, value.i);
+      break;
+    case LogRecord::ArgType::UInt:
+      AppendNumber(out, value.u);
+      break;
+    case LogRecord::ArgType::Double: {
+      char buffer[32];
+      const auto result{std::to_chars(std::begin(buffer), std::end(buffer),
+                                      value.d, std::chars_format::general,
+                                      6)};
+      out.append(buffer, result.ptr);
+      break;
+    }
+    case LogRecord::ArgType::Bool:
+      out += value.u ? "true" : "false";
+      break;
+    case LogRecord::ArgType::Char:
+      out += static_cast<char>(value.u);
+      break;
+    case LogRecord::ArgType::Text:
+      out.append(record.text.data() + value.text.offset, value.text.length);
+      break;
+  }
+}
+
+// "[   1.234] warning audio: message\n"
+void Format(const LogRecord& record, std::string& out) {
+  out.clear();
+  char stamp[32];
+  const auto seconds{static_cast<double>(record.microseconds) / 1e6};
+  const auto result{std::to_chars(std::begin(stamp), std::end(stamp), seconds,
+                                  std::chars_format::fixed, 3)};
+  const std::size_t width{static_cast<std::size_t>(result.ptr - stamp)};
+  out += '[';
+  if (width < 8) out.append(8 - width, ' ');
+  out.append(stamp, result.ptr);
+  out += "] ";
+  out += Log::GetLevelName(record.level);
+  out += ' ';
+  out += Log::GetCategoryName(record.category);
+  out += ": ";
+
+  std::size_t arg{};
+  for (const char* c{record.format}; *c; ++c) {
+    if (c[0] == '{' && c[1] == '}' && arg < record.argCount) {
+      AppendArg(out, record, arg++);
+      ++c;
+    } else {
+      out += *c;
+    }
+  }
+  out += '\n';
+}
+
+void Output(LogState& state, const std::string& line, LogLevel level) {
+  if (state.file.is_open()) {
+    state.file << line;
+  } else if (level >= LogLevel::Warning) {
+    std::cerr << line;
+  } else {
+    std::cout << line;
+  }
+}
+
+void Flush(LogState& state) {
+  if (state.file.is_open()) {
+    state.file.flush();
+  } else {
+    std::cout.flush();
+    std::cerr.flush();
+  }
+}
+
+void RunSink(LogState& state) {
+  std::string line;
+  LogRecord record;
+  std::uint64_t reportedDrops{};
+  while (true) {
+    // Read before draining, so nothing queued ahead of Stop is missed
+    const bool stopping{!state.running.load(std::memory_order_acquire)};
+    bool wrote{};
+    while (state.queue->TryPop(record)) {
+      Format(record, line);
+      Output(state, line, record.level);
+      wrote = true;
+    }
+    const std::uint64_t drops{state.dropped.load(std::memory_order_relaxed)};
+    if (drops != reportedDrops) {
+      line = "Log: " + std::to_string(drops - reportedDrops) +
+             " messages dropped (queue full)\n";
+      Output(state, line, LogLevel::Warning);
+      reportedDrops = drops;
+      wrote = true;
+    }
+    if (wrote) Flush(state);
+    if (stopping) break;
+    if (!wrote) std::this_thread::sleep_for(SINK_IDLE);
+  }
+}
+
+void StopSink(LogState& state) {
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (!state.sink.joinable()) return;
+  state.running.store(false, std::memory_order_release);
+  state.sink.join();
+  if (state.file.is_open()) state.file.close();
+}
+
+}  // namespace
+
+void LogRecord::CaptureText(std::string_view value) {
+  const std::size_t room{TEXT_BYTES - textUsed};
+  const std::size_t length{std::min(value.size(), room)};
+  std::memcpy(text.data() + textUsed, value.data(), length);
+  TextSpan& span{Push(ArgType::Text).text};
+  span.offset = textUsed;
+  span.length = static_cast<std::uint16_t>(length);
+  textUsed = static_cast<std::uint16_t>(textUsed + length);
+}
+
+void Log::Start(const LogSettings& settings) {
+  LogState& state{State()};
+  Stop();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  SetLevel(settings.level);
+  if (!settings.path.empty()) {
+    state.file.open(settings.path, std::ios::app);
+    if (!state.file.is_open()) {
+      std::cerr << "Failed to open log file " << settings.path
+                << "; logging to the console" << std::endl;
+    }
+  }
+  if (!state.queue) {
+    state.queue = std::make_unique<MpscQueue<LogRecord>>(
+        std::max<std::size_t>(settings.queueCapacity, 2));
+  }
+  state.running.store(true, std::memory_order_release);
+  state.sink = std::thread(RunSink, std::ref(state));
+}
+
+void Log::Stop() { StopSink(State()); }
+
+void Log::SetLevel(LogLevel level) {
+  for (auto& categoryLevel : State().levels) {
+    categoryLevel.store(level, std::memory_order_relaxed);
+  }
+}
+
+void Log::SetLevel(LogCategory category, LogLevel level) {
+  State()
+      .levels[static_cast<std::size_t>(category)]
+      .store(level, std::memory_order_relaxed);
+}
+
+bool Log::IsEnabled(LogLevel level, LogCategory category) {
+  return level >= State()
+                      .levels[static_cast<std::size_t>(category)]
+                      .load(std::memory_order_relaxed);
+}
+
+std::uint64_t Log::GetDropped() {
+  return State().dropped.load(std::memory_order_relaxed);
+}
+
+void Log::Submit(LogRecord& record) {
+  LogState& state{State()};
+  record.microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                            state.epoch)
+          .count();
+  if (state.running.load(std::memory_order_acquire)) {
+    if (!state.queue->TryPush(record)) {
+      state.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+  std::string line;
+  Format(record, line);
+  std::lock_guard<std::mutex> lock(state.mutex);
+  Output(state, line, record.level);
+  Flush(state);
+}
+
+const char* Log::GetLevelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::Trace:
+      return "trace";
+    case LogLevel::Debug:
+      return "debug";
+    case LogLevel::Info:
+      return "info";
+    case LogLevel::Warning:
+      return "warning";
+    case LogLevel::Error:
+      return "error";
+    default:
+      return "off";
+  }
+}
+
+const char* Log::GetCategoryName(LogCategory category) {
+  switch (category) {
+    case LogCategory::General:
+      return "general";
+    case LogCategory::Physics:
+      return "physics";
+    case LogCategory::Animation:
+      return "animation";
+    case LogCategory::Audio:
+      return "audio";
+    case LogCategory::Assets:
+      return "assets";
+    case LogCategory::Input:
+      return "input";
+    default:
+      return "unknown";
+  }
+}
@@ -0,0 +1,162 @@
+#include "Metrics.hh"
+
+#include <algorithm>
+#include <gsl/assert>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Log.hh"
+
+namespace {
+
+template <typename Metric>
+struct NamedMetric {
+  std::string name;
+  std::unique_ptr<Metric> metric;
+};
+
+struct MetricsState {
+  std::mutex mutex;
+  std::vector<NamedMetric<MetricCounter>> counters;
+  std::vector<NamedMetric<MetricGauge>> gauges;
+  std::vector<NamedMetric<MetricHistogram>> histograms;
+};
+
+MetricsState& State() {
+  static MetricsState state;
+  return state;
+}
+
+// Caller holds the state lock
+template <typename Metric, typename... Args>
+Metric& FindOrAdd(std::vector<NamedMetric<Metric>>& metrics,
+                  std::string_view name, Args&&... args) {
+  Expects(!name.empty());
+  for (auto& entry : metrics) {
+    if (entry.name == name) return *entry.metric;
+  }
+  metrics.push_back(NamedMetric<Metric>{
+      std::string(name),
+      std::make_unique<Metric>(std::forward<Args>(args)...)});
+  return *metrics.back().metric;
+}
+
+template <typename Metric, typename WriteValue>
+void WriteObject(std::ostream& out, const char* key,
+                 const std::vector<NamedMetric<Metric>>& metrics,
+                 WriteValue&& writeValue) {
+  out << '"' << key << "\":{";
+  for (std::size_t i{}; i < metrics.size(); ++i) {
+    if (i > 0) out << ',';
+    out << '"' << metrics[i].name << "\":";
+    writeValue(*metrics[i].metric);
+  }
+  out << '}';
+}
+
+}  // namespace
+
+MetricHistogram::MetricHistogram(std::span<const double> upperEdges)
+    : edgeCount(upperEdges.size()) {
+  Expects(upperEdges.size() < MAX_BUCKETS);
+  Expects(std::is_sorted(upperEdges.begin(), upperEdges.end()));
+  std::copy(upperEdges.begin(), upperEdges.end(), edges.begin());
+}
+
+void MetricHistogram::Observe(double value) {
+  // A handful of edges: a linear scan beats a binary search here
+  std::size_t bucket{};
+  while (bucket < edgeCount && value > edges[bucket]) ++bucket;
+  buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::span<const double> MetricHistogram::GetEdges() const {
+  return std::span<const double>(edges.data(), edgeCount);
+}
+
+std::int64_t MetricHistogram::GetBucket(std::size_t bucket) const {
+  Expects(bucket <= edgeCount);
+  return buckets[bucket].load(std::memory_order_relaxed);
+}
+
+std::int64_t MetricHistogram::GetCount() const {
+  return count.load(std::memory_order_relaxed);
+}
+
+double MetricHistogram::GetSum() const {
+  return sum.load(std::memory_order_relaxed);
+}
+
+MetricCounter& Metrics::RegisterCounter(std::string_view name) {
+  MetricsState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return FindOrAdd(state.counters, name);
+}
+
+MetricGauge& Metrics::RegisterGauge(std::string_view name) {
+  MetricsState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return FindOrAdd(state.gauges, name);
+}
+
+MetricHistogram& Metrics::RegisterHistogram(
+    std::string_view name, std::span<const double> upperEdges) {
+  MetricsState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return FindOrAdd(state.histograms, name, upperEdges);
+}
+
+void Metrics::WriteJson(std::ostream& out) {
+  MetricsState& state{State()};
+  // Only guards the lists; values are read while other threads update them
+  std::lock_guard<std::mutex> lock(state.mutex);
+  out << '{';
+  WriteObject(out, "counters", state.counters,
+              [&](const MetricCounter& counter) { out << counter.Get(); });
+  out << ',';
+  WriteObject(out, "gauges", state.gauges,
+              [&](const MetricGauge& gauge) { out << gauge.Get(); });
+  out << ',';
+  WriteObject(out, "histograms", state.histograms,
+              [&](const MetricHistogram& histogram) {
+                const std::span<const double> edges{histogram.GetEdges()};
+                out << "{\"edges\":[";
+                for (std::size_t i{}; i < edges.size(); ++i) {
+                  out << (i > 0 ? "," : "") << edges[i];
+                }
+                out << "],\"buckets\":[";
+                for (std::size_t i{}; i <= edges.size(); ++i) {
+                  out << (i > 0 ? "," : "") << histogram.GetBucket(i);
+                }
+                out << "],\"count\":" << histogram.GetCount()
+                    << ",\"sum\":" << histogram.GetSum() << '}';
+              });
+  out << '}';
+}
+
+bool MetricsLog::Open(const std::string& path) {
+  file.open(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    BEP_LOG_ERROR(LogCategory::General,
+                  "Failed to open metrics log for writing: {}", path);
+    return false;
+  }
+  file << std::setprecision(9);
+  opened = std::chrono::steady_clock::now();
+  return true;
+}
+
+void MetricsLog::Write(std::uint32_t tick) {
+  if (!file) return;
+  const double seconds{std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - opened)
+                           .count()};
+  file << "{\"tick\":" << tick << ",\"seconds\":" << seconds
+       << ",\"metrics\":";
+  Metrics::WriteJson(file);
+  file << '}' << std::endl;
+}
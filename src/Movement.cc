@@ -1,46 +1,52 @@
 #include "Movement.hh"
 
+#include <cmath>
 #include <gsl/assert>
 
-#include "AnimationClip.hh"
 #include "Components/EntityManager.hh"
-#include "InputSystem.hh"
+#include "PhysicsUnits.hh"
 
-Movement::Movement(float moveSpeed, float stepsDelay, AudioClip stepsAudio) {
+Movement::Movement(const InputSystem& input, float moveSpeed, float stepsDelay,
+                   AudioClip stepsAudio)
+    : input(input) {
   this->moveSpeed = moveSpeed;
   this->stepsDelay = stepsDelay;
-  this->stepsAudio = stepsAudio;
+  this->stepsAudio = std::move(stepsAudio);
   stepsTimer = stepsDelay;
 }
 
 Movement::~Movement() {}
 
 void Movement::Initialize() {
-  animator = owner->GetComponent<AnimatorComponent>();
+  animationStates = owner->GetComponent<AnimationStateMachineComponent>();
   sprite = owner->GetComponent<SpriteComponent>();
   transform = owner->GetComponent<TransformComponent>();
   rigidbody = owner->GetComponent<RigidBodyComponent>();
   audioListener = owner->GetComponent<AudioListenerComponent>();
 
-  Expects(animator != nullptr);
+  Expects(animationStates != nullptr);
   Expects(sprite != nullptr);
   Expects(transform != nullptr);
   Expects(rigidbody != nullptr);
 
-  animator->AddAnimation("idle",
-                         AnimationClip("assets/animations/player/idle.json"));
-  animator->AddAnimation("walk",
-                         AnimationClip("assets/animations/player/walk.json"));
+  speedParameter = animationStates->GetParameter("speed");
+  moveX = input.FindAxis("moveX");
+  moveY = input.FindAxis("moveY");
 }
 
 void Movement::Update(float& deltaTime) {
-  Expects(animator != nullptr);
+  Expects(animationStates != nullptr);
   Expects(sprite != nullptr);
   Expects(transform != nullptr);
   Expects(rigidbody != nullptr);
-  sf::Vector2 direction = InputSystem::Axis() * moveSpeed;
+  const InputSnapshot& frameInput{input.GetSnapshot()};
+  const sf::Vector2f direction{
+      sf::Vector2f(frameInput.GetAxis(moveX), frameInput.GetAxis(moveY)) *
+      moveSpeed};
 
-  rigidbody->AddVelocity(b2Vec2(direction.x, direction.y));
+  rigidbody->AddVelocity(PhysicsUnits::ToMeters(direction));
+  animationStates->SetFloat(speedParameter,
+                            std::hypot(direction.x, direction.y));
 
   if (std::abs(direction.x) > 0 || std::abs(direction.y) > 0) {
     if (audioListener) {
@@ -50,8 +56,5 @@ void Movement::Update(float& deltaTime) {
         stepsTimer = 0.f;
       }
     }
-    animator->Play("walk");
-  } else {
-    animator->Play("idle");
   }
 }
@@ -0,0 +1,295 @@
+#include "MusicPlayer.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <gsl/assert>
+
+#include "Log.hh"
+
+namespace {
+
+static_assert((MusicPlayer::RING_FRAMES & (MusicPlayer::RING_FRAMES - 1)) == 0,
+              "RING_FRAMES must be a power of two");
+constexpr std::size_t RING_MASK{MusicPlayer::RING_FRAMES - 1};
+constexpr float SAMPLE_TO_FLOAT{1.f / 32768.f};
+// Skip top-ups smaller than this many source frames (~23 ms at 44.1 kHz)
+constexpr std::size_t MIN_DECODE_FRAMES{1024};
+constexpr std::size_t MAX_DECODE_CHANNELS{2};
+constexpr auto DECODER_POLL{std::chrono::milliseconds(5)};
+
+float FadeStepFor(float fadeSeconds) {
+  if (fadeSeconds <= 0.f) return 1.f;
+  return 1.f / (fadeSeconds * static_cast<float>(AudioMixer::SAMPLE_RATE));
+}
+
+}  // namespace
+
+MusicPlayer::MusicPlayer(AudioMixer& mixer)
+    : mixer(mixer), decodeBuffer(DECODE_FRAMES * MAX_DECODE_CHANNELS) {
+  for (Deck& deck : decks) {
+    deck.left.resize(RING_FRAMES);
+    deck.right.resize(RING_FRAMES);
+  }
+  mixer.AddSource(this, AudioBus::Music);
+  decoder = std::thread(&MusicPlayer::DecoderLoop, this);
+}
+
+MusicPlayer::~MusicPlayer() {
+  mixer.RemoveSource(this);
+  {
+    std::lock_guard lock{requestMutex};
+    quit = true;
+  }
+  requestReady.notify_one();
+  if (decoder.joinable()) decoder.join();
+}
+
+void MusicPlayer::Play(const std::string& path, float fadeSeconds, bool loop) {
+  {
+    std::lock_guard lock{requestMutex};
+    request = Request{path, fadeSeconds, loop, false};
+    track = path;
+  }
+  requestReady.notify_one();
+}
+
+void MusicPlayer::Stop(float fadeSeconds) {
+  {
+    std::lock_guard lock{requestMutex};
+    request = Request{{}, fadeSeconds, false, true};
+    track.clear();
+  }
+  requestReady.notify_one();
+}
+
+MusicStats MusicPlayer::GetStats() const {
+  MusicStats stats;
+  {
+    std::lock_guard lock{requestMutex};
+    stats.track = track;
+  }
+  for (const Deck& deck : decks) {
+    if (deck.state.load(std::memory_order_acquire) != DeckState::Playing) {
+      continue;
+    }
+    const std::size_t buffered{deck.writeIndex.load(std::memory_order_relaxed) -
+                               deck.readIndex.load(std::memory_order_relaxed)};
+    stats.bufferedSeconds =
+        std::max(stats.bufferedSeconds,
+                 static_cast<float>(buffered) / AudioMixer::SAMPLE_RATE);
+  }
+  stats.underruns = underruns.load(std::memory_order_relaxed);
+  stats.residentBytes = static_cast<std::int64_t>(
+      decks.size() * RING_FRAMES * 2 * sizeof(float) +
+      decodeBuffer.size() * sizeof(std::int16_t));
+  for (const Deck& deck : decks) {
+    stats.residentBytes += deck.sourceBytes.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void MusicPlayer::DecoderLoop() {
+  std::optional<Request> pending;
+  while (true) {
+    {
+      std::unique_lock lock{requestMutex};
+      requestReady.wait_for(lock, DECODER_POLL,
+                            [this] { return quit || request.has_value(); });
+      if (quit) return;
+      if (request) {
+        pending = std::move(request);
+        request.reset();
+      }
+    }
+    if (pending && Start(*pending)) pending.reset();
+    for (Deck& deck : decks) {
+      if (deck.state.load(std::memory_order_acquire) == DeckState::Playing) {
+        Fill(deck);
+      }
+    }
+  }
+}
+
+bool MusicPlayer::Start(const Request& next) {
+  if (next.stop) {
+    for (Deck& deck : decks) FadeOut(deck, next.fadeSeconds);
+    primary = -1;
+    return true;
+  }
+
+  Deck* idle{};
+  for (Deck& deck : decks) {
+    if (deck.state.load(std::memory_order_acquire) == DeckState::Idle) {
+      idle = &deck;
+      break;
+    }
+  }
+  if (!idle) {
+    // Both decks busy with an unfinished crossfade: cut the outgoing one and
+    // retry once the audio thread has released it
+    for (int i{}; i < static_cast<int>(decks.size()); ++i) {
+      if (i != primary) FadeOut(decks[i], 0.f);
+    }
+    return false;
+  }
+  if (!Open(*idle, next)) return true;
+
+  for (Deck& deck : decks) {
+    if (&deck != idle) FadeOut(deck, next.fadeSeconds);
+  }
+  primary = static_cast<int>(idle - decks.data());
+  idle->gain = next.fadeSeconds > 0.f ? 0.f : 1.f;
+  idle->targetGain.store(1.f, std::memory_order_relaxed);
+  idle->fadeStep.store(FadeStepFor(next.fadeSeconds),
+                       std::memory_order_relaxed);
+  idle->state.store(DeckState::Playing, std::memory_order_release);
+  return true;
+}
+
+bool MusicPlayer::Open(Deck& deck, const Request& next) {
+  // The previous track may still be streaming out of 'source'
+  deck.file.close();
+  // Loose tracks stream from disk in blocks rather than being read whole;
+  // pack entries open in place from the mapping
+  bool opened{};
+  if (AssetFiles::IsLoose(next.path)) {
+    deck.source = AssetData{};
+    opened = deck.file.openFromFile(next.path);
+  } else {
+    deck.source = AssetFiles::Read(next.path);
+    opened = deck.source && deck.file.openFromMemory(deck.source.GetData(),
+                                                     deck.source.GetSize());
+  }
+  deck.sourceBytes.store(
+      deck.source.IsMapped()
+          ? 0
+          : static_cast<std::int64_t>(deck.source.GetSize()),
+      std::memory_order_relaxed);
+  if (!opened) {
+    BEP_LOG_ERROR(LogCategory::Audio, "Failed to open music: {}", next.path);
+    return false;
+  }
+  deck.channels = deck.file.getChannelCount();
+  const unsigned sampleRate{deck.file.getSampleRate()};
+  if (deck.channels == 0 || deck.channels > MAX_DECODE_CHANNELS ||
+      sampleRate == 0) {
+    BEP_LOG_ERROR(LogCategory::Audio,
+                  "Unsupported music format ({} channels, {} Hz): {}",
+                  deck.channels, sampleRate, next.path);
+    deck.file.close();
+    return false;
+  }
+  deck.loop = next.loop;
+  deck.step = static_cast<double>(sampleRate) / AudioMixer::SAMPLE_RATE;
+  deck.phase = 0.0;
+  deck.primed = false;
+  deck.writeIndex.store(0, std::memory_order_relaxed);
+  deck.readIndex.store(0, std::memory_order_relaxed);
+  deck.endOfStream.store(false, std::memory_order_relaxed);
+  // Prefetch a full ring before the deck becomes audible
+  Fill(deck);
+  return true;
+}
+
+void MusicPlayer::Fill(Deck& deck) {
+  const std::size_t maxBlock{decodeBuffer.size() / deck.channels};
+  bool rewound{};
+  while (!deck.endOfStream.load(std::memory_order_relaxed)) {
+    std::size_t write{deck.writeIndex.load(std::memory_order_relaxed)};
+    const std::size_t free{
+        RING_FRAMES - (write - deck.readIndex.load(std::memory_order_acquire))};
+    // N source frames yield at most N / step + 1 output frames
+    if (free < 2) break;
+    const auto fits{static_cast<std::size_t>(
+        static_cast<double>(free - 1) * deck.step)};
+    const std::size_t block{std::min(maxBlock, fits)};
+    if (block < std::min(maxBlock, MIN_DECODE_FRAMES)) break;
+
+    const std::size_t frames{static_cast<std::size_t>(
+        deck.file.read(decodeBuffer.data(), block * deck.channels) /
+        deck.channels)};
+    if (frames == 0) {
+      // Looping continues from the first frame with the resampler state
+      // intact, so the seam is gapless; a second empty read means the file
+      // has no samples at all
+      if (!deck.loop || rewound) {
+        deck.endOfStream.store(true, std::memory_order_release);
+        break;
+      }
+      deck.file.seek(std::uint64_t{0});
+      rewound = true;
+      continue;
+    }
+    rewound = false;
+
+    // Linear resampling to the mixer rate
+    for (std::size_t f{}; f < frames; ++f) {
+      const std::int16_t* frame{decodeBuffer.data() + f * deck.channels};
+      const float left{frame[0] * SAMPLE_TO_FLOAT};
+      const float right{deck.channels > 1 ? frame[1] * SAMPLE_TO_FLOAT : left};
+      if (!deck.primed) {
+        deck.previous[0] = left;
+        deck.previous[1] = right;
+        deck.primed = true;
+        continue;
+      }
+      while (deck.phase < 1.0) {
+        const auto t{static_cast<float>(deck.phase)};
+        const std::size_t slot{write & RING_MASK};
+        deck.left[slot] = deck.previous[0] + (left - deck.previous[0]) * t;
+        deck.right[slot] = deck.previous[1] + (right - deck.previous[1]) * t;
+        ++write;
+        deck.phase += deck.step;
+      }
+      deck.phase -= 1.0;
+      deck.previous[0] = left;
+      deck.previous[1] = right;
+    }
+    deck.writeIndex.store(write, std::memory_order_release);
+  }
+}
+
+void MusicPlayer::FadeOut(Deck& deck, float fadeSeconds) {
+  deck.fadeStep.store(FadeStepFor(fadeSeconds), std::memory_order_relaxed);
+  deck.targetGain.store(0.f, std::memory_order_relaxed);
+}
+
+void MusicPlayer::Mix(float* left, float* right, std::size_t frames,
+                      float gain) {
+  for (Deck& deck : decks) {
+    if (deck.state.load(std::memory_order_acquire) != DeckState::Playing) {
+      continue;
+    }
+    // Read the end flag first so the write index can't be older than it
+    const bool endOfStream{deck.endOfStream.load(std::memory_order_acquire)};
+    const std::size_t read{deck.readIndex.load(std::memory_order_relaxed)};
+    const std::size_t available{
+        deck.writeIndex.load(std::memory_order_acquire) - read};
+    const std::size_t count{std::min(available, frames)};
+    const float target{deck.targetGain.load(std::memory_order_relaxed)};
+    const float fadeStep{deck.fadeStep.load(std::memory_order_relaxed)};
+
+    float deckGain{deck.gain};
+    for (std::size_t i{}; i < count; ++i) {
+      deckGain = deckGain < target ? std::min(target, deckGain + fadeStep)
+                                   : std::max(target, deckGain - fadeStep);
+      const std::size_t slot{(read + i) & RING_MASK};
+      left[i] += deck.left[slot] * deckGain * gain;
+      right[i] += deck.right[slot] * deckGain * gain;
+    }
+    // Keep fading through an underrun so a starved deck still drains
+    const float missed{static_cast<float>(frames - count) * fadeStep};
+    deckGain = deckGain < target ? std::min(target, deckGain + missed)
+                                 : std::max(target, deckGain - missed);
+    deck.gain = deckGain;
+    deck.readIndex.store(read + count, std::memory_order_release);
+
+    const bool drained{endOfStream && count == available};
+    if (count < frames && !drained) {
+      underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (drained || (target == 0.f && deckGain == 0.f)) {
+      deck.state.store(DeckState::Idle, std::memory_order_release);
+    }
+  }
+}
@@ -0,0 +1,416 @@
+#include "PartitionedPhysicsWorld.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <gsl/assert>
+#include <gsl/narrow>
+
+#include "PhysicsWarmup.hh"
+
+void PartitionedPhysicsWorld::CellContactListener::BeginContact(
+    b2Contact* contact) {
+  events.push_back(PhysicsContactEvent{
+      PhysicsContactEvent::Type::Begin,
+      contact->GetFixtureA()->GetBody()->GetUserData().pointer,
+      contact->GetFixtureB()->GetBody()->GetUserData().pointer});
+}
+
+void PartitionedPhysicsWorld::CellContactListener::EndContact(
+    b2Contact* contact) {
+  events.push_back(PhysicsContactEvent{
+      PhysicsContactEvent::Type::End,
+      contact->GetFixtureA()->GetBody()->GetUserData().pointer,
+      contact->GetFixtureB()->GetBody()->GetUserData().pointer});
+}
+
+PartitionedPhysicsWorld::PartitionedPhysicsWorld(const b2Vec2& gravity,
+                                                 const b2Vec2& worldOrigin,
+                                                 const b2Vec2& worldSize,
+                                                 float cellSize,
+                                                 float ghostMargin,
+                                                 JobSystem& jobs)
+    : jobs(jobs),
+      origin(worldOrigin),
+      cellSize(cellSize),
+      ghostMargin(ghostMargin) {
+  Expects(cellSize > 0.f);
+  Expects(ghostMargin >= 0.f && ghostMargin < cellSize);
+  Expects(worldSize.x > 0.f && worldSize.y > 0.f);
+  PhysicsWarmup::WarmContactRegisters();
+
+  cols = std::max(1, static_cast<int>(std::ceil(worldSize.x / cellSize)));
+  rows = std::max(1, static_cast<int>(std::ceil(worldSize.y / cellSize)));
+  cells.resize(static_cast<std::size_t>(cols * rows));
+  for (auto& cell : cells) {
+    cell.world = std::make_unique<b2World>(gravity);
+    cell.world->SetContactListener(&cell.listener);
+  }
+}
+
+PartitionedPhysicsWorld::~PartitionedPhysicsWorld() {
+  for (auto& cell : cells) {
+    cell.world->SetContactListener(nullptr);
+  }
+}
+
+int PartitionedPhysicsWorld::CellAt(const b2Vec2& position) const {
+  const int x{std::clamp(
+      static_cast<int>(std::floor((position.x - origin.x) / cellSize)), 0,
+      cols - 1)};
+  const int y{std::clamp(
+      static_cast<int>(std::floor((position.y - origin.y) / cellSize)), 0,
+      rows - 1)};
+  return y * cols + x;
+}
+
+b2AABB PartitionedPhysicsWorld::ComputeAABB(b2Body& body) const {
+  b2AABB bounds;
+  bounds.lowerBound = body.GetPosition();
+  bounds.upperBound = body.GetPosition();
+  for (b2Fixture* f = body.GetFixtureList(); f; f = f->GetNext()) {
+    for (int32 child{}; child < f->GetShape()->GetChildCount(); ++child) {
+      b2AABB childBounds;
+      f->GetShape()->ComputeAABB(&childBounds, body.GetTransform(), child);
+      bounds.Combine(childBounds);
+    }
+  }
+  return bounds;
+}
+
+b2Body* PartitionedPhysicsWorld::CloneBody(b2World& target, b2Body& source,
+                                           b2BodyType type) const {
+  b2BodyDef bodyDef;
+  bodyDef.type = type;
+  bodyDef.position = source.GetPosition();
+  bodyDef.angle = source.GetAngle();
+  bodyDef.linearVelocity = source.GetLinearVelocity();
+  bodyDef.angularVelocity = source.GetAngularVelocity();
+  bodyDef.linearDamping = source.GetLinearDamping();
+  bodyDef.angularDamping = source.GetAngularDamping();
+  bodyDef.allowSleep = source.IsSleepingAllowed();
+  bodyDef.awake = source.IsAwake();
+  bodyDef.fixedRotation = source.IsFixedRotation();
+  bodyDef.bullet = source.IsBullet();
+  bodyDef.enabled = source.IsEnabled();
+  bodyDef.gravityScale = source.GetGravityScale();
+  bodyDef.userData = source.GetUserData();
+  b2Body* clone{target.CreateBody(&bodyDef)};
+
+  for (b2Fixture* f = source.GetFixtureList(); f; f = f->GetNext()) {
+    b2FixtureDef fixtureDef;
+    fixtureDef.shape = f->GetShape();
+    fixtureDef.friction = f->GetFriction();
+    fixtureDef.restitution = f->GetRestitution();
+    fixtureDef.restitutionThreshold = f->GetRestitutionThreshold();
+    fixtureDef.density = f->GetDensity();
+    fixtureDef.isSensor = f->IsSensor();
+    fixtureDef.filter = f->GetFilterData();
+    fixtureDef.userData = f->GetUserData();
+    clone->CreateFixture(&fixtureDef);
+  }
+  return clone;
+}
+
+PartitionedPhysicsWorld::BodyId PartitionedPhysicsWorld::CreateBody(
+    const b2BodyDef& bodyDef, const b2FixtureDef& fixtureDef) {
+  BodyId id;
+  if (!freeIds.empty()) {
+    id = freeIds.back();
+    freeIds.pop_back();
+  } else {
+    id = gsl::narrow_cast<BodyId>(records.size());
+    records.emplace_back();
+  }
+
+  BodyRecord& record{records[id]};
+  record.cell = CellAt(bodyDef.position);
+  record.body = cells[record.cell].world->CreateBody(&bodyDef);
+  record.body->CreateFixture(&fixtureDef);
+  record.ghostsDirty = true;
+  SyncGhosts(record);
+  return id;
+}
+
+void PartitionedPhysicsWorld::DestroyGhosts(BodyRecord& record) {
+  for (const Ghost& ghost : record.ghosts) {
+    cells[ghost.cell].world->DestroyBody(ghost.body);
+    --ghostCount;
+  }
+  record.ghosts.clear();
+}
+
+void PartitionedPhysicsWorld::DestroyBody(BodyId id) {
+  Expects(id < records.size());
+  BodyRecord& record{records[id]};
+  if (!record.body) return;
+  const std::uintptr_t userData{record.body->GetUserData().pointer};
+
+  DestroyGhosts(record);
+  cells[record.cell].world->DestroyBody(record.body);
+  record.body = nullptr;
+  record.cell = -1;
+  freeIds.push_back(id);
+
+  // The owner is going away: drop its pending and tracked contacts so no
+  // event outlives it.
+  auto involves = [userData](const PhysicsContactEvent& e) {
+    return e.userDataA == userData || e.userDataB == userData;
+  };
+  for (auto& cell : cells) {
+    std::erase_if(cell.listener.events, involves);
+  }
+  std::erase_if(pairs, [userData](const auto& entry) {
+    return entry.first.a == userData || entry.first.b == userData;
+  });
+}
+
+b2Body* PartitionedPhysicsWorld::GetBody(BodyId id) const {
+  return id < records.size() ? records[id].body : nullptr;
+}
+
+void PartitionedPhysicsWorld::SetEnabled(BodyId id, bool enabled) {
+  Expects(id < records.size());
+  BodyRecord& record{records[id]};
+  if (!record.body || record.body->IsEnabled() == enabled) return;
+  record.body->SetEnabled(enabled);
+  if (enabled) {
+    record.ghostsDirty = true;
+    SyncGhosts(record);
+  } else {
+    DestroyGhosts(record);
+  }
+}
+
+void PartitionedPhysicsWorld::SetTransform(BodyId id, const b2Vec2& position,
+                                           float angle) {
+  Expects(id < records.size());
+  BodyRecord& record{records[id]};
+  if (!record.body) return;
+  record.body->SetTransform(position, angle);
+  DestroyGhosts(record);
+  const int target{CellAt(position)};
+  if (target != record.cell) {
+    b2Body* moved{CloneBody(*cells[target].world, *record.body,
+                            record.body->GetType())};
+    cells[record.cell].world->DestroyBody(record.body);
+    record.body = moved;
+    record.cell = target;
+  }
+  record.ghostsDirty = true;
+  if (record.body->IsEnabled()) SyncGhosts(record);
+}
+
+void PartitionedPhysicsWorld::SyncGhosts(BodyRecord& record) {
+  b2Body& body{*record.body};
+  const bool isStatic{body.GetType() == b2_staticBody};
+  if (isStatic && !record.ghostsDirty) return;
+  record.ghostsDirty = false;
+
+  b2AABB bounds{ComputeAABB(body)};
+  const b2Vec2 margin{ghostMargin, ghostMargin};
+  bounds.lowerBound -= margin;
+  bounds.upperBound += margin;
+  const int first{CellAt(bounds.lowerBound)};
+  const int last{CellAt(bounds.upperBound)};
+  const int x0{first % cols}, y0{first / cols};
+  const int x1{last % cols}, y1{last / cols};
+
+  // Drop proxies that are no longer near the body
+  for (std::size_t i{record.ghosts.size()}; i-- > 0;) {
+    const Ghost ghost{record.ghosts[i]};
+    const int gx{ghost.cell % cols}, gy{ghost.cell / cols};
+    if (ghost.cell == record.cell || gx < x0 || gx > x1 || gy < y0 ||
+        gy > y1) {
+      cells[ghost.cell].world->DestroyBody(ghost.body);
+      record.ghosts[i] = record.ghosts.back();
+      record.ghosts.pop_back();
+      --ghostCount;
+    }
+  }
+
+  for (int y{y0}; y <= y1; ++y) {
+    for (int x{x0}; x <= x1; ++x) {
+      const int cell{y * cols + x};
+      if (cell == record.cell) continue;
+      auto it = std::find_if(record.ghosts.begin(), record.ghosts.end(),
+                             [cell](const Ghost& g) { return g.cell == cell; });
+      if (it == record.ghosts.end()) {
+        record.ghosts.push_back(Ghost{
+            cell, CloneBody(*cells[cell].world, body,
+                            isStatic ? b2_staticBody : b2_kinematicBody)});
+        ++ghostCount;
+      } else if (body.IsAwake()) {
+        it->body->SetTransform(body.GetPosition(), body.GetAngle());
+        it->body->SetLinearVelocity(body.GetLinearVelocity());
+        it->body->SetAngularVelocity(body.GetAngularVelocity());
+      } else if (it->body->IsAwake()) {
+        it->body->SetAwake(false);
+      }
+    }
+  }
+}
+
+void PartitionedPhysicsWorld::MigrateBodies() {
+  for (BodyRecord& record : records) {
+    if (!record.body || record.body->GetType() == b2_staticBody ||
+        !record.body->IsEnabled()) {
+      continue;
+    }
+    const int target{CellAt(record.body->GetPosition())};
+    if (target == record.cell) continue;
+
+    // The proxy already sitting in the target cell is replaced by the body
+    auto ghost = std::find_if(
+        record.ghosts.begin(), record.ghosts.end(),
+        [target](const Ghost& g) { return g.cell == target; });
+    if (ghost != record.ghosts.end()) {
+      cells[target].world->DestroyBody(ghost->body);
+      *ghost = record.ghosts.back();
+      record.ghosts.pop_back();
+      --ghostCount;
+    }
+
+    b2Body* moved{CloneBody(*cells[target].world, *record.body,
+                            record.body->GetType())};
+    cells[record.cell].world->DestroyBody(record.body);
+    record.body = moved;
+    record.cell = target;
+    // Leave a proxy behind right away so the old cell keeps colliding
+    SyncGhosts(record);
+  }
+}
+
+void PartitionedPhysicsWorld::MergeContactEvents() {
+  contactEvents.clear();
+
+  // A pair can be reported by several cells (body vs proxy on both sides of
+  // a seam) and briefly lost during a handoff; count reports per pair and
+  // only publish changes of the combined state.
+  for (auto& cell : cells) {
+    for (const PhysicsContactEvent& e : cell.listener.events) {
+      const PairKey key{std::min(e.userDataA, e.userDataB),
+                        std::max(e.userDataA, e.userDataB)};
+      PairState& state{pairs[key]};
+      if (!state.inBatch) {
+        state.inBatch = true;
+        state.batchStart = state.touching;
+        state.peaked = false;
+        batchPairs.push_back(key);
+      }
+      if (state.touching == 0 && !state.pendingEnd) state.first = e;
+      state.touching = std::max(
+          0, state.touching + (e.type == PhysicsContactEvent::Type::Begin
+                                   ? 1
+                                   : -1));
+      if (state.touching > 0) state.peaked = true;
+    }
+    cell.listener.events.clear();
+  }
+
+  std::vector<PairKey> nextDeferredEnds;
+  for (const PairKey& key : batchPairs) {
+    PairState& state{pairs[key]};
+    state.inBatch = false;
+    PhysicsContactEvent begin{state.first};
+    begin.type = PhysicsContactEvent::Type::Begin;
+
+    if (state.batchStart == 0 && state.touching > 0) {
+      if (state.pendingEnd) {
+        state.pendingEnd = false;  // lost and found again: a handoff
+      } else {
+        contactEvents.push_back(begin);
+      }
+    } else if (state.batchStart > 0 && state.touching == 0) {
+      state.pendingEnd = true;
+      nextDeferredEnds.push_back(key);
+    } else if (state.touching == 0 && state.peaked && !state.pendingEnd) {
+      contactEvents.push_back(begin);
+      state.pendingEnd = true;
+      nextDeferredEnds.push_back(key);
+    }
+  }
+  batchPairs.clear();
+
+  // End events are published one Step late so a handoff (contact destroyed
+  // in one cell, recreated in the next) doesn't look like End + Begin.
+  for (const PairKey& key : deferredEnds) {
+    auto it = pairs.find(key);
+    if (it == pairs.end() || !it->second.pendingEnd) continue;
+    if (std::find(nextDeferredEnds.begin(), nextDeferredEnds.end(), key) !=
+        nextDeferredEnds.end()) {
+      continue;
+    }
+    PhysicsContactEvent end{it->second.first};
+    end.type = PhysicsContactEvent::Type::End;
+    contactEvents.push_back(end);
+    it->second.pendingEnd = false;
+  }
+  deferredEnds = std::move(nextDeferredEnds);
+
+  std::erase_if(pairs, [](const auto& entry) {
+    return entry.second.touching == 0 && !entry.second.pendingEnd;
+  });
+}
+
+void PartitionedPhysicsWorld::Step(float timeStep, int velocityIterations,
+                                   int positionIterations) {
+  for (BodyRecord& record : records) {
+    if (record.body && record.body->IsEnabled()) SyncGhosts(record);
+  }
+
+  jobs.ParallelFor(cells.size(), [&](std::size_t i) {
+    cells[i].world->Step(timeStep, velocityIterations, positionIterations);
+  });
+
+  MigrateBodies();
+  MergeContactEvents();
+}
+
+const std::vector<PhysicsContactEvent>&
+PartitionedPhysicsWorld::GetContactEvents() const {
+  return contactEvents;
+}
+
+void PartitionedPhysicsWorld::SetDebugDraw(b2Draw* debugDraw) {
+  for (auto& cell : cells) {
+    cell.world->SetDebugDraw(debugDraw);
+  }
+}
+
+void PartitionedPhysicsWorld::DebugDraw() {
+  for (auto& cell : cells) {
+    cell.world->DebugDraw();
+  }
+}
+
+int PartitionedPhysicsWorld::GetCellCount() const {
+  return gsl::narrow_cast<int>(cells.size());
+}
+
+int PartitionedPhysicsWorld::GetBodyCount() const {
+  return gsl::narrow_cast<int>(records.size() - freeIds.size());
+}
+
+int PartitionedPhysicsWorld::GetGhostCount() const { return ghostCount; }
+
+int PartitionedPhysicsWorld::GetContactCount() const {
+  int contacts{};
+  for (const Cell& cell : cells) contacts += cell.world->GetContactCount();
+  return contacts;
+}
+
+b2Profile PartitionedPhysicsWorld::GetProfile() const {
+  b2Profile total{};
+  for (const Cell& cell : cells) {
+    const b2Profile& profile{cell.world->GetProfile()};
+    total.step += profile.step;
+    total.collide += profile.collide;
+    total.solve += profile.solve;
+    total.solveInit += profile.solveInit;
+    total.solveVelocity += profile.solveVelocity;
+    total.solvePosition += profile.solvePosition;
+    total.broadphase += profile.broadphase;
+    total.solveTOI += profile.solveTOI;
+  }
+  return total;
+}
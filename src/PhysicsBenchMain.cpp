@@ -0,0 +1,351 @@
+// Physics solver benchmark: runs the same pixel-space scenes with the legacy
+// 1px == 1m mapping and with the PhysicsUnits scaling used by the game, and
+// reports solver time and contact stability for both. A large open map is
+// then stepped as one b2World and as a PartitionedPhysicsWorld on pools of
+// increasing size.
+//
+// Usage: PhysicsBench [bodies] [steps]
+#include <box2d/box2d.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Constants.hh"
+#include "EngineAllocator.hh"
+#include "JobSystem.hh"
+#include "PartitionedPhysicsWorld.hh"
+#include "PhysicsUnits.hh"
+
+namespace {
+
+constexpr float TIME_STEP = 1.f / 60.f;
+constexpr float BOX_SIZE_PX =
+    GameConstants::TILE_SIZE * GameConstants::TILE_SCALE;
+// Speed bodies are kicked to, in pixels/s; about a walking character's.
+// The game's own speeds live in its prefabs.
+constexpr float KICK_SPEED_PX = 200.f;
+
+struct SceneResult {
+  double wallMs{};           // average wall time per Step
+  double solveMs{};          // average b2Profile::solve
+  double solveTOIMs{};       // average b2Profile::solveTOI
+  float maxPenetrationPx{};  // deepest contact overlap seen, in pixels
+  float residualSpeedPx{};   // mean |v| at the end, in pixels/s
+  int awakeBodies{};
+};
+
+b2Body* CreateBox(b2World& world, b2BodyType type, sf::Vector2f posPx,
+                  sf::Vector2f sizePx) {
+  b2BodyDef bodyDef;
+  bodyDef.type = type;
+  bodyDef.position = PhysicsUnits::ToMeters(posPx);
+  bodyDef.fixedRotation = true;
+  b2Body* body = world.CreateBody(&bodyDef);
+
+  const b2Vec2 halfExtents{PhysicsUnits::ToMeters(sizePx * 0.5f)};
+  b2PolygonShape shape;
+  shape.SetAsBox(halfExtents.x - b2_polygonRadius,
+                 halfExtents.y - b2_polygonRadius);
+  b2FixtureDef fixtureDef;
+  fixtureDef.shape = &shape;
+  fixtureDef.density = 1.f;
+  fixtureDef.friction = 0.2f;
+  body->CreateFixture(&fixtureDef);
+  return body;
+}
+
+void CreateWalls(b2World& world, float arenaPx) {
+  const float thickness{BOX_SIZE_PX};
+  const float half{arenaPx * 0.5f};
+  CreateBox(world, b2_staticBody, {half, -thickness * 0.5f},
+            {arenaPx + thickness * 2.f, thickness});
+  CreateBox(world, b2_staticBody, {half, arenaPx + thickness * 0.5f},
+            {arenaPx + thickness * 2.f, thickness});
+  CreateBox(world, b2_staticBody, {-thickness * 0.5f, half},
+            {thickness, arenaPx});
+  CreateBox(world, b2_staticBody, {arenaPx + thickness * 0.5f, half},
+            {thickness, arenaPx});
+}
+
+float MaxPenetrationPx(b2World& world) {
+  float deepest{};
+  for (b2Contact* c = world.GetContactList(); c; c = c->GetNext()) {
+    if (!c->IsTouching()) continue;
+    b2WorldManifold manifold;
+    c->GetWorldManifold(&manifold);
+    for (int i{}; i < c->GetManifold()->pointCount; ++i) {
+      deepest = std::max(deepest,
+                         -PhysicsUnits::ToPixels(manifold.separations[i]));
+    }
+  }
+  return deepest;
+}
+
+void Accumulate(SceneResult& result, b2World& world, double wallMs) {
+  const b2Profile& profile{world.GetProfile()};
+  result.wallMs += wallMs;
+  result.solveMs += profile.solve;
+  result.solveTOIMs += profile.solveTOI;
+  result.maxPenetrationPx =
+      std::max(result.maxPenetrationPx, MaxPenetrationPx(world));
+}
+
+void Finish(SceneResult& result, b2World& world, int steps) {
+  result.wallMs /= steps;
+  result.solveMs /= steps;
+  result.solveTOIMs /= steps;
+  float speed{};
+  int count{};
+  for (b2Body* b = world.GetBodyList(); b; b = b->GetNext()) {
+    if (b->GetType() != b2_dynamicBody) continue;
+    speed += PhysicsUnits::ToPixels(b->GetLinearVelocity().Length());
+    if (b->IsAwake()) ++result.awakeBodies;
+    ++count;
+  }
+  result.residualSpeedPx = count ? speed / count : 0.f;
+}
+
+double StepTimed(b2World& world) {
+  auto start = std::chrono::steady_clock::now();
+  world.Step(TIME_STEP, GameConstants::PHYSICS_VELOCITY_ITERATIONS,
+             GameConstants::PHYSICS_POSITION_ITERATIONS);
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Top-down scene like the game: zero gravity, bodies driven at player speed
+// into each other and the arena walls.
+SceneResult RunArena(float ppm, int bodies, int steps) {
+  PhysicsUnits::SetPixelsPerMeter(ppm);
+  b2World world(b2Vec2(0.f, 0.f));
+  const int perRow{static_cast<int>(std::ceil(std::sqrt(bodies)))};
+  const float arenaPx{perRow * BOX_SIZE_PX * 2.f};
+  CreateWalls(world, arenaPx);
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dir(-1.f, 1.f);
+  std::vector<b2Body*> dynamic;
+  dynamic.reserve(bodies);
+  for (int i{}; i < bodies; ++i) {
+    sf::Vector2f pos{(i % perRow + 0.75f) * BOX_SIZE_PX * 2.f,
+                     (i / perRow + 0.75f) * BOX_SIZE_PX * 2.f};
+    dynamic.push_back(
+        CreateBox(world, b2_dynamicBody, pos, {BOX_SIZE_PX, BOX_SIZE_PX}));
+  }
+
+  SceneResult result;
+  for (int s{}; s < steps; ++s) {
+    if (s % 30 == 0) {
+      for (b2Body* body : dynamic) {
+        sf::Vector2f v{dir(rng), dir(rng)};
+        body->SetLinearVelocity(
+            PhysicsUnits::ToMeters(v * KICK_SPEED_PX));
+      }
+    }
+    Accumulate(result, world, StepTimed(world));
+  }
+  Finish(result, world, steps);
+  return result;
+}
+
+// Columns of boxes resting on the floor under gravity; measures how well the
+// solver settles stacked contacts (residual speed, bodies left awake).
+SceneResult RunStack(float ppm, int bodies, int steps) {
+  PhysicsUnits::SetPixelsPerMeter(ppm);
+  const float gravityPx{9.8f * BOX_SIZE_PX};
+  b2World world(PhysicsUnits::ToMeters(sf::Vector2f(0.f, gravityPx)));
+  const int height{10};
+  const int columns{std::max(1, bodies / height)};
+  const float arenaPx{columns * BOX_SIZE_PX * 1.5f + BOX_SIZE_PX};
+  CreateWalls(world, arenaPx);
+
+  for (int c{}; c < columns; ++c) {
+    for (int h{}; h < height; ++h) {
+      sf::Vector2f pos{(c * 1.5f + 1.f) * BOX_SIZE_PX,
+                       arenaPx - (h + 0.5f) * BOX_SIZE_PX * 1.01f};
+      CreateBox(world, b2_dynamicBody, pos, {BOX_SIZE_PX, BOX_SIZE_PX});
+    }
+  }
+
+  SceneResult result;
+  for (int s{}; s < steps; ++s) {
+    Accumulate(result, world, StepTimed(world));
+  }
+  Finish(result, world, steps);
+  return result;
+}
+
+// Sparse top-down map many cells wide: every body wanders at player speed, so
+// there is a steady flow of handoffs and seam contacts. Positions in meters.
+constexpr float LARGE_MAP_SPACING = 3.f;
+
+std::vector<b2Vec2> LargeMapLayout(int bodies) {
+  const int perRow{static_cast<int>(std::ceil(std::sqrt(bodies)))};
+  std::vector<b2Vec2> positions;
+  positions.reserve(bodies);
+  for (int i{}; i < bodies; ++i) {
+    positions.emplace_back((i % perRow + 0.5f) * LARGE_MAP_SPACING,
+                           (i / perRow + 0.5f) * LARGE_MAP_SPACING);
+  }
+  return positions;
+}
+
+b2Vec2 RandomVelocity(std::mt19937& rng) {
+  std::uniform_real_distribution<float> dir(-1.f, 1.f);
+  sf::Vector2f v{dir(rng), dir(rng)};
+  return PhysicsUnits::ToMeters(v * KICK_SPEED_PX);
+}
+
+void LargeMapDefs(const b2Vec2& position, b2BodyDef& bodyDef,
+                  b2PolygonShape& shape, b2FixtureDef& fixtureDef) {
+  bodyDef.type = b2_dynamicBody;
+  bodyDef.position = position;
+  bodyDef.fixedRotation = true;
+  shape.SetAsBox(0.5f - b2_polygonRadius, 0.5f - b2_polygonRadius);
+  fixtureDef.shape = &shape;
+  fixtureDef.density = 1.f;
+  fixtureDef.friction = 0.2f;
+}
+
+struct LargeMapResult {
+  double wallMs{};
+  int contactEvents{};
+  int ghosts{};
+};
+
+LargeMapResult RunLargeMapSingle(int bodies, int steps) {
+  b2World world(b2Vec2(0.f, 0.f));
+  std::vector<b2Body*> dynamic;
+  for (const b2Vec2& position : LargeMapLayout(bodies)) {
+    b2BodyDef bodyDef;
+    b2PolygonShape shape;
+    b2FixtureDef fixtureDef;
+    LargeMapDefs(position, bodyDef, shape, fixtureDef);
+    dynamic.push_back(world.CreateBody(&bodyDef));
+    dynamic.back()->CreateFixture(&fixtureDef);
+  }
+
+  std::mt19937 rng(1234);
+  LargeMapResult result;
+  for (int s{}; s < steps; ++s) {
+    if (s % 30 == 0) {
+      for (b2Body* body : dynamic) body->SetLinearVelocity(RandomVelocity(rng));
+    }
+    result.wallMs += StepTimed(world);
+  }
+  result.wallMs /= steps;
+  return result;
+}
+
+LargeMapResult RunLargeMapPartitioned(int bodies, int steps,
+                                      unsigned workers) {
+  const std::vector<b2Vec2> layout{LargeMapLayout(bodies)};
+  const float extent{layout.back().y + LARGE_MAP_SPACING};
+  JobSystem jobs(workers);
+  PartitionedPhysicsWorld world(b2Vec2(0.f, 0.f), b2Vec2(0.f, 0.f),
+                                b2Vec2(extent, extent),
+                                GameConstants::PHYSICS_CELL_SIZE,
+                                GameConstants::PHYSICS_GHOST_MARGIN, jobs);
+  std::vector<PartitionedPhysicsWorld::BodyId> dynamic;
+  for (std::size_t i{}; i < layout.size(); ++i) {
+    b2BodyDef bodyDef;
+    b2PolygonShape shape;
+    b2FixtureDef fixtureDef;
+    LargeMapDefs(layout[i], bodyDef, shape, fixtureDef);
+    bodyDef.userData.pointer = i + 1;  // events are keyed by user data
+    dynamic.push_back(world.CreateBody(bodyDef, fixtureDef));
+  }
+
+  std::mt19937 rng(1234);
+  LargeMapResult result;
+  for (int s{}; s < steps; ++s) {
+    if (s % 30 == 0) {
+      for (auto id : dynamic) {
+        world.GetBody(id)->SetLinearVelocity(RandomVelocity(rng));
+      }
+    }
+    auto start = std::chrono::steady_clock::now();
+    world.Step(TIME_STEP, GameConstants::PHYSICS_VELOCITY_ITERATIONS,
+               GameConstants::PHYSICS_POSITION_ITERATIONS);
+    auto end = std::chrono::steady_clock::now();
+    result.wallMs +=
+        std::chrono::duration<double, std::milli>(end - start).count();
+    result.contactEvents +=
+        static_cast<int>(world.GetContactEvents().size());
+  }
+  result.wallMs /= steps;
+  result.ghosts = world.GetGhostCount();
+  return result;
+}
+
+void PrintLargeMap(const std::string& label, const LargeMapResult& r) {
+  std::cout << std::left << std::setw(24) << label << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << r.wallMs
+            << std::setw(10) << r.contactEvents << std::setw(8) << r.ghosts
+            << std::endl;
+}
+
+void Print(const std::string& label, const SceneResult& r) {
+  std::cout << std::left << std::setw(24) << label << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << r.wallMs
+            << std::setw(10) << r.solveMs << std::setw(10) << r.solveTOIMs
+            << std::setprecision(2) << std::setw(12) << r.maxPenetrationPx
+            << std::setw(12) << r.residualSpeedPx << std::setw(8)
+            << r.awakeBodies << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int bodies{argc > 1 ? std::max(1, std::atoi(argv[1])) : 400};
+  const int steps{argc > 2 ? std::max(1, std::atoi(argv[2])) : 600};
+  const float legacyPpm{1.f};
+  const float scaledPpm{GameConstants::PIXELS_PER_METER};
+
+  std::cout << "PhysicsBench: " << bodies << " bodies, " << steps
+            << " steps of " << TIME_STEP << "s" << std::endl;
+  std::cout << std::left << std::setw(24) << "scene" << std::right
+            << std::setw(10) << "step ms" << std::setw(10) << "solve"
+            << std::setw(10) << "toi" << std::setw(12) << "max pen px"
+            << std::setw(12) << "rest px/s" << std::setw(8) << "awake"
+            << std::endl;
+
+  const std::string legacy{" 1 px/m (legacy)"};
+  const std::string scaled{" " + std::to_string(static_cast<int>(scaledPpm)) +
+                           " px/m"};
+  Print("arena" + legacy, RunArena(legacyPpm, bodies, steps));
+  Print("arena" + scaled, RunArena(scaledPpm, bodies, steps));
+  Print("stack" + legacy, RunStack(legacyPpm, bodies, steps));
+  Print("stack" + scaled, RunStack(scaledPpm, bodies, steps));
+
+  const int largeBodies{bodies * 8};
+  PhysicsUnits::SetPixelsPerMeter(scaledPpm);
+  std::cout << std::endl
+            << "large map: " << largeBodies << " bodies" << std::endl;
+  std::cout << std::left << std::setw(24) << "world" << std::right
+            << std::setw(10) << "step ms" << std::setw(10) << "events"
+            << std::setw(8) << "ghosts" << std::endl;
+  PrintLargeMap("single b2World", RunLargeMapSingle(largeBodies, steps));
+  const unsigned maxWorkers{JobSystem::DefaultWorkerCount()};
+  for (unsigned workers{};; workers = workers ? workers * 2 : 1) {
+    workers = std::min(workers, maxWorkers);
+    PrintLargeMap("partitioned " + std::to_string(workers + 1) + " threads",
+                  RunLargeMapPartitioned(largeBodies, steps, workers));
+    if (workers == maxWorkers) break;
+  }
+
+  const MemorySnapshot mem{EngineAllocator::GetSnapshot(MemoryTag::Physics)};
+  std::cout << "physics heap: peak " << mem.peakBytes / 1024 << " KB, "
+            << mem.allocations << " allocations" << std::endl;
+
+  PhysicsUnits::SetPixelsPerMeter(scaledPpm);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+#include "PrefabLibrary.hh"
+
+#include <gsl/narrow>
+
+#include "AnimationLibrary.hh"
+#include "AssetFiles.hh"
+#include "Log.hh"
+#include "TextureCache.hh"
+#include "json/json.h"
+
+namespace {
+
+bool ParseBodyType(const std::string& text, b2BodyType& type) {
+  static const std::pair<const char*, b2BodyType> types[]{
+      {"static", b2_staticBody},
+      {"dynamic", b2_dynamicBody},
+      {"kinematic", b2_kinematicBody}};
+  for (const auto& [name, value] : types) {
+    if (text == name) {
+      type = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Resolves everything 'json' names; false (and logged) if it is invalid
+bool Compile(const Json::Value& json, const std::string& path,
+             Prefab& prefab) {
+  const Json::Value& transform{json["transform"]};
+  if (!transform.isObject()) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Prefab '{}' in {} has no transform",
+                  prefab.name, path);
+    return false;
+  }
+  prefab.width = transform["width"].asFloat();
+  prefab.height = transform["height"].asFloat();
+  prefab.scale = transform.get("scale", 1.f).asFloat();
+  const sf::Vector2i frameSize{gsl::narrow_cast<int>(prefab.width),
+                               gsl::narrow_cast<int>(prefab.height)};
+
+  if (const Json::Value& sprite{json["sprite"]}; sprite.isObject()) {
+    prefab.sprite.emplace();
+    prefab.sprite->texture =
+        TextureCache::Acquire(sprite["texture"].asString());
+    prefab.sprite->column = sprite["column"].asUInt();
+    prefab.sprite->row = sprite["row"].asUInt();
+  }
+
+  if (const Json::Value& body{json["rigidBody"]}; body.isObject()) {
+    if (!prefab.sprite) {
+      BEP_LOG_ERROR(LogCategory::Assets,
+                    "Prefab '{}' in {} has a rigid body but no sprite",
+                    prefab.name, path);
+      return false;
+    }
+    Prefab::RigidBody& rigidBody{prefab.rigidBody.emplace()};
+    const std::string type{body.get("type", "static").asString()};
+    if (!ParseBodyType(type, rigidBody.type)) {
+      BEP_LOG_ERROR(LogCategory::Assets,
+                    "Unknown body type '{}' in prefab '{}' in {}", type,
+                    prefab.name, path);
+      return false;
+    }
+    rigidBody.density = body["density"].asFloat();
+    rigidBody.friction = body["friction"].asFloat();
+    rigidBody.restitution = body["restitution"].asFloat();
+    rigidBody.freezeRotation = body["freezeRotation"].asBool();
+  }
+
+  for (const Json::Value& animation : json["animations"]) {
+    const AnimationClipHandle clip{
+        AnimationLibrary::Load(animation["clip"].asString(), frameSize)};
+    if (clip == INVALID_ANIMATION_CLIP) return false;
+    prefab.clips.emplace_back(animation["name"].asString(), clip);
+  }
+  if (const Json::Value& machine{json["stateMachine"]}; machine.isString()) {
+    prefab.stateMachine =
+        AnimationStateMachine::Load(machine.asString(), frameSize);
+    if (!prefab.stateMachine) return false;
+  }
+  prefab.animator = !prefab.clips.empty() || prefab.stateMachine != nullptr;
+  if (prefab.animator && !prefab.sprite) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Prefab '{}' in {} is animated but has no sprite",
+                  prefab.name, path);
+    return false;
+  }
+
+  prefab.audioListener = json["audioListener"].asBool();
+
+  if (const Json::Value& movement{json["movement"]}; movement.isObject()) {
+    if (!prefab.stateMachine || !prefab.rigidBody) {
+      BEP_LOG_ERROR(LogCategory::Assets,
+                    "Prefab '{}' in {} moves without a state machine and a "
+                    "rigid body",
+                    prefab.name, path);
+      return false;
+    }
+    prefab.movement.emplace();
+    prefab.movement->speed = movement["speed"].asFloat();
+    prefab.movement->stepsDelay = movement["stepsDelay"].asFloat();
+    prefab.movement->stepsAudio =
+        AudioClip(movement["stepsAudio"].asString().c_str());
+  }
+
+  prefab.flipSprite = json["flipSprite"].asBool();
+  if (prefab.flipSprite && !prefab.sprite) {
+    BEP_LOG_ERROR(LogCategory::Assets,
+                  "Prefab '{}' in {} flips a sprite it doesn't have",
+                  prefab.name, path);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool PrefabLibrary::Load(const std::string& path) {
+  const AssetData data{AssetFiles::Read(path)};
+  if (!data) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Failed to open prefabs: {}", path);
+    return false;
+  }
+
+  Json::Value root;
+  std::string errors;
+  if (!AssetFiles::ParseJson(data, root, errors)) {
+    BEP_LOG_ERROR(LogCategory::Assets, "JSON parsing error in prefabs {}: {}",
+                  path, errors);
+    return false;
+  }
+  const Json::Value& definitions{root["prefabs"]};
+  if (!definitions.isObject()) {
+    BEP_LOG_ERROR(LogCategory::Assets, "Missing 'prefabs' object in {}",
+                  path);
+    return false;
+  }
+
+  bool loaded{true};
+  for (const std::string& name : definitions.getMemberNames()) {
+    if (Find(name)) {
+      BEP_LOG_ERROR(LogCategory::Assets, "Duplicate prefab '{}' in {}", name,
+                    path);
+      loaded = false;
+      continue;
+    }
+    auto prefab{std::make_unique<Prefab>()};
+    prefab->name = name;
+    bool compiled{};
+    try {
+      compiled = Compile(definitions[name], path, *prefab);
+    } catch (const std::exception& e) {
+      // jsoncpp throws on values of the wrong type
+      BEP_LOG_ERROR(LogCategory::Assets, "Bad prefab '{}' in {}: {}", name,
+                    path, e.what());
+    }
+    if (compiled) {
+      prefabs.push_back(std::move(prefab));
+    } else {
+      loaded = false;
+    }
+  }
+  BEP_LOG_INFO(LogCategory::Assets, "Loaded {} prefabs from {}",
+               prefabs.size(), path);
+  return loaded;
+}
+
+const Prefab* PrefabLibrary::Find(std::string_view name) const {
+  for (const auto& prefab : prefabs) {
+    if (prefab->name == name) return prefab.get();
+  }
+  return nullptr;
+}
+
+std::size_t PrefabLibrary::GetCount() const { return prefabs.size(); }
@@ -0,0 +1,221 @@
+#include "PrefabSpawner.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <gsl/assert>
+#include <memory>
+#include <new>
+
+#include "Components/AnimationStateMachineComponent.hh"
+#include "Components/AnimatorComponent.hh"
+#include "Components/AudioListenerComponent.hh"
+#include "Components/Entity.hh"
+#include "Components/EntityManager.hh"
+#include "Components/RigidBodyComponent.hh"
+#include "Components/SpriteComponent.hh"
+#include "Components/TransformComponent.hh"
+#include "EngineAllocator.hh"
+#include "FlipSprite.hh"
+#include "FrameArena.hh"
+#include "Log.hh"
+#include "Movement.hh"
+
+namespace {
+
+// Raw blocks for one Instantiate, one per component type. The components
+// in them are destroyed by their entities; this only frees the memory,
+// after the last entity lets go of it.
+class ComponentStorage {
+ private:
+  std::vector<void*> blocks;
+
+ public:
+  ComponentStorage() = default;
+  ~ComponentStorage() {
+    for (void* block : blocks) EngineAllocator::Free(block);
+  }
+  ComponentStorage(const ComponentStorage&) = delete;
+  ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+  // Uninitialized room for 'count' components of type T
+  template <typename T>
+  T* Allocate(std::size_t count) {
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    void* block{EngineAllocator::Allocate(count * sizeof(T),
+                                          MemoryTag::General)};
+    blocks.push_back(block);
+    return static_cast<T*>(block);
+  }
+};
+
+}  // namespace
+
+PrefabSpawner::PrefabSpawner(const PrefabLibrary& library,
+                             EntityManager& entityManager,
+                             AnimationSystem& animationSystem,
+                             const InputSystem& input, b2World* world,
+                             PartitionedPhysicsWorld* partitionedWorld,
+                             AudioMixer* audioMixer)
+    : library(library),
+      entityManager(entityManager),
+      animationSystem(animationSystem),
+      input(input),
+      world(world),
+      partitionedWorld(partitionedWorld),
+      audioMixer(audioMixer) {
+  Expects((world == nullptr) != (partitionedWorld == nullptr));
+}
+
+gsl::span<Entity*> PrefabSpawner::Spawn(
+    std::string_view name, std::size_t count,
+    gsl::span<const sf::Vector2f> positions) {
+  Expects(positions.size() >= count);
+  const Prefab* prefab{library.Find(name)};
+  if (!prefab) {
+    BEP_LOG_WARNING(LogCategory::General, "No prefab named '{}'", name);
+    return {};
+  }
+
+  Entity** spawned{FrameArena::ForThread().AllocateArray<Entity*>(count)};
+  std::size_t recycled{};
+  if (auto pool = pools.find(prefab); pool != pools.end()) {
+    std::vector<Entity*>& parked{pool->second};
+    for (; recycled < count && !parked.empty(); ++recycled) {
+      Entity* entity{parked.back()};
+      parked.pop_back();
+      Respawn(*entity, positions[recycled]);
+      spawned[recycled] = entity;
+    }
+  }
+  if (recycled < count) {
+    Instantiate(*prefab, positions.subspan(recycled, count - recycled),
+                spawned + recycled);
+  }
+  return gsl::span<Entity*>(spawned, count);
+}
+
+void PrefabSpawner::Instantiate(const Prefab& prefab,
+                                gsl::span<const sf::Vector2f> positions,
+                                Entity** spawned) {
+  const std::size_t count{positions.size()};
+  const bool audioListener{prefab.audioListener && audioMixer != nullptr};
+  auto storage{std::make_shared<ComponentStorage>()};
+  auto* transforms{storage->Allocate<TransformComponent>(count)};
+  // Null where the prefab doesn't have the component
+  auto* sprites{prefab.sprite ? storage->Allocate<SpriteComponent>(count)
+                              : nullptr};
+  auto* bodies{prefab.rigidBody
+                   ? storage->Allocate<RigidBodyComponent>(count)
+                   : nullptr};
+  auto* animators{prefab.animator
+                      ? storage->Allocate<AnimatorComponent>(count)
+                      : nullptr};
+  auto* stateMachines{
+      prefab.stateMachine
+          ? storage->Allocate<AnimationStateMachineComponent>(count)
+          : nullptr};
+  auto* listeners{audioListener
+                      ? storage->Allocate<AudioListenerComponent>(count)
+                      : nullptr};
+  auto* movements{prefab.movement ? storage->Allocate<Movement>(count)
+                                  : nullptr};
+  auto* flips{prefab.flipSprite ? storage->Allocate<FlipSprite>(count)
+                                : nullptr};
+  const std::shared_ptr<void> blocks{std::move(storage)};
+
+  entityManager.Reserve(count);
+  for (std::size_t i{}; i < count; ++i) {
+    Entity& entity{entityManager.AddEntity(prefab.name)};
+    entity.SetPrefab(&prefab);
+    spawned[i] = &entity;
+
+    entity.AttachComponent(
+        *new (transforms + i)
+            TransformComponent(positions[i].x, positions[i].y, prefab.width,
+                               prefab.height, prefab.scale),
+        blocks);
+    if (sprites) {
+      entity.AttachComponent(
+          *new (sprites + i) SpriteComponent(
+              prefab.sprite->texture, prefab.sprite->column,
+              prefab.sprite->row),
+          blocks);
+    }
+    if (bodies) {
+      const Prefab::RigidBody& body{*prefab.rigidBody};
+      void* userData{&entity};
+      RigidBodyComponent* component{
+          partitionedWorld
+              ? new (bodies + i) RigidBodyComponent(
+                    partitionedWorld, body.type, body.density, body.friction,
+                    body.restitution, 0.f, body.freezeRotation, userData)
+              : new (bodies + i) RigidBodyComponent(
+                    world, body.type, body.density, body.friction,
+                    body.restitution, 0.f, body.freezeRotation, userData)};
+      entity.AttachComponent(*component, blocks);
+    }
+    if (animators) {
+      auto& animator{entity.AttachComponent(
+          *new (animators + i) AnimatorComponent(animationSystem), blocks)};
+      for (const auto& [clipName, clip] : prefab.clips) {
+        animator.AddAnimation(clipName, clip);
+      }
+    }
+    if (stateMachines) {
+      entity.AttachComponent(*new (stateMachines + i)
+                                 AnimationStateMachineComponent(
+                                     prefab.stateMachine),
+                             blocks);
+    }
+    if (listeners) {
+      entity.AttachComponent(
+          *new (listeners + i) AudioListenerComponent(*audioMixer), blocks);
+    }
+    if (movements) {
+      const Prefab::Movement& movement{*prefab.movement};
+      entity.AttachComponent(
+          *new (movements + i) Movement(input, movement.speed,
+                                        movement.stepsDelay,
+                                        movement.stepsAudio),
+          blocks);
+    }
+    if (flips) {
+      entity.AttachComponent(*new (flips + i) FlipSprite(input), blocks);
+    }
+  }
+}
+
+void PrefabSpawner::Respawn(Entity& entity, sf::Vector2f position) {
+  if (auto* body = entity.GetComponent<RigidBodyComponent>()) {
+    body->Teleport(position);
+  } else if (auto* transform = entity.GetComponent<TransformComponent>()) {
+    transform->SetPosition(position);
+  }
+  entity.SetSpawnPool(nullptr);
+  entity.SetEnabled(true);
+}
+
+void PrefabSpawner::Despawn(Entity& entity) {
+  Expects(entity.GetPrefab() != nullptr);
+  Expects(entity.IsActive());
+  if (!entity.IsEnabled()) return;
+  entity.SetEnabled(false);
+  entity.SetSpawnPool(this);
+  pools[entity.GetPrefab()].push_back(&entity);
+}
+
+void PrefabSpawner::Forget(Entity& entity) {
+  std::vector<Entity*>& parked{pools[entity.GetPrefab()]};
+  const auto found{std::find(parked.begin(), parked.end(), &entity)};
+  Expects(found != parked.end());
+  *found = parked.back();
+  parked.pop_back();
+  entity.SetSpawnPool(nullptr);
+}
+
+std::size_t PrefabSpawner::GetPooledCount(std::string_view name) const {
+  const Prefab* prefab{library.Find(name)};
+  if (!prefab) return 0;
+  const auto pool = pools.find(prefab);
+  return pool == pools.end() ? 0 : pool->second.size();
+}
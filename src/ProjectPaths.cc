@@ -0,0 +1,68 @@
+#include "ProjectPaths.hh"
+
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+#include "AssetFiles.hh"
+#include "Constants.hh"
+
+namespace ProjectPaths {
+
+std::string FindProjectRoot() {
+  std::filesystem::path exeDir;
+
+#ifdef _WIN32
+  wchar_t wpath[MAX_PATH];
+  DWORD len = GetModuleFileNameW(nullptr, wpath, MAX_PATH);
+  if (len > 0) {
+    exeDir = std::filesystem::path(wpath).parent_path();
+  } else {
+    exeDir = std::filesystem::current_path();
+  }
+#elif defined(__APPLE__)
+  char path[1024];
+  uint32_t size = sizeof(path);
+  if (_NSGetExecutablePath(path, &size) == 0) {
+    exeDir = std::filesystem::path(path).parent_path();
+  } else {
+    exeDir = std::filesystem::current_path();
+  }
+#else
+  exeDir = std::filesystem::current_path();
+#endif
+
+  // Walk up to 5 levels to find a folder containing "assets" or a pack
+  auto current = exeDir;
+  for (int i = 0; i <= 5; ++i) {
+    if (std::filesystem::exists(current / "assets") ||
+        std::filesystem::exists(current / ASSETS_PACK)) {
+      return current.string();
+    }
+    if (!current.has_parent_path()) break;
+    current = current.parent_path();
+  }
+
+  // Fallback to current working directory
+  return std::filesystem::current_path().string();
+}
+
+std::string FindDefaultMap() {
+  const auto exists = [](const char* p) { return AssetFiles::Exists(p); };
+
+  // 1) Prefer explicit assets JSON constants (developer override)
+  if (exists(ASSETS_MAPS_JSON_THREE)) return ASSETS_MAPS_JSON_THREE;
+  if (exists(ASSETS_MAPS_JSON_TWO)) return ASSETS_MAPS_JSON_TWO;
+  if (exists(ASSETS_MAPS_JSON)) return ASSETS_MAPS_JSON;
+
+  // 2) If not set by constants, pick latest JSON from assets/maps
+  // 3) If still empty, keep the path blank; engine requires JSON maps now
+  return AssetFiles::FindNewest("assets/maps", ".json");
+}
+
+}  // namespace ProjectPaths
@@ -0,0 +1,127 @@
+#include "SimulationBatch.hh"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <gsl/assert>
+#include <iostream>
+#include <random>
+
+#include "AssetFiles.hh"
+#include "Constants.hh"
+#include "CookedAssets.hh"
+#include "GraphicsContext.hh"
+#include "PhysicsUnits.hh"
+#include "PhysicsWarmup.hh"
+#include "ProjectPaths.hh"
+#include "TileGroup.hh"
+
+namespace {
+
+// Holds one of the movement keys (or none) for a random stretch of ticks
+class WanderBot : public InputSource {
+ private:
+  static constexpr std::array<sf::Keyboard::Key, 4> KEYS{
+      sf::Keyboard::Key::W, sf::Keyboard::Key::A, sf::Keyboard::Key::S,
+      sf::Keyboard::Key::D};
+
+  std::mt19937 rng;
+  std::uint32_t holdUntil{};
+  int key{-1};  // index into KEYS, -1 while idle
+
+ public:
+  explicit WanderBot(std::uint32_t seed) : rng(seed) {}
+
+  bool ReadFrame(std::uint32_t tick, InputSnapshot& frameState) override {
+    if (tick >= holdUntil) {
+      const int previous{key};
+      key = std::uniform_int_distribution<int>(
+          -1, static_cast<int>(KEYS.size()) - 1)(rng);
+      holdUntil = tick + std::uniform_int_distribution<std::uint32_t>(
+                             15, 90)(rng);
+      if (key != previous) {
+        if (previous >= 0) {
+          frameState.keysReleased.set(
+              static_cast<std::size_t>(KEYS[previous]));
+        }
+        if (key >= 0) {
+          frameState.keysPressed.set(static_cast<std::size_t>(KEYS[key]));
+        }
+      }
+    }
+    if (key >= 0) frameState.keysDown.set(static_cast<std::size_t>(KEYS[key]));
+    return true;
+  }
+};
+
+}  // namespace
+
+SimulationBatch::SimulationBatch(std::size_t instanceCount,
+                                 unsigned workerCount)
+    : jobs(workerCount) {
+  Expects(instanceCount > 0);
+  std::filesystem::current_path(ProjectPaths::FindProjectRoot());
+  if (!AssetFiles::IsMounted()) AssetFiles::Mount(ASSETS_PACK);
+  if (CookedAssets::GetEntryCount() == 0) {
+    CookedAssets::Load(ASSETS_COOKED_MANIFEST);
+  }
+  GraphicsContext::SetAvailable(false);
+  PhysicsUnits::SetPixelsPerMeter(GameConstants::PIXELS_PER_METER);
+  // Each instance steps its own world on a worker
+  PhysicsWarmup::WarmContactRegisters();
+
+  const std::string mapPath{ProjectPaths::FindDefaultMap()};
+  map = std::make_shared<const TileGroup>(
+      GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT, mapPath.c_str(),
+      GameConstants::TILE_SCALE, GameConstants::TILE_SIZE,
+      GameConstants::TILE_SIZE, ASSETS_TILES);
+
+  // Asset caches fill during construction, so this stays on one thread
+  bots.reserve(instanceCount);
+  instances.reserve(instanceCount);
+  for (std::size_t i{}; i < instanceCount; ++i) {
+    bots.push_back(std::make_unique<WanderBot>(static_cast<std::uint32_t>(i)));
+    SimulationOptions options;
+    options.fixedStep = GameConstants::FIXED_TIME_STEP;
+    // Partitioned physics nests inside the batch's jobs and runs inline
+    options.physicsJobs = &jobs;
+    options.inputSource = bots.back().get();
+    instances.push_back(std::make_unique<SimulationInstance>(map, options));
+  }
+}
+
+SimulationBatch::~SimulationBatch() = default;
+
+bool SimulationBatch::IsSceneComplete() const {
+  return std::all_of(instances.begin(), instances.end(),
+                     [](const auto& instance) {
+                       return instance->IsSceneComplete();
+                     });
+}
+
+SimulationBatchStats SimulationBatch::Run(std::uint32_t ticks) {
+  const auto start{std::chrono::steady_clock::now()};
+  jobs.ParallelFor(instances.size(), [&](std::size_t i) {
+    SimulationInstance& instance{*instances[i]};
+    for (std::uint32_t t{}; t < ticks; ++t) {
+      if (!instance.Step()) break;
+    }
+  });
+  const double wallMs{std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count()};
+
+  SimulationBatchStats stats;
+  stats.instances = instances.size();
+  stats.wallMs = wallMs;
+  for (const auto& instance : instances) {
+    stats.ticks += instance->GetTick();
+    // Order-dependent mix, so swapped instance results still show up
+    stats.checksum ^= instance->ComputeChecksum() + 0x9e3779b97f4a7c15ULL +
+                      (stats.checksum << 6) + (stats.checksum >> 2);
+  }
+  stats.ticksPerSecond =
+      wallMs > 0.0 ? static_cast<double>(stats.ticks) * 1000.0 / wallMs : 0.0;
+  return stats;
+}
@@ -0,0 +1,207 @@
+#include "SimulationInstance.hh"
+
+#include <gsl/assert>
+
+#include "AnimationSystem.hh"
+#include "Components/Entity.hh"
+#include "Components/EntityManager.hh"
+#include "Constants.hh"
+#include "ContactEventManager.hh"
+#include "Metrics.hh"
+#include "PartitionedPhysicsWorld.hh"
+#include "PhysicsUnits.hh"
+#include "PrefabLibrary.hh"
+#include "PrefabSpawner.hh"
+#include "TileGroup.hh"
+
+namespace {
+
+// Box2D step profile, in ms, fed on every physics step
+struct PhysicsMetrics {
+  static constexpr double EDGES_MS[]{0.05, 0.1, 0.25, 0.5, 1.0,
+                                     2.0,  4.0, 8.0,  16.0};
+  MetricCounter& steps{Metrics::RegisterCounter("physics.steps")};
+  MetricHistogram& step{
+      Metrics::RegisterHistogram("physics.step_ms", EDGES_MS)};
+  MetricHistogram& collide{
+      Metrics::RegisterHistogram("physics.collide_ms", EDGES_MS)};
+  MetricHistogram& solve{
+      Metrics::RegisterHistogram("physics.solve_ms", EDGES_MS)};
+  MetricHistogram& broadphase{
+      Metrics::RegisterHistogram("physics.broadphase_ms", EDGES_MS)};
+
+  void Record(const b2Profile& profile) {
+    steps.Add();
+    step.Observe(profile.step);
+    collide.Observe(profile.collide);
+    solve.Observe(profile.solve);
+    broadphase.Observe(profile.broadphase);
+  }
+};
+
+PhysicsMetrics& GetPhysicsMetrics() {
+  static PhysicsMetrics metrics;
+  return metrics;
+}
+
+}  // namespace
+
+SimulationInstance::SimulationInstance(std::shared_ptr<const TileGroup> map,
+                                       const SimulationOptions& options)
+    : map(std::move(map)),
+      inputSource(options.inputSource),
+      fixedStep(options.fixedStep) {
+  Expects(fixedStep >= 0.f);
+  // Register up front so stepping never takes the registry lock
+  GetPhysicsMetrics();
+  contactEventManager = std::make_unique<ContactEventManager>();
+  const b2Vec2 gravity{0.f, 0.f};
+  if (GameConstants::PHYSICS_PARTITIONED) {
+    Expects(options.physicsJobs != nullptr);
+    const b2Vec2 mapSize{PhysicsUnits::ToMeters(
+        sf::Vector2f(GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT) *
+        GameConstants::TILE_SIZE * GameConstants::TILE_SCALE)};
+    partitionedWorld = std::make_unique<PartitionedPhysicsWorld>(
+        gravity, b2Vec2(0.f, 0.f), mapSize, GameConstants::PHYSICS_CELL_SIZE,
+        GameConstants::PHYSICS_GHOST_MARGIN, *options.physicsJobs);
+  } else {
+    world = std::make_unique<b2World>(gravity);
+    world->SetContactListener(contactEventManager.get());
+  }
+  input = std::make_unique<InputSystem>();
+  input->LoadBindings(ASSETS_INPUT_BINDINGS);
+  animationSystem = std::make_unique<AnimationSystem>();
+  entityManager = std::make_unique<EntityManager>();
+  prefabLibrary = std::make_unique<PrefabLibrary>();
+  const bool prefabsLoaded{prefabLibrary->Load(ASSETS_PREFABS)};
+  prefabSpawner = std::make_unique<PrefabSpawner>(
+      *prefabLibrary, *entityManager, *animationSystem, *input, world.get(),
+      partitionedWorld.get(), options.audioMixer);
+  sceneComplete = SpawnScene() && prefabsLoaded;
+}
+
+SimulationInstance::~SimulationInstance() {
+  // Detach Box2D hooks, then drop bodies before their world
+  if (world) {
+    world->SetDebugDraw(nullptr);
+    world->SetContactListener(nullptr);
+  }
+  if (partitionedWorld) partitionedWorld->SetDebugDraw(nullptr);
+  entityManager.reset();
+}
+
+bool SimulationInstance::SpawnScene() {
+  const sf::Vector2f heroPosition{500.f, 300.f};
+  const sf::Vector2f candlePosition{500.f, 500.f};
+  const sf::Vector2f chestPositions[]{
+      {300.f, 500.f}, {300.f, 400.f}, {300.f, 300.f}};
+  const auto heroes{SpawnPrefab("hero", 1, {&heroPosition, 1})};
+  const auto candles{SpawnPrefab("candle", 1, {&candlePosition, 1})};
+  const auto chests{SpawnPrefab("chest", 3, chestPositions)};
+
+  SimulationLOD::Settings lodSettings;
+  lodSettings.cellSize = GameConstants::SIM_LOD_CELL_SIZE;
+  lodSettings.fullRadius = GameConstants::SIM_LOD_FULL_RADIUS;
+  lodSettings.reducedRadius = GameConstants::SIM_LOD_REDUCED_RADIUS;
+  lodSettings.reducedInterval = GameConstants::SIM_LOD_REDUCED_INTERVAL;
+  entityManager->GetSimulationLOD().SetSettings(lodSettings);
+  entityManager->SetSimulationFocus(heroes.empty() ? nullptr : heroes[0]);
+  return !heroes.empty() && !candles.empty() && !chests.empty();
+}
+
+bool SimulationInstance::Step() {
+  Expects(fixedStep > 0.f);
+  input->BeginFrame();
+  if (inputSource) {
+    InputSnapshot frameState;
+    if (!inputSource->ReadFrame(tick, frameState)) return false;
+    input->OverrideDeviceState(frameState);
+  }
+  input->EndFrame();
+
+  StepPhysics(fixedStep);
+  UpdateEntities(fixedStep);
+  UpdateAnimation(fixedStep);
+  ++tick;
+  return true;
+}
+
+void SimulationInstance::StepPhysics(float deltaTime) {
+  if (partitionedWorld) {
+    partitionedWorld->Step(deltaTime,
+                           GameConstants::PHYSICS_VELOCITY_ITERATIONS,
+                           GameConstants::PHYSICS_POSITION_ITERATIONS);
+    contactEventManager->Dispatch(partitionedWorld->GetContactEvents());
+    GetPhysicsMetrics().Record(partitionedWorld->GetProfile());
+    return;
+  }
+  world->ClearForces();
+  world->Step(deltaTime, GameConstants::PHYSICS_VELOCITY_ITERATIONS,
+              GameConstants::PHYSICS_POSITION_ITERATIONS);
+  GetPhysicsMetrics().Record(world->GetProfile());
+}
+
+void SimulationInstance::UpdateEntities(float deltaTime) {
+  entityManager->Update(deltaTime);
+}
+
+void SimulationInstance::UpdateAnimation(float deltaTime) {
+  animationSystem->Update(deltaTime);
+}
+
+void SimulationInstance::RefreshAnimationClips() {
+  animationSystem->RefreshClips();
+}
+
+gsl::span<Entity*> SimulationInstance::SpawnPrefab(
+    std::string_view name, std::size_t count,
+    gsl::span<const sf::Vector2f> positions) {
+  return prefabSpawner->Spawn(name, count, positions);
+}
+
+void SimulationInstance::DespawnPrefab(Entity& entity) {
+  prefabSpawner->Despawn(entity);
+}
+
+void SimulationInstance::SetDebugDraw(b2Draw* debugDraw) {
+  if (partitionedWorld) {
+    partitionedWorld->SetDebugDraw(debugDraw);
+  } else {
+    world->SetDebugDraw(debugDraw);
+  }
+}
+
+void SimulationInstance::DebugDraw() {
+  if (partitionedWorld) {
+    partitionedWorld->DebugDraw();
+  } else {
+    world->DebugDraw();
+  }
+}
+
+std::uint64_t SimulationInstance::ComputeChecksum() const {
+  return entityManager->ComputeChecksum();
+}
+
+InputSystem& SimulationInstance::GetInput() { return *input; }
+
+EntityManager& SimulationInstance::GetEntityManager() { return *entityManager; }
+
+const TileGroup* SimulationInstance::GetMap() const { return map.get(); }
+
+std::uint32_t SimulationInstance::GetTick() const { return tick; }
+
+bool SimulationInstance::IsSceneComplete() const { return sceneComplete; }
+
+SimulationStats SimulationInstance::GetStats() const {
+  SimulationStats stats;
+  stats.entities = entityManager->GetentityCount();
+  stats.bodies = static_cast<std::size_t>(
+      partitionedWorld ? partitionedWorld->GetBodyCount()
+                       : world->GetBodyCount());
+  stats.contacts = static_cast<std::size_t>(
+      partitionedWorld ? partitionedWorld->GetContactCount()
+                       : world->GetContactCount());
+  stats.tiles = map ? map->GetTileCount() : 0;
+  return stats;
+}
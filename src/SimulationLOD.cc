@@ -0,0 +1,79 @@
+#include "SimulationLOD.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <gsl/assert>
+
+SimulationLOD::SimulationLOD(const Settings& settings) {
+  SetSettings(settings);
+}
+
+void SimulationLOD::SetSettings(const Settings& settings) {
+  Expects(settings.cellSize > 0.f);
+  Expects(settings.fullRadius >= 0 &&
+          settings.reducedRadius >= settings.fullRadius);
+  Expects(settings.reducedInterval > 0);
+  this->settings = settings;
+}
+
+const SimulationLOD::Settings& SimulationLOD::GetSettings() const {
+  return settings;
+}
+
+void SimulationLOD::SetFocus(const sf::Vector2f& position) {
+  focusCell = CellOf(position);
+  hasFocus = true;
+}
+
+void SimulationLOD::ClearFocus() { hasFocus = false; }
+
+bool SimulationLOD::HasFocus() const { return hasFocus; }
+
+sf::Vector2i SimulationLOD::CellOf(const sf::Vector2f& position) const {
+  return sf::Vector2i(
+      static_cast<int>(std::floor(position.x / settings.cellSize)),
+      static_cast<int>(std::floor(position.y / settings.cellSize)));
+}
+
+SimulationTier SimulationLOD::Classify(const sf::Vector2f& position) const {
+  if (!hasFocus) return SimulationTier::Full;
+  const sf::Vector2i cell{CellOf(position)};
+  const int ring{std::max(std::abs(cell.x - focusCell.x),
+                          std::abs(cell.y - focusCell.y))};
+  if (ring <= settings.fullRadius) return SimulationTier::Full;
+  if (ring <= settings.reducedRadius) return SimulationTier::Reduced;
+  return SimulationTier::Dormant;
+}
+
+void SimulationLOD::BeginFrame() {
+  ++frame;
+  tierCounts.fill(0);
+}
+
+void SimulationLOD::Count(SimulationTier tier) {
+  ++tierCounts[static_cast<std::size_t>(tier)];
+}
+
+bool SimulationLOD::IsReducedUpdateDue(std::uint32_t slot) const {
+  const auto interval{static_cast<std::uint32_t>(settings.reducedInterval)};
+  return (frame + slot) % interval == 0;
+}
+
+int SimulationLOD::GetTierCount(SimulationTier tier) const {
+  Expects(tier < SimulationTier::Count);
+  return tierCounts[static_cast<std::size_t>(tier)];
+}
+
+const char* SimulationLOD::GetTierName(SimulationTier tier) {
+  switch (tier) {
+    case SimulationTier::Full:
+      return "Full";
+    case SimulationTier::Reduced:
+      return "Reduced";
+    case SimulationTier::Dormant:
+      return "Dormant";
+    default:
+      return "Unknown";
+  }
+}
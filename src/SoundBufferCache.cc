@@ -0,0 +1,78 @@
+#include "SoundBufferCache.hh"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "AssetFiles.hh"
+#include "Log.hh"
+
+namespace {
+
+struct CacheState {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<const sf::SoundBuffer>>
+      buffers;
+  std::int64_t decodes{};
+  std::int64_t cacheHits{};
+};
+
+CacheState& State() {
+  static CacheState state;
+  return state;
+}
+
+std::int64_t BufferBytes(const sf::SoundBuffer& buffer) {
+  return static_cast<std::int64_t>(buffer.getSampleCount() *
+                                   sizeof(std::int16_t));
+}
+
+}  // namespace
+
+std::shared_ptr<const sf::SoundBuffer> SoundBufferCache::Acquire(
+    const std::string& path) {
+  CacheState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (auto it = state.buffers.find(path); it != state.buffers.end()) {
+    ++state.cacheHits;
+    return it->second;
+  }
+
+  auto buffer = std::make_shared<sf::SoundBuffer>();
+  try {
+    const AssetData data{AssetFiles::Read(path)};
+    if (!data || !buffer->loadFromMemory(data.GetData(), data.GetSize())) {
+      BEP_LOG_ERROR(LogCategory::Audio, "Failed to load audio file: {}",
+                    path);
+      return nullptr;
+    }
+  } catch (const std::exception& e) {
+    BEP_LOG_ERROR(LogCategory::Audio, "Exception decoding audio file {}: {}",
+                  path, e.what());
+    return nullptr;
+  }
+  ++state.decodes;
+  state.buffers.emplace(path, buffer);
+  return buffer;
+}
+
+int SoundBufferCache::Trim() {
+  CacheState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  const auto trimmed = std::erase_if(state.buffers, [](const auto& entry) {
+    return entry.second.use_count() == 1;
+  });
+  return static_cast<int>(trimmed);
+}
+
+SoundBufferStats SoundBufferCache::GetStats() {
+  CacheState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  SoundBufferStats stats;
+  stats.buffers = static_cast<int>(state.buffers.size());
+  for (const auto& [path, buffer] : state.buffers) {
+    stats.bytes += BufferBytes(*buffer);
+  }
+  stats.decodes = state.decodes;
+  stats.cacheHits = state.cacheHits;
+  return stats;
+}
@@ -0,0 +1,228 @@
+#include "Telemetry.hh"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "Log.hh"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TELEMETRY_SHM_AVAILABLE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace {
+
+constexpr std::uint32_t TELEMETRY_MAGIC{0x4D4C5442};  // "BTLM"
+
+// Both processes map the same atomics, which is only sound when they are
+// lock-free (and so address-free)
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::is_trivially_copyable_v<TelemetryFrame>);
+
+struct alignas(64) RingHeader {
+  std::atomic<std::uint32_t> magic;  // stored last, once the ring is usable
+  std::uint32_t version;
+  std::uint32_t frameSize;
+  std::uint32_t capacity;
+  std::atomic<std::uint64_t> published;  // frames published so far
+  std::atomic<std::uint32_t> closed;
+};
+
+// Frame n is being written while sequence is 2n + 1 and complete at 2n + 2
+struct alignas(64) RingSlot {
+  std::atomic<std::uint64_t> sequence;
+  TelemetryFrame frame;
+};
+
+constexpr std::size_t RingSize(std::size_t capacity) {
+  return sizeof(RingHeader) + sizeof(RingSlot) * capacity;
+}
+
+RingHeader& Header(void* mapping) {
+  return *static_cast<RingHeader*>(mapping);
+}
+
+const RingHeader& Header(const void* mapping) {
+  return *static_cast<const RingHeader*>(mapping);
+}
+
+RingSlot* Slots(void* mapping) {
+  return reinterpret_cast<RingSlot*>(static_cast<char*>(mapping) +
+                                     sizeof(RingHeader));
+}
+
+const RingSlot* Slots(const void* mapping) {
+  return reinterpret_cast<const RingSlot*>(
+      static_cast<const char*>(mapping) + sizeof(RingHeader));
+}
+
+}  // namespace
+
+TelemetryWriter::~TelemetryWriter() { Close(); }
+
+bool TelemetryWriter::Open(const std::string& segmentName) {
+  Close();
+#ifdef TELEMETRY_SHM_AVAILABLE
+  // Replace a segment left behind by a crashed run
+  shm_unlink(segmentName.c_str());
+  const int fd{shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)};
+  if (fd < 0) {
+    BEP_LOG_ERROR(LogCategory::General,
+                  "Failed to create telemetry segment {}: {}", segmentName,
+                  std::strerror(errno));
+    return false;
+  }
+  const std::size_t size{RingSize(RING_FRAMES)};
+  void* memory{MAP_FAILED};
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  const int error{errno};
+  close(fd);
+  if (memory == MAP_FAILED) {
+    BEP_LOG_ERROR(LogCategory::General,
+                  "Failed to map telemetry segment {}: {}", segmentName,
+                  std::strerror(error));
+    shm_unlink(segmentName.c_str());
+    return false;
+  }
+
+  // New pages are zeroed; construct the header and slots in place
+  RingHeader& header{*new (memory) RingHeader{}};
+  RingSlot* slots{Slots(memory)};
+  for (std::uint32_t i{}; i < RING_FRAMES; ++i) new (&slots[i]) RingSlot{};
+  header.version = TELEMETRY_VERSION;
+  header.frameSize = sizeof(TelemetryFrame);
+  header.capacity = RING_FRAMES;
+  header.magic.store(TELEMETRY_MAGIC, std::memory_order_release);
+
+  mapping = memory;
+  mappingSize = size;
+  name = segmentName;
+  next = 0;
+  return true;
+#else
+  BEP_LOG_WARNING(
+      LogCategory::General,
+      "Telemetry segment {} not created: shared memory is not supported on "
+      "this platform",
+      segmentName);
+  return false;
+#endif
+}
+
+void TelemetryWriter::Publish(const TelemetryFrame& frame) {
+  if (!mapping) return;
+  RingSlot& slot{Slots(mapping)[next % RING_FRAMES]};
+  slot.sequence.store(2 * next + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&slot.frame, &frame, sizeof(TelemetryFrame));
+  slot.sequence.store(2 * next + 2, std::memory_order_release);
+  ++next;
+  Header(mapping).published.store(next, std::memory_order_release);
+}
+
+void TelemetryWriter::Close() {
+  if (!mapping) return;
+#ifdef TELEMETRY_SHM_AVAILABLE
+  Header(mapping).closed.store(1, std::memory_order_release);
+  munmap(mapping, mappingSize);
+  shm_unlink(name.c_str());
+#endif
+  mapping = nullptr;
+  mappingSize = 0;
+}
+
+TelemetryReader::~TelemetryReader() { Close(); }
+
+bool TelemetryReader::Open(const std::string& segmentName) {
+  Close();
+#ifdef TELEMETRY_SHM_AVAILABLE
+  const int fd{shm_open(segmentName.c_str(), O_RDONLY, 0)};
+  if (fd < 0) return false;
+  struct stat info {};
+  void* memory{MAP_FAILED};
+  if (fstat(fd, &info) == 0 &&
+      static_cast<std::size_t>(info.st_size) >= sizeof(RingHeader)) {
+    memory = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ,
+                  MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (memory == MAP_FAILED) return false;
+
+  const auto size{static_cast<std::size_t>(info.st_size)};
+  const RingHeader& header{Header(static_cast<const void*>(memory))};
+  // A writer still initializing, or one built from another layout
+  if (header.magic.load(std::memory_order_acquire) != TELEMETRY_MAGIC ||
+      header.version != TELEMETRY_VERSION ||
+      header.frameSize != sizeof(TelemetryFrame) || header.capacity == 0 ||
+      RingSize(header.capacity) > size) {
+    munmap(memory, size);
+    return false;
+  }
+  mapping = memory;
+  mappingSize = size;
+  // Start at the live edge
+  next = header.published.load(std::memory_order_acquire);
+  return true;
+#else
+  (void)segmentName;
+  return false;
+#endif
+}
+
+void TelemetryReader::Close() {
+  if (!mapping) return;
+#ifdef TELEMETRY_SHM_AVAILABLE
+  munmap(const_cast<void*>(mapping), mappingSize);
+#endif
+  mapping = nullptr;
+  mappingSize = 0;
+}
+
+bool TelemetryReader::IsOpen() const { return mapping != nullptr; }
+
+std::size_t TelemetryReader::Poll(std::vector<TelemetryFrame>& frames) {
+  if (!mapping) return 0;
+  const RingHeader& header{Header(mapping)};
+  const RingSlot* slots{Slots(mapping)};
+  const std::uint64_t capacity{header.capacity};
+  const std::uint64_t published{
+      header.published.load(std::memory_order_acquire)};
+  if (published - next > capacity) {
+    dropped += published - capacity - next;
+    next = published - capacity;
+  }
+
+  std::size_t read{};
+  for (; next < published; ++next) {
+    const RingSlot& slot{slots[next % capacity]};
+    const std::uint64_t before{slot.sequence.load(std::memory_order_acquire)};
+    TelemetryFrame frame;
+    std::memcpy(&frame, &slot.frame, sizeof(TelemetryFrame));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t after{slot.sequence.load(std::memory_order_relaxed)};
+    // Overwritten by a lap of the writer while we copied it
+    if (before != 2 * next + 2 || after != before) {
+      ++dropped;
+      continue;
+    }
+    frames.push_back(frame);
+    ++read;
+  }
+  return read;
+}
+
+bool TelemetryReader::IsWriterClosed() const {
+  return mapping &&
+         Header(mapping).closed.load(std::memory_order_acquire) != 0;
+}
+
+std::uint64_t TelemetryReader::GetDropped() const { return dropped; }
@@ -0,0 +1,165 @@
+// Telemetry viewer: tails the ring a game started with --telemetry publishes
+// to and prints rolling percentiles of frame and phase times once a second,
+// along with the latest world counts and allocation rate. Waits for the game
+// to start and reattaches when it restarts.
+//
+// Usage: TelemetryViewer [--name <segment>] [--window <frames>]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Constants.hh"
+#include "FrameProfiler.hh"
+#include "Telemetry.hh"
+
+namespace {
+
+constexpr std::size_t DEFAULT_WINDOW_FRAMES{600};
+constexpr auto POLL_INTERVAL{std::chrono::milliseconds(50)};
+constexpr auto REPORT_INTERVAL{std::chrono::seconds(1)};
+
+// Positive integer; false if arg isn't one
+bool ParseCount(const char* arg, std::size_t& value) {
+  char* end{};
+  value = std::strtoul(arg, &end, 10);
+  return *end == '\0' && value > 0;
+}
+
+struct Percentiles {
+  float p50{};
+  float p95{};
+  float p99{};
+  float max{};
+};
+
+// Sorts 'values' in place
+Percentiles ComputePercentiles(std::vector<float>& values) {
+  Percentiles result;
+  if (values.empty()) return result;
+  std::sort(values.begin(), values.end());
+  const auto at = [&](double fraction) {
+    return values[static_cast<std::size_t>(
+        fraction * static_cast<double>(values.size() - 1) + 0.5)];
+  };
+  result.p50 = at(0.50);
+  result.p95 = at(0.95);
+  result.p99 = at(0.99);
+  result.max = values.back();
+  return result;
+}
+
+void PrintRow(const char* name, const Percentiles& row) {
+  std::cout << std::left << std::setw(12) << name << std::right
+            << std::setw(10) << row.p50 << std::setw(10) << row.p95
+            << std::setw(10) << row.p99 << std::setw(10) << row.max << '\n';
+}
+
+void PrintReport(const std::deque<TelemetryFrame>& window,
+                 std::uint64_t dropped) {
+  const TelemetryFrame& first{window.front()};
+  const TelemetryFrame& last{window.back()};
+  std::vector<float> values;
+  values.reserve(window.size());
+
+  double windowMs{};
+  for (const TelemetryFrame& frame : window) {
+    values.push_back(frame.frameMs);
+    windowMs += frame.frameMs;
+  }
+  const double seconds{windowMs / 1000.0};
+
+  std::cout << std::fixed << std::setprecision(1) << "frame " << last.frame
+            << "  "
+            << (seconds > 0.0 ? static_cast<double>(window.size()) / seconds
+                              : 0.0)
+            << " fps over " << window.size() << " frames, " << dropped
+            << " dropped\n"
+            << std::setprecision(3) << std::left << std::setw(12) << "ms"
+            << std::right << std::setw(10) << "p50" << std::setw(10) << "p95"
+            << std::setw(10) << "p99" << std::setw(10) << "max" << '\n';
+  PrintRow("frame", ComputePercentiles(values));
+  for (std::size_t phase{}; phase < TelemetryFrame::PHASES; ++phase) {
+    values.clear();
+    float maxMs{};
+    for (const TelemetryFrame& frame : window) {
+      values.push_back(frame.phaseMs[phase]);
+      maxMs = std::max(maxMs, frame.phaseMs[phase]);
+    }
+    // Phases the game doesn't run (ui when headless)
+    if (maxMs <= 0.f) continue;
+    PrintRow(FrameProfiler::GetPhaseName(static_cast<FramePhase>(phase)),
+             ComputePercentiles(values));
+  }
+  const double allocationsPerSecond{
+      seconds > 0.0
+          ? static_cast<double>(last.allocations - first.allocations) / seconds
+          : 0.0};
+  std::cout << std::setprecision(1) << "entities " << last.entities
+            << "  bodies " << last.bodies << "  contacts " << last.contacts
+            << "  heap " << last.allocatedBytes / 1024.0 << " KB  "
+            << allocationsPerSecond << " allocs/s\n"
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string name{TELEMETRY_SEGMENT};
+  std::size_t windowFrames{DEFAULT_WINDOW_FRAMES};
+  for (int i{1}; i < argc; ++i) {
+    const bool hasValue{i + 1 < argc};
+    if (std::strcmp(argv[i], "--name") == 0 && hasValue) {
+      name = argv[++i];
+      continue;
+    }
+    if (std::strcmp(argv[i], "--window") == 0 && hasValue &&
+        ParseCount(argv[++i], windowFrames)) {
+      continue;
+    }
+    std::cerr << "Usage: " << argv[0]
+              << " [--name <segment>] [--window <frames>]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  TelemetryReader reader;
+  std::deque<TelemetryFrame> window;
+  std::vector<TelemetryFrame> batch;
+  bool waiting{};
+  auto nextReport{std::chrono::steady_clock::now() + REPORT_INTERVAL};
+  while (true) {
+    if (!reader.IsOpen() || reader.IsWriterClosed()) {
+      if (!reader.Open(name)) {
+        if (!waiting) {
+          std::cout << "Waiting for " << name << " ..." << std::endl;
+          waiting = true;
+        }
+        std::this_thread::sleep_for(REPORT_INTERVAL);
+        continue;
+      }
+      std::cout << "Attached to " << name << std::endl;
+      waiting = false;
+      window.clear();
+    }
+
+    batch.clear();
+    reader.Poll(batch);
+    for (const TelemetryFrame& frame : batch) {
+      window.push_back(frame);
+      if (window.size() > windowFrames) window.pop_front();
+    }
+
+    const auto now{std::chrono::steady_clock::now()};
+    if (now >= nextReport) {
+      nextReport = now + REPORT_INTERVAL;
+      if (!window.empty()) PrintReport(window, reader.GetDropped());
+    }
+    std::this_thread::sleep_for(POLL_INTERVAL);
+  }
+}
@@ -0,0 +1,112 @@
+#include "TextureCache.hh"
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "CookedAssets.hh"
+#include "GraphicsContext.hh"
+#include "Log.hh"
+
+namespace {
+
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view text) const {
+    return std::hash<std::string_view>{}(text);
+  }
+};
+
+struct CacheState {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<sf::Texture>, StringHash,
+                     std::equal_to<>>
+      textures;
+  std::int64_t loads{};
+  std::int64_t cacheHits{};
+  std::int64_t reloads{};
+};
+
+CacheState& State() {
+  static CacheState state;
+  return state;
+}
+
+// Maps may name a tileset "./assets/tiles.png" as well as "assets/tiles.png"
+std::string Normalize(std::string_view path) {
+  return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+}  // namespace
+
+std::shared_ptr<const sf::Texture> TextureCache::Acquire(
+    const std::string& path) {
+  CacheState& state{State()};
+  const std::string key{Normalize(path)};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (auto it = state.textures.find(key); it != state.textures.end()) {
+    ++state.cacheHits;
+    return it->second;
+  }
+
+  auto texture = std::make_shared<sf::Texture>();
+  if (GraphicsContext::IsAvailable()) {
+    ++state.loads;
+    if (!CookedAssets::LoadTexture(*texture, key)) {
+      BEP_LOG_ERROR(LogCategory::Assets, "Failed to load texture: {}", path);
+    }
+  }
+  // Failures stay cached too: a hot reload of the file can still fix them
+  state.textures.emplace(key, texture);
+  return texture;
+}
+
+bool TextureCache::Contains(std::string_view path) {
+  CacheState& state{State()};
+  const std::string key{Normalize(path)};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.textures.contains(key);
+}
+
+bool TextureCache::Replace(std::string_view path, const sf::Image& image) {
+  CacheState& state{State()};
+  const std::string key{Normalize(path)};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  const auto it{state.textures.find(key)};
+  if (it == state.textures.end() || !GraphicsContext::IsAvailable()) {
+    return false;
+  }
+  sf::Texture& texture{*it->second};
+  ++state.reloads;
+  // Same size: overwrite the texels without reallocating the GL texture
+  if (texture.getSize() == image.getSize() && texture.getSize().x > 0) {
+    texture.update(image);
+    return true;
+  }
+  return texture.loadFromImage(image);
+}
+
+int TextureCache::Trim() {
+  CacheState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  const auto trimmed = std::erase_if(state.textures, [](const auto& entry) {
+    return entry.second.use_count() == 1;
+  });
+  return static_cast<int>(trimmed);
+}
+
+TextureCacheStats TextureCache::GetStats() {
+  CacheState& state{State()};
+  std::lock_guard<std::mutex> lock(state.mutex);
+  TextureCacheStats stats;
+  stats.textures = static_cast<int>(state.textures.size());
+  for (const auto& [path, texture] : state.textures) {
+    const sf::Vector2u size{texture->getSize()};
+    stats.bytes += std::int64_t{size.x} * size.y * 4;
+  }
+  stats.loads = state.loads;
+  stats.cacheHits = state.cacheHits;
+  stats.reloads = state.reloads;
+  return stats;
+}
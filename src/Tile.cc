@@ -1,14 +1,13 @@
 #include "Tile.hh"
 
-#include <iostream>
 #include <memory>
 
-Tile::Tile(const std::string& textureUrl, float scale, int width, int height,
-           int column, int row, float posX, float posY,
-           sf::RenderWindow*& window) {
+#include "Log.hh"
+
+Tile::Tile(std::shared_ptr<const sf::Texture> texture, float scale, int width,
+           int height, int column, int row, float posX, float posY) {
+  Expects(texture != nullptr);
   try {
-    Expects(window != nullptr);
-    this->window = window;
     this->scale = scale;
     this->width = width;
     this->height = height;
@@ -17,21 +16,19 @@ Tile::Tile(const std::string& textureUrl, float scale, int width, int height,
     this->posX = posX;
     this->posY = posY;
 
-    texture = std::make_unique<sf::Texture>();
-    if (!texture->loadFromFile(textureUrl)) {
-      std::cerr << "Failed to load tile texture: " << textureUrl << std::endl;
-    }
+    this->texture = std::move(texture);
     sprite = std::make_unique<sf::Sprite>(
-        *texture, sf::IntRect({gsl::narrow_cast<int>(column * width),
-                               gsl::narrow_cast<int>(row * height)},
-                              {gsl::narrow_cast<int>(width),
-                               gsl::narrow_cast<int>(height)}));
+        *this->texture,
+        sf::IntRect({gsl::narrow_cast<int>(column * width),
+                     gsl::narrow_cast<int>(row * height)},
+                    {gsl::narrow_cast<int>(width),
+                     gsl::narrow_cast<int>(height)}));
     sprite->setPosition(sf::Vector2f(posX, posY));
     sprite->setColor(sf::Color::White);
     sprite->setScale(sf::Vector2f(scale, scale));
   } catch (const std::exception& e) {
-    std::cerr << "Exception in Tile constructor: " << e.what() << std::endl;
-    texture.reset();
+    BEP_LOG_ERROR(LogCategory::Assets, "Exception in Tile constructor: {}",
+                  e.what());
     sprite.reset();
   }
 }
@@ -40,6 +37,6 @@ Tile::~Tile() {
   // No need to manually delete smart pointers
 }
 
-void Tile::Draw() {
-  if (window && sprite) window->draw(*sprite);
+void Tile::Draw(sf::RenderTarget& target) const {
+  if (sprite) target.draw(*sprite);
 }
\ No newline at end of file
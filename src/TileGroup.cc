@@ -2,21 +2,124 @@
 
 #include <json/json.h>
 
-#include <cctype>
-#include <filesystem>
-#include <fstream>
+#include <algorithm>
+#include <cstring>
 #include <gsl/narrow>
-#include <iostream>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
-TileGroup::TileGroup(sf::RenderWindow* window, int COLS, int ROWS,
-                     const char* filePath, float scale, float tileWidth,
-                     float tileHeight, const char* textureUrl) {
-  Expects(window != nullptr);
+#include "AssetFiles.hh"
+#include "CookedAssets.hh"
+#include "Log.hh"
+#include "TextureCache.hh"
+
+namespace {
+
+// Rows of [column, row] pairs; short rows are padded with empty cells
+void ReadGrid(const Json::Value& gridVal, MapLayerData& layer) {
+  if (!gridVal.isArray()) return;
+  for (const auto& rowVal : gridVal) {
+    if (!rowVal.isArray()) continue;
+    ++layer.rows;
+    layer.columns =
+        std::max(layer.columns, gsl::narrow_cast<int>(rowVal.size()));
+  }
+  layer.cells.assign(static_cast<std::size_t>(layer.columns * layer.rows),
+                     sf::Vector2i{});
+  int y{};
+  for (const auto& rowVal : gridVal) {
+    if (!rowVal.isArray()) continue;
+    int x{};
+    for (const auto& cell : rowVal) {
+      if (cell.isArray() && cell.size() == 2) {
+        layer.cells[static_cast<std::size_t>(y * layer.columns + x)] =
+            sf::Vector2i(cell[0].asInt(), cell[1].asInt());
+      }
+      ++x;
+    }
+    ++y;
+  }
+}
+
+void ReadJsonLayer(const Json::Value& value, MapLayerData& layer) {
+  if (value.isMember("tileset")) layer.tileset = value["tileset"].asString();
+  if (value.isMember("tileW")) layer.tileWidth = value["tileW"].asInt();
+  if (value.isMember("tileH")) layer.tileHeight = value["tileH"].asInt();
+  ReadGrid(value["grid"], layer);
+}
+
+// False if 'data' isn't a valid cooked map (see CookedAssets.hh)
+bool ReadCookedMap(const AssetData& data, MapData& map) {
+  const std::byte* at{data.GetData()};
+  std::size_t left{data.GetSize()};
+  auto take = [&](void* out, std::size_t size) {
+    if (size > left) return false;
+    if (size > 0) std::memcpy(out, at, size);
+    at += size;
+    left -= size;
+    return true;
+  };
+
+  CookedMapHeader header{};
+  if (!take(&header, sizeof(header)) ||
+      std::memcmp(header.magic, COOKED_MAP_MAGIC, sizeof(COOKED_MAP_MAGIC)) !=
+          0 ||
+      header.version != COOKED_VERSION) {
+    return false;
+  }
+
+  // No JSON: every cell is a fixed-size record, already bounds-checked by
+  // the cooker against its tileset
+  map.layers.clear();
+  for (std::uint32_t i{}; i < header.layerCount; ++i) {
+    CookedMapLayer cooked{};
+    if (!take(&cooked, sizeof(cooked)) || cooked.tilesetLength > left) {
+      return false;
+    }
+    MapLayerData& layer{map.layers.emplace_back()};
+    layer.tileset.resize(cooked.tilesetLength);
+    take(layer.tileset.data(), layer.tileset.size());
+    if (std::uint64_t{cooked.columns} * cooked.rows * sizeof(CookedMapCell) >
+        left) {
+      return false;
+    }
+    layer.tileWidth = gsl::narrow_cast<int>(cooked.tileWidth);
+    layer.tileHeight = gsl::narrow_cast<int>(cooked.tileHeight);
+    layer.columns = gsl::narrow_cast<int>(cooked.columns);
+    layer.rows = gsl::narrow_cast<int>(cooked.rows);
+    layer.cells.resize(std::size_t{cooked.columns} * cooked.rows);
+    for (sf::Vector2i& cell : layer.cells) {
+      CookedMapCell stored{};
+      take(&stored, sizeof(stored));
+      cell = sf::Vector2i(stored.column, stored.row);
+    }
+  }
+  return !map.layers.empty();
+}
+
+bool IsEmptyCell(sf::Vector2i cell) { return cell.x == 0 && cell.y == 0; }
+
+std::unique_ptr<Tile> MakeTile(
+    const MapLayerData& layer,
+    const std::shared_ptr<const sf::Texture>& tileset, float scale,
+    std::size_t index) {
+  const sf::Vector2i cell{layer.cells[index]};
+  if (IsEmptyCell(cell)) return nullptr;
+  const int x{gsl::narrow_cast<int>(index % layer.columns)};
+  const int y{gsl::narrow_cast<int>(index / layer.columns)};
+  return std::make_unique<Tile>(
+      tileset, scale, layer.tileWidth, layer.tileHeight, cell.x, cell.y,
+      scale * static_cast<float>(layer.tileWidth * x),
+      scale * static_cast<float>(layer.tileHeight * y));
+}
+
+}  // namespace
+
+TileGroup::TileGroup(int COLS, int ROWS, const char* filePath, float scale,
+                     float tileWidth, float tileHeight,
+                     const char* textureUrl) {
   Expects(scale >= 0.0f);
   Expects(tileWidth >= 0.0f && tileHeight >= 0.0f);
   this->textureUrlStr = textureUrl ? std::string(textureUrl) : std::string{};
@@ -26,9 +129,6 @@ TileGroup::TileGroup(sf::RenderWindow* window, int COLS, int ROWS,
   this->COLS = COLS;
   this->ROWS = ROWS;
   this->filePathStr = filePath ? std::string(filePath) : std::string{};
-  this->window = window;
-  layerTiles =
-      std::make_unique<std::vector<std::vector<std::unique_ptr<Tile>>>>();
 
   GenerateMap();
 }
@@ -36,150 +136,151 @@ TileGroup::TileGroup(sf::RenderWindow* window, int COLS, int ROWS,
 TileGroup::~TileGroup() {
   // Smart pointers automatically clean up
 }
-void TileGroup::GenerateMap() {
-  // JSON-only map loading (supports single-layer and layered variants)
+bool TileGroup::ReadMap(const std::string& path, MapData& map) {
+  // JSON map loading (supports single-layer and layered variants), unless
+  // the cooker left a flat grid
   try {
-    if (filePathStr.empty()) {
-      std::cerr << "TileGroup: empty map path" << std::endl;
-      return;
+    if (path.empty()) {
+      BEP_LOG_ERROR(LogCategory::Assets, "TileGroup: empty map path");
+      return false;
+    }
+
+    if (const std::string* cooked{
+            CookedAssets::Find(path, CookedKind::Map)}) {
+      if (ReadCookedMap(AssetFiles::Read(*cooked), map)) return true;
+      BEP_LOG_WARNING(LogCategory::Assets,
+                      "Ignoring invalid cooked map {} for {}", *cooked, path);
     }
 
-    std::cout << "TileGroup: loading JSON map -> " << filePathStr << std::endl;
     // Parse with jsoncpp for robustness
-    std::ifstream in(filePathStr, std::ios::in | std::ios::binary);
-    if (!in.is_open()) {
-      std::cerr << "Failed to open JSON map file: " << filePathStr << std::endl;
-      return;
+    const AssetData data{AssetFiles::Read(path)};
+    if (!data) {
+      BEP_LOG_ERROR(LogCategory::Assets, "Failed to open JSON map file: {}",
+                    path);
+      return false;
     }
-    Json::CharReaderBuilder rbuilder;
-    rbuilder["collectComments"] = false;
     Json::Value root;
     std::string errs;
-    if (!Json::parseFromStream(rbuilder, in, &root, &errs)) {
-      std::cerr << "JSON parse error: " << errs << std::endl;
-      return;
+    if (!AssetFiles::ParseJson(data, root, errs)) {
+      BEP_LOG_ERROR(LogCategory::Assets, "JSON parse error: {}", errs);
+      return false;
     }
-    in.close();
-
-    int totalPlaced = 0;
-    layerTiles->clear();
-
-    auto readGrid = [&](const Json::Value& gridVal)
-        -> std::vector<std::vector<std::pair<int, int>>> {
-      std::vector<std::vector<std::pair<int, int>>> grid;
-      if (!gridVal.isArray()) return grid;
-      grid.reserve(gridVal.size());
-      for (const auto& rowVal : gridVal) {
-        std::vector<std::pair<int, int>> row;
-        if (!rowVal.isArray()) continue;
-        row.reserve(rowVal.size());
-        for (const auto& cell : rowVal) {
-          if (cell.isArray() && cell.size() == 2) {
-            int c = cell[0].asInt();
-            int r = cell[1].asInt();
-            row.emplace_back(c, r);
-          } else {
-            row.emplace_back(0, 0);
-          }
-        }
-        grid.push_back(std::move(row));
-      }
-      return grid;
-    };
 
+    map.layers.clear();
     if (root.isMember("layers") && root["layers"].isArray()) {
-      const auto& arr = root["layers"];
-      int layerIndex = 0;
-      for (const auto& L : arr) {
-        std::string tilesetPath = L.isMember("tileset")
-                                      ? L["tileset"].asString()
-                                      : this->textureUrlStr;
-        int lTileW = L.isMember("tileW")
-                         ? L["tileW"].asInt()
-                         : gsl::narrow_cast<int>(this->tileWidth);
-        int lTileH = L.isMember("tileH")
-                         ? L["tileH"].asInt()
-                         : gsl::narrow_cast<int>(this->tileHeight);
-        auto grid = readGrid(L["grid"]);
-        if (grid.empty() || grid[0].empty()) {
-          ++layerIndex;
-          continue;
-        }
-        if (layerIndex == 0) {
-          ROWS = gsl::narrow_cast<int>(grid.size());
-          COLS = gsl::narrow_cast<int>(grid[0].size());
-        }
-        float tw = static_cast<float>(lTileW);
-        float th = static_cast<float>(lTileH);
-        std::vector<std::unique_ptr<Tile>> layerVec;
-        layerVec.reserve(static_cast<size_t>(ROWS * COLS));
-        for (int y = 0; y < gsl::narrow_cast<int>(grid.size()); ++y) {
-          for (int x = 0; x < gsl::narrow_cast<int>(grid[y].size()); ++x) {
-            auto [col, row] = grid[y][x];
-            if (col == 0 && row == 0) continue;
-            float posX{scale * tw * x};
-            float posY{scale * th * y};
-            layerVec.push_back(std::make_unique<Tile>(
-                tilesetPath, scale, gsl::narrow_cast<int>(tw),
-                gsl::narrow_cast<int>(th), col, row, posX, posY, window));
-            ++totalPlaced;
-          }
-        }
-        layerTiles->push_back(std::move(layerVec));
-        ++layerIndex;
+      for (const auto& L : root["layers"]) {
+        MapLayerData layer;
+        ReadJsonLayer(L, layer);
+        if (layer.cells.empty()) continue;
+        map.layers.push_back(std::move(layer));
       }
-      if (layerTiles->empty()) {
-        std::cerr << "No valid layers parsed; aborting" << std::endl;
-        return;
+      if (map.layers.empty()) {
+        BEP_LOG_ERROR(LogCategory::Assets, "No valid layers parsed; aborting");
+        return false;
       }
-      std::cout << "TileGroup: JSON layered loaded. Layers="
-                << layerTiles->size() << ", Size=" << COLS << "x" << ROWS
-                << ", tiles=" << totalPlaced << std::endl;
     } else {
       // Single-layer JSON
-      if (root.isMember("tileset"))
-        this->textureUrlStr = root["tileset"].asString();
-      if (root.isMember("tileW"))
-        this->tileWidth = static_cast<float>(root["tileW"].asInt());
-      if (root.isMember("tileH"))
-        this->tileHeight = static_cast<float>(root["tileH"].asInt());
-      auto grid = readGrid(root["grid"]);
-      if (grid.empty() || grid[0].empty()) {
-        std::cerr << "JSON map 'grid' is empty or malformed: " << filePathStr
-                  << std::endl;
-        return;
-      }
-      ROWS = gsl::narrow_cast<int>(grid.size());
-      COLS = gsl::narrow_cast<int>(grid[0].size());
-      std::vector<std::unique_ptr<Tile>> singleLayer;
-      singleLayer.reserve(static_cast<size_t>(ROWS * COLS));
-      for (int y = 0; y < ROWS; ++y) {
-        for (int x = 0; x < gsl::narrow_cast<int>(grid[y].size()); ++x) {
-          auto [col, row] = grid[y][x];
-          if (col == 0 && row == 0) continue;
-          float posX{scale * tileWidth * x};
-          float posY{scale * tileHeight * y};
-          singleLayer.push_back(std::make_unique<Tile>(
-              this->textureUrlStr, scale, gsl::narrow_cast<int>(tileWidth),
-              gsl::narrow_cast<int>(tileHeight), col, row, posX, posY, window));
-          ++totalPlaced;
-        }
+      MapLayerData layer;
+      ReadJsonLayer(root, layer);
+      if (layer.cells.empty()) {
+        BEP_LOG_ERROR(LogCategory::Assets,
+                      "JSON map 'grid' is empty or malformed: {}", path);
+        return false;
       }
-      layerTiles->push_back(std::move(singleLayer));
-      std::cout << "TileGroup: JSON loaded. Size=" << COLS << "x" << ROWS
-                << ", tiles=" << totalPlaced << std::endl;
+      map.layers.push_back(std::move(layer));
     }
+    return true;
   } catch (const std::exception& ex) {
-    std::cerr << "Exception while generating map: " << ex.what() << std::endl;
+    BEP_LOG_ERROR(LogCategory::Assets, "Exception while reading map {}: {}",
+                  path, ex.what());
+    return false;
+  }
+}
+
+void TileGroup::GenerateMap() {
+  MapData map;
+  if (!ReadMap(filePathStr, map)) return;
+  layers.clear();
+  Reload(map);
+  BEP_LOG_INFO(LogCategory::Assets,
+               "TileGroup: loaded {}. Layers={}, Size={}x{}, tiles={}",
+               filePathStr, layers.size(), COLS, ROWS, tileCount);
+}
+
+void TileGroup::ResolveLayer(MapLayerData& layer) const {
+  if (layer.tileset.empty()) layer.tileset = textureUrlStr;
+  if (layer.tileWidth <= 0) layer.tileWidth = gsl::narrow_cast<int>(tileWidth);
+  if (layer.tileHeight <= 0) {
+    layer.tileHeight = gsl::narrow_cast<int>(tileHeight);
+  }
+}
+
+std::size_t TileGroup::BuildLayer(Layer& layer) {
+  const auto tileset{TextureCache::Acquire(layer.data.tileset)};
+  std::size_t created{};
+  layer.tiles.clear();
+  layer.tiles.reserve(layer.data.cells.size());
+  for (std::size_t i{}; i < layer.data.cells.size(); ++i) {
+    layer.tiles.push_back(MakeTile(layer.data, tileset, scale, i));
+    if (layer.tiles.back()) ++created;
   }
+  return created;
 }
 
-void TileGroup::Draw() {
+std::size_t TileGroup::Reload(const MapData& map) {
+  std::size_t created{};
+  std::vector<Layer> next(map.layers.size());
+  for (std::size_t i{}; i < next.size(); ++i) {
+    Layer& layer{next[i]};
+    layer.data = map.layers[i];
+    ResolveLayer(layer.data);
+    const MapLayerData* previous{i < layers.size() ? &layers[i].data
+                                                   : nullptr};
+    const bool sameShape{
+        previous && previous->tileset == layer.data.tileset &&
+        previous->tileWidth == layer.data.tileWidth &&
+        previous->tileHeight == layer.data.tileHeight &&
+        previous->columns == layer.data.columns &&
+        previous->rows == layer.data.rows};
+    if (!sameShape) {
+      created += BuildLayer(layer);
+      continue;
+    }
+
+    // Same grid: keep every tile whose cell didn't change
+    layer.tiles = std::move(layers[i].tiles);
+    std::shared_ptr<const sf::Texture> tileset;
+    for (std::size_t cell{}; cell < layer.data.cells.size(); ++cell) {
+      if (layer.data.cells[cell] == previous->cells[cell]) continue;
+      if (!tileset) tileset = TextureCache::Acquire(layer.data.tileset);
+      layer.tiles[cell] = MakeTile(layer.data, tileset, scale, cell);
+      if (layer.tiles[cell]) ++created;
+    }
+  }
+  layers = std::move(next);
+
+  tileCount = 0;
+  for (const Layer& layer : layers) {
+    tileCount += static_cast<std::size_t>(
+        std::count_if(layer.tiles.begin(), layer.tiles.end(),
+                      [](const auto& tile) { return tile != nullptr; }));
+  }
+  if (!layers.empty()) {
+    COLS = layers.front().data.columns;
+    ROWS = layers.front().data.rows;
+  }
+  return created;
+}
+
+void TileGroup::Draw(sf::RenderTarget& target) const {
   // Draw layers in order; per-layer tiles are already positioned
-  if (!layerTiles) return;
-  for (auto& layer : *layerTiles) {
-    for (auto& tile : layer) {
-      tile->Draw();
+  for (const Layer& layer : layers) {
+    for (const auto& tile : layer.tiles) {
+      if (tile) tile->Draw(target);
     }
   }
-}
\ No newline at end of file
+}
+
+std::size_t TileGroup::GetTileCount() const { return tileCount; }
+
+const std::string& TileGroup::GetPath() const { return filePathStr; }
@@ -1,10 +1,150 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
 
+#include "Constants.hh"
 #include "Game.hh"
+#include "Log.hh"
+#include "SimulationBatch.hh"
 
-int main() {
-  Game game;
-  game.Initialize();
+namespace {
+
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--record <file> | --replay <file>] [--headless]"
+               " [--ticks <count>] [--fps <rate> | --vsync]"
+               " [--metrics <file>] [--telemetry] [--alloc-budget]\n"
+               "       [--log <file>] [--log-level <trace|debug|info|warning|"
+               "error|off>] [--hot-reload]\n"
+            << "       " << program
+            << " --batch <instances> [--ticks <count>] [--workers <count>]"
+               " [--log <file>]\n"
+               "       [--log-level <level>]"
+            << std::endl;
+}
+
+// LogLevel by name (see Log::GetLevelName); false if there is none
+bool ParseLogLevel(const char* arg, LogLevel& level) {
+  for (int i{}; i <= static_cast<int>(LogLevel::Off); ++i) {
+    if (std::strcmp(arg, Log::GetLevelName(static_cast<LogLevel>(i))) == 0) {
+      level = static_cast<LogLevel>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Positive integer up to max; false if arg isn't one
+bool ParseCount(const char* arg, unsigned long max, unsigned long& value) {
+  char* end{};
+  value = std::strtoul(arg, &end, 10);
+  return *end == '\0' && value > 0 && value <= max;
+}
 
+int RunBatch(std::size_t instanceCount, std::uint32_t ticks,
+             unsigned workerCount) {
+  SimulationBatch batch(instanceCount, workerCount);
+  if (!batch.IsSceneComplete()) {
+    std::cerr << "Batch aborted: the scene's prefabs did not load"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const SimulationBatchStats stats{batch.Run(ticks)};
+  const double simulatedSeconds{static_cast<double>(stats.ticks) *
+                                GameConstants::FIXED_TIME_STEP};
+  std::cout << "Batch: " << stats.instances << " instances x " << ticks
+            << " ticks on " << workerCount + 1 << " threads in " << std::fixed
+            << std::setprecision(1) << stats.wallMs << " ms\n"
+            << "  " << stats.ticksPerSecond << " ticks/s, "
+            << simulatedSeconds * 1000.0 / stats.wallMs << "x realtime\n"
+            << "  checksum " << std::hex << stats.checksum << std::dec
+            << std::endl;
   return EXIT_SUCCESS;
 }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  GameOptions options;
+  unsigned long batchInstances{};
+  unsigned workerCount{JobSystem::DefaultWorkerCount()};
+  for (int i{1}; i < argc; ++i) {
+    const bool hasValue{i + 1 < argc};
+    unsigned long value{};
+    LogLevel logLevel{};
+    if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+      options.recordPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+      options.replayPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--metrics") == 0 && hasValue) {
+      options.metricsPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--telemetry") == 0) {
+      options.telemetry = true;
+    } else if (std::strcmp(argv[i], "--alloc-budget") == 0) {
+      options.allocBudget = true;
+    } else if (std::strcmp(argv[i], "--log") == 0 && hasValue) {
+      options.logPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--log-level") == 0 && hasValue &&
+               ParseLogLevel(argv[++i], logLevel)) {
+      options.logLevel = logLevel;
+    } else if (std::strcmp(argv[i], "--hot-reload") == 0) {
+      options.hotReload = true;
+    } else if (std::strcmp(argv[i], "--headless") == 0) {
+      options.headless = true;
+    } else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue &&
+               ParseCount(argv[++i], UINT32_MAX, value)) {
+      options.ticks = static_cast<std::uint32_t>(value);
+    } else if (std::strcmp(argv[i], "--fps") == 0 && hasValue &&
+               ParseCount(argv[++i], 1000, value)) {
+      options.frameRate = static_cast<float>(value);
+    } else if (std::strcmp(argv[i], "--vsync") == 0) {
+      options.vsync = true;
+    } else if (std::strcmp(argv[i], "--batch") == 0 && hasValue &&
+               ParseCount(argv[++i], 1u << 16, value)) {
+      batchInstances = value;
+    } else if (std::strcmp(argv[i], "--workers") == 0 && hasValue) {
+      char* end{};
+      workerCount = static_cast<unsigned>(std::strtoul(argv[++i], &end, 10));
+      if (*end != '\0') {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    } else {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (!options.recordPath.empty() && !options.replayPath.empty()) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (batchInstances > 0) {
+    // A batch has no main loop, window or frame pacing: only --ticks,
+    // --workers and the logging options apply
+    if (!options.recordPath.empty() || !options.replayPath.empty() ||
+        !options.metricsPath.empty() || options.telemetry ||
+        options.allocBudget || options.hotReload || options.frameRate > 0.f ||
+        options.vsync) {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    LogSettings logSettings;
+    logSettings.path = options.logPath;
+    logSettings.level = options.logLevel;
+    Log::Start(logSettings);
+    const int exitCode{RunBatch(batchInstances,
+                                options.ticks ? options.ticks
+                                              : GameConstants::HEADLESS_TICKS,
+                                workerCount)};
+    Log::Stop();
+    return exitCode;
+  }
+
+  Game game(options);
+  game.Initialize();
+
+  return game.GetExitCode();
+}